@@ -0,0 +1,102 @@
+#ifndef UTCOUPE_ASSERV_BENCH_BENCH_HPP
+#define UTCOUPE_ASSERV_BENCH_BENCH_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace utcoupe::asserv::bench {
+    /** Number of times each measure is repeated, only the fastest one is kept to filter out the noise. */
+    inline constexpr int REPETITIONS = 5;
+    
+    /**
+     * Prevents the compiler from optimizing away the computation of a value.
+     */
+    template<class T>
+    inline void doNotOptimize(T& value) noexcept {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+    
+    /**
+     * Makes the compiler forget what it knows about a value, e.g. to keep a literal input from being parsed at compile time.
+     */
+    template<class T>
+    inline void makeOpaque(T& value) noexcept {
+        asm volatile("" : "+r,m"(value) : : "memory");
+    }
+    
+    /** The result of a benchmark. */
+    struct Measure {
+        std::string name;
+        
+        /** Mean duration of an operation, in nanoseconds. */
+        double nsPerOp;
+        
+        /** Number of operations run for each repetition. */
+        std::size_t iterations;
+    };
+    
+    /** All the measures taken since the start of the program. */
+    inline std::vector<Measure>& measures() {
+        static std::vector<Measure> allMeasures;
+        return allMeasures;
+    }
+    
+    /** Only the benchmarks whose name contains this string are run, all of them if it is empty. */
+    inline std::string& filter() {
+        static std::string nameFilter;
+        return nameFilter;
+    }
+    
+    /**
+     * Measures the mean duration of an operation.
+     * 
+     * @param name The name of the benchmark, conventionally "group/case".
+     * @param iterations The number of times the operation is run for each repetition.
+     * @param operation The operation to measure, called with the iteration index.
+     */
+    template<class OperationT>
+    void measure(std::string name, std::size_t iterations, OperationT&& operation) {
+        using Clock = std::chrono::steady_clock;
+        
+        if (name.find(filter()) == std::string::npos) {
+            return;
+        }
+        
+        double bestNsPerOp = 0.;
+        for (int repetition = 0; repetition <= REPETITIONS; ++repetition) {
+            const auto start = Clock::now();
+            for (std::size_t i = 0; i < iterations; ++i) {
+                operation(i);
+            }
+            const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+            
+            // The first repetition only warms up caches and branch predictors
+            const double nsPerOp = elapsed.count() / static_cast<double>(iterations);
+            if (repetition == 1 || (repetition > 1 && nsPerOp < bestNsPerOp)) {
+                bestNsPerOp = nsPerOp;
+            }
+        }
+        
+        measures().push_back(Measure{ std::move(name), bestNsPerOp, iterations });
+    }
+    
+    /**
+     * A group of benchmarks, registered at static initialization like boost::ut suites.
+     */
+    struct Suite {
+        explicit Suite(std::function<void()> body) {
+            suites().push_back(std::move(body));
+        }
+        
+        static std::vector<std::function<void()>>& suites() {
+            static std::vector<std::function<void()>> allSuites;
+            return allSuites;
+        }
+    };
+} // namespace utcoupe::asserv::bench
+
+#endif // UTCOUPE_ASSERV_BENCH_BENCH_HPP
@@ -0,0 +1,75 @@
+#include "bench.hpp"
+
+#include <cstdio>
+#include <string_view>
+
+namespace {
+    using namespace utcoupe::asserv;
+    
+    enum class OutputFormat {
+        TABLE,
+        CSV,
+        JSON
+    };
+    
+    void printUsage(const char* program) {
+        std::fprintf(stderr, "usage: %s [--format=table|csv|json] [--filter=<name part>]\n", program);
+    }
+    
+    void printMeasures(OutputFormat format) {
+        const auto& allMeasures = bench::measures();
+        switch (format) {
+            case OutputFormat::TABLE:
+                std::printf("%-48s %12s %12s\n", "benchmark", "ns/op", "iterations");
+                for (const auto& measure : allMeasures) {
+                    std::printf("%-48s %12.2f %12zu\n", measure.name.c_str(), measure.nsPerOp, measure.iterations);
+                }
+                break;
+            case OutputFormat::CSV:
+                std::printf("benchmark,ns_per_op,iterations\n");
+                for (const auto& measure : allMeasures) {
+                    std::printf("%s,%.3f,%zu\n", measure.name.c_str(), measure.nsPerOp, measure.iterations);
+                }
+                break;
+            case OutputFormat::JSON:
+                // Names are made of plain ASCII characters without quotes nor backslashes, no escaping needed
+                std::printf("{\n    \"benchmarks\": [\n");
+                for (std::size_t i = 0; i < allMeasures.size(); ++i) {
+                    const auto& measure = allMeasures[i];
+                    std::printf(
+                        "        { \"name\": \"%s\", \"ns_per_op\": %.3f, \"iterations\": %zu }%s\n",
+                        measure.name.c_str(), measure.nsPerOp, measure.iterations, i + 1 < allMeasures.size() ? "," : ""
+                    );
+                }
+                std::printf("    ]\n}\n");
+                break;
+        }
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    OutputFormat format = OutputFormat::TABLE;
+    
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--format=table") {
+            format = OutputFormat::TABLE;
+        } else if (arg == "--format=csv") {
+            format = OutputFormat::CSV;
+        } else if (arg == "--format=json") {
+            format = OutputFormat::JSON;
+        } else if (arg.starts_with("--filter=")) {
+            bench::filter() = arg.substr(std::string_view{ "--filter=" }.size());
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    
+    for (auto& suite : bench::Suite::suites()) {
+        suite();
+    }
+    
+    printMeasures(format);
+    return 0;
+}
@@ -0,0 +1,30 @@
+#include "bench.hpp"
+
+#include "utcoupe/asserv/control/odometry.hpp"
+#include "utcoupe/asserv/fixed_point.hpp"
+
+#include <array>
+#include <cstddef>
+
+using namespace utcoupe::asserv;
+
+namespace {
+    constexpr std::size_t ITERATIONS = 1'000'000;
+    
+    template<class NumberT>
+    void benchUpdate(const char* name) {
+        control::Odometry<NumberT> odo{ {} };
+        // Slightly different wheel speeds, so that the robot turns
+        constexpr std::array<control::EncoderSample, 4> samples{ { { 10, 12 }, { 11, 12 }, { 12, 11 }, { 12, 10 } } };
+        bench::measure(name, ITERATIONS, [&odo, &samples](std::size_t i) {
+            odo.update(samples[i % samples.size()]);
+            auto pose = odo.pose();
+            bench::doNotOptimize(pose);
+        });
+    }
+}
+
+bench::Suite odometryBench{ [] {
+    benchUpdate<float>("odometry/update-float");
+    benchUpdate<Q16_16>("odometry/update-q16.16");
+} };
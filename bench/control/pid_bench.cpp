@@ -0,0 +1,29 @@
+#include "bench.hpp"
+
+#include "utcoupe/asserv/control/pid.hpp"
+#include "utcoupe/asserv/fixed_point.hpp"
+
+#include <cstddef>
+
+using namespace utcoupe::asserv;
+
+namespace {
+    constexpr std::size_t ITERATIONS = 1'000'000;
+    
+    template<class NumberT>
+    void benchTick(const char* name) {
+        control::DualPid<NumberT> pid{ {} };
+        pid.setGains(control::PidTarget::BOTH, { NumberT{ 2 }, NumberT{ 0.5f }, NumberT{ 0.01f } });
+        bench::measure(name, ITERATIONS, [&pid](std::size_t i) {
+            // Varying measures, so that every term of the controller is computed
+            const auto measure = static_cast<NumberT>(static_cast<int>(i & 63));
+            auto outputs = pid.tick({ NumberT{ 32 }, NumberT{ -32 } }, { measure, -measure });
+            bench::doNotOptimize(outputs);
+        });
+    }
+}
+
+bench::Suite pidBench{ [] {
+    benchTick<float>("pid/tick-float");
+    benchTick<Q16_16>("pid/tick-q16.16");
+} };
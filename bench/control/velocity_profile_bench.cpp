@@ -0,0 +1,40 @@
+#include "bench.hpp"
+
+#include "utcoupe/asserv/control/velocity_profile.hpp"
+
+#include <cstddef>
+
+using namespace utcoupe::asserv;
+
+namespace {
+    constexpr control::MotionLimits limits{ .maxSpeed = 500.f, .maxAcc = 1000.f, .maxJerk = 10000.f };
+    
+    /** Period of the control loop, in seconds. */
+    constexpr float TICK_PERIOD = 0.001f;
+    
+    constexpr std::size_t ITERATIONS = 1'000'000;
+    
+    /** Evaluates the profile on every tick of its duration, so that every phase gets sampled. */
+    void benchTicks(const char* name, const control::VelocityProfile& profile) {
+        const auto ticks = static_cast<std::size_t>(profile.duration() / TICK_PERIOD) + 1;
+        bench::measure(name, ITERATIONS, [&profile, ticks](std::size_t i) {
+            control::ProfileState state = profile.at(static_cast<float>(i % ticks) * TICK_PERIOD);
+            bench::doNotOptimize(state);
+        });
+    }
+}
+
+bench::Suite velocityProfileBench{ [] {
+    benchTicks("velocity-profile/tick-trapezoidal", control::VelocityProfile::plan(1000.f, 0.f, 0.f, limits));
+    benchTicks("velocity-profile/tick-s-curve", control::VelocityProfile::plan(1000.f, 0.f, 0.f, limits, control::ProfileShape::S_CURVE));
+    
+    bench::measure("velocity-profile/plan-trapezoidal", ITERATIONS / 10, [](std::size_t i) {
+        auto profile = control::VelocityProfile::plan(static_cast<float>(i % 1000), 0.f, 0.f, limits);
+        bench::doNotOptimize(profile);
+    });
+    
+    bench::measure("velocity-profile/plan-s-curve", ITERATIONS / 10, [](std::size_t i) {
+        auto profile = control::VelocityProfile::plan(static_cast<float>(i % 1000), 0.f, 0.f, limits, control::ProfileShape::S_CURVE);
+        bench::doNotOptimize(profile);
+    });
+} };
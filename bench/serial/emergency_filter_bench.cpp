@@ -0,0 +1,59 @@
+#include "bench.hpp"
+
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/emergency_filter.hpp"
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+using namespace std::string_view_literals;
+using namespace utcoupe::asserv;
+
+namespace {
+    constexpr std::size_t ITERATIONS = 200'000;
+    
+    /** A typical burst from the host: a path upload followed by queries, without any emergency order. */
+    constexpr std::string_view ASCII_STREAM = "g;\nd;100;200;1;\nd;300;200;1;\nc;500;400;1.5708;1;\nS;\nn;\ny;\nt;\n";
+    
+    std::string binaryStream() {
+        std::array<char, 32> buffer{};
+        std::string stream;
+        stream.append(buffer.data(), serial::encodeBinaryFrame(buffer, 'g'));
+        stream.append(buffer.data(), serial::encodeBinaryFrame(buffer, 'd', 100, 200, 1));
+        stream.append(buffer.data(), serial::encodeBinaryFrame(buffer, 'd', 300, 200, 1));
+        stream.append(buffer.data(), serial::encodeBinaryFrame(buffer, 'c', 500, 400, 1.5708f, 1));
+        stream.append(buffer.data(), serial::encodeBinaryFrame(buffer, 'S'));
+        stream.append(buffer.data(), serial::encodeBinaryFrame(buffer, 'n'));
+        return stream;
+    }
+}
+
+bench::Suite emergencyFilterBench{ [] {
+    serial::EmergencyFilter asciiFilter;
+    bench::measure("emergency-filter/ascii-burst-" + std::to_string(ASCII_STREAM.size()) + "-bytes", ITERATIONS, [&](std::size_t) {
+        auto detected = asciiFilter.feed(ASCII_STREAM);
+        bench::doNotOptimize(detected);
+    });
+    
+    const std::string binary = binaryStream();
+    serial::EmergencyFilter<serial::FrameFormat::BINARY> binaryFilter;
+    bench::measure("emergency-filter/binary-burst-" + std::to_string(binary.size()) + "-bytes", ITERATIONS, [&](std::size_t) {
+        auto detected = binaryFilter.feed(binary);
+        bench::doNotOptimize(detected);
+    });
+    
+    serial::EmergencyFilter haltFilter;
+    int stops = 0;
+    bench::measure("emergency-filter/halt-detect-and-apply", ITERATIONS, [&](std::size_t) {
+        haltFilter.feed("H;\n"sv);
+        struct {
+            int& stops;
+            void halt() { ++stops; }
+            void setEmergencyStop(int) { ++stops; }
+        } executor{ stops };
+        auto applied = haltFilter.apply(executor);
+        bench::doNotOptimize(applied);
+    });
+} };
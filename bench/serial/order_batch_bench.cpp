@@ -0,0 +1,51 @@
+#include "bench.hpp"
+#include "fake_dispatcher.hpp"
+
+#include "utcoupe/asserv/serial/order_batch.hpp"
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+using namespace std::string_view_literals;
+using namespace utcoupe::asserv;
+
+namespace {
+    constexpr auto orderTable = serial::makeOrderTable(serial::createAllOrders<test::FakeDispatcher>());
+    
+    constexpr std::size_t ITERATIONS = 200'000;
+    
+    /** A path of eight goals, as separate frames. */
+    constexpr std::array PATH_ORDERS{
+        "d;100;200;1;"sv, "d;300;200;1;"sv, "d;500;400;1;"sv, "d;700;400;1;"sv,
+        "d;900;600;1;"sv, "d;1100;600;1;"sv, "d;1300;800;1;"sv, "d;1500;800;1;"sv,
+    };
+    
+    /** The same path as a single batch frame. */
+    constexpr std::string_view PATH_BATCH =
+        "B;d;100;200;1;|d;300;200;1;|d;500;400;1;|d;700;400;1;|d;900;600;1;|d;1100;600;1;|d;1300;800;1;|d;1500;800;1;";
+}
+
+bench::Suite orderBatchBench{ [] {
+    test::FakeDispatcher dispatcher;
+    serial::OrderParser parser{dispatcher};
+    
+    bench::measure("batch/8-goto-separate-frames", ITERATIONS, [&](std::size_t) {
+        int sum = 0;
+        for (const auto order : PATH_ORDERS) {
+            sum += *parser.parseAndRunOrder(orderTable, order);
+        }
+        bench::doNotOptimize(sum);
+    });
+    
+    serial::OrderBatch batch{orderTable};
+    bench::measure("batch/8-goto-one-frame", ITERATIONS, [&](std::size_t) {
+        bool decoded = batch.decode(PATH_BATCH);
+        bench::doNotOptimize(decoded);
+        auto runOrders = batch.run(parser);
+        bench::doNotOptimize(runOrders);
+    });
+} };
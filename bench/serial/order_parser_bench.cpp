@@ -0,0 +1,138 @@
+#include "bench.hpp"
+#include "fake_dispatcher.hpp"
+#include "line_noise.hpp"
+
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/serial/stream_decoder.hpp"
+
+#include <concepts>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+using namespace utcoupe::asserv;
+
+namespace {
+    using Dispatcher = test::FakeDispatcher;
+    
+    constexpr auto allOrders = serial::createAllOrders<Dispatcher>();
+    constexpr auto orderTable = serial::makeOrderTable(allOrders);
+    
+    constexpr std::size_t ITERATIONS = 1'000'000;
+    
+    /** Builds a correctly formed message for an order, with a typical value for each of its parameters. */
+    template<class OrderT>
+    std::string validMessage(const OrderT& order) {
+        std::string message{ order.ch_order, ';' };
+        std::apply(
+            [&message]<class... ArgsT>(ArgsT...) {
+                ((message += std::floating_point<ArgsT> ? "1.5;" : "12;"), ...);
+            },
+            typename OrderT::CallbackArgs{}
+        );
+        return message;
+    }
+    
+    /** Builds a message of an order whose first parameter isn't a number, or nothing if it doesn't take any. */
+    template<class OrderT>
+    std::string malformedMessage(const OrderT& order) {
+        if constexpr (std::tuple_size_v<typename OrderT::CallbackArgs> == 0) {
+            return {};
+        } else {
+            return std::string{ order.ch_order, ';' } + "abc;";
+        }
+    }
+    
+    /** Builds a message of an order missing its last parameter, or nothing if it doesn't take any. */
+    template<class OrderT>
+    std::string truncatedMessage(const OrderT& order) {
+        std::string message = validMessage(order);
+        if (message.size() <= 2) {
+            return {};
+        }
+        message.pop_back();
+        message.erase(message.rfind(';') + 1);
+        return message;
+    }
+    
+    /** Applies a message builder to every order of the protocol, skipping the empty messages. */
+    template<class BuilderT>
+    std::vector<std::string> messagesOfAllOrders(BuilderT&& builder) {
+        std::vector<std::string> messages;
+        std::apply(
+            [&messages, &builder](const auto&... order) {
+                (messages.push_back(builder(order)), ...);
+            },
+            allOrders
+        );
+        std::erase_if(messages, [](const std::string& message) { return message.empty(); });
+        return messages;
+    }
+    
+    void benchMessages(std::string name, const std::vector<std::string>& messages) {
+        Dispatcher dispatcher;
+        serial::OrderParser parser{ dispatcher };
+        bench::measure(std::move(name), ITERATIONS, [&parser, &messages](std::size_t i) {
+            auto result = parser.parseAndRunOrder(orderTable, messages[i % messages.size()]);
+            bench::doNotOptimize(result);
+        });
+    }
+}
+
+bench::Suite orderParserBench{ [] {
+    const std::vector<std::string> validMessages = messagesOfAllOrders([](const auto& order) { return validMessage(order); });
+    
+    // One measure per order, to spot the orders whose parameters are the most expensive to parse
+    for (const std::string& message : validMessages) {
+        benchMessages("parse-and-run/valid/" + message.substr(0, 1), { message });
+    }
+    benchMessages("parse-and-run/valid/all", validMessages);
+    
+    benchMessages("parse-and-run/malformed/not-a-number", messagesOfAllOrders([](const auto& order) { return malformedMessage(order); }));
+    benchMessages("parse-and-run/malformed/missing-parameter", messagesOfAllOrders([](const auto& order) { return truncatedMessage(order); }));
+    benchMessages("parse-and-run/malformed/unknown-order", { "Z;1;2;", "\xff;", "#;" });
+    
+    // The last order of the tuple is the worst case of the linear search, but should cost the same as any other through the table
+    const std::string lastMessage = validMessage(std::get<std::tuple_size_v<decltype(allOrders)> - 1>(allOrders));
+    Dispatcher dispatcher;
+    serial::OrderParser parser{ dispatcher };
+    bench::measure("parse-and-run/worst-position/table", ITERATIONS, [&parser, &lastMessage](std::size_t) {
+        auto result = parser.parseAndRunOrder(orderTable, lastMessage);
+        bench::doNotOptimize(result);
+    });
+    bench::measure("parse-and-run/worst-position/linear", ITERATIONS, [&parser, &lastMessage](std::size_t) {
+        auto result = parser.parseAndRunOrder(allOrders, lastMessage);
+        bench::doNotOptimize(result);
+    });
+    
+    // Garbage must be rejected at least as fast as valid orders are run, whatever a noisy link delivers
+    test::LineNoise noise{ 1 };
+    std::vector<std::string> randomFrames(256);
+    for (std::string& frame : randomFrames) {
+        frame = noise.randomBytes(1 + noise.below(32));
+    }
+    benchMessages("parse-and-run/line-noise/random-bytes", randomFrames);
+    std::vector<std::string> corruptedFrames;
+    for (const std::string& message : validMessages) {
+        corruptedFrames.push_back(noise.corrupt(message, 100));
+    }
+    benchMessages("parse-and-run/line-noise/corrupted", corruptedFrames);
+    
+    // The whole receive path, on 1 KiB chunks of a stream of orders with 5% of damaged bytes
+    std::string stream;
+    while (stream.size() < 64 * 1024) {
+        stream += validMessages[noise.below(validMessages.size())];
+        stream += serial::FRAME_TERMINATOR;
+    }
+    stream = noise.corrupt(stream, 50);
+    constexpr std::size_t CHUNK_SIZE = 1024;
+    serial::StreamDecoder decoder{ parser, orderTable };
+    bench::measure("stream-decoder/line-noise/1KiB-chunk", ITERATIONS / 100, [&decoder, &stream](std::size_t i) {
+        const std::size_t offset = i * CHUNK_SIZE % (stream.size() - CHUNK_SIZE);
+        auto frames = decoder.feed(std::string_view{ stream }.substr(offset, CHUNK_SIZE));
+        bench::doNotOptimize(frames);
+    });
+} };
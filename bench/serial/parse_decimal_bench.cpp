@@ -0,0 +1,41 @@
+#include "bench.hpp"
+
+#include "utcoupe/asserv/serial/parse_decimal.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstdlib>
+#include <string>
+
+using namespace utcoupe::asserv;
+
+namespace {
+    /** Typical values carried by the protocol: PID gains, angles, speeds. */
+    const std::array<std::string, 8> values{
+        "1.4", "0.8", "-0.035", "3.14159", "1200.5", "0.0001", "-1.5708", "250"
+    };
+    
+    constexpr std::size_t ITERATIONS = 1'000'000;
+}
+
+bench::Suite parseDecimalBench{ [] {
+    bench::measure("float-parsing/strtof", ITERATIONS, [](std::size_t i) {
+        const std::string& value = values[i % values.size()];
+        float result = std::strtof(value.c_str(), nullptr);
+        bench::doNotOptimize(result);
+    });
+    
+    bench::measure("float-parsing/from_chars", ITERATIONS, [](std::size_t i) {
+        const std::string& value = values[i % values.size()];
+        float result = 0.f;
+        std::from_chars(value.data(), value.data() + value.size(), result);
+        bench::doNotOptimize(result);
+    });
+    
+    bench::measure("float-parsing/from_chars_fp", ITERATIONS, [](std::size_t i) {
+        const std::string& value = values[i % values.size()];
+        float result = 0.f;
+        serial::impl::from_chars_fp(value.data(), value.data() + value.size(), result);
+        bench::doNotOptimize(result);
+    });
+} };
@@ -0,0 +1,37 @@
+#include "bench.hpp"
+
+#include "utcoupe/asserv/fixed_point.hpp"
+#include "utcoupe/asserv/serial/parse_parameters.hpp"
+
+#include <cstdint>
+#include <string_view>
+
+using namespace std::string_view_literals;
+using namespace utcoupe::asserv;
+
+namespace {
+    constexpr std::size_t ITERATIONS = 1'000'000;
+    
+    template<class... ArgsT>
+    void benchParameters(const char* name, std::string_view serialized) {
+        bench::measure(name, ITERATIONS, [serialized](std::size_t) {
+            std::string_view input = serialized;
+            bench::makeOpaque(input);
+            auto values = serial::parseParameters<ArgsT...>(input.data(), input.data() + input.size());
+            bench::doNotOptimize(values);
+        });
+    }
+}
+
+bench::Suite parseParametersBench{ [] {
+    benchParameters<int>("parse-parameters/int", "-1200;"sv);
+    benchParameters<unsigned>("parse-parameters/unsigned", "1200;"sv);
+    benchParameters<std::int64_t>("parse-parameters/int64", "-123456789012;"sv);
+    benchParameters<float>("parse-parameters/float", "-1.5708;"sv);
+    benchParameters<double>("parse-parameters/double", "3.14159265;"sv);
+    benchParameters<Q16_16>("parse-parameters/q16.16", "-1.5708;"sv);
+    
+    // The heaviest signature of the protocol, used by GOTO_WITH_ANGLE
+    benchParameters<int, int, float, int>("parse-parameters/int-int-float-int", "1200;-340;1.5708;1;"sv);
+    benchParameters<int, int, Q16_16, int>("parse-parameters/int-int-q16.16-int", "1200;-340;1.5708;1;"sv);
+} };
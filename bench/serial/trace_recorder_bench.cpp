@@ -0,0 +1,31 @@
+#include "bench.hpp"
+
+#include "utcoupe/asserv/serial/trace_recorder.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+using namespace std::string_view_literals;
+using namespace utcoupe::asserv;
+
+namespace {
+    constexpr std::size_t ITERATIONS = 1'000'000;
+}
+
+bench::Suite traceRecorderBench{ [] {
+    bench::measure("trace/record-state", ITERATIONS, [](std::size_t i) {
+        static serial::TraceRecorder<> recorder;
+        const auto tick = static_cast<std::int32_t>(i);
+        recorder.recordState({ tick * 10, 5000, -15708, tick * 10, tick * 11, 120, -118 });
+        auto ticks = recorder.tick();
+        bench::doNotOptimize(ticks);
+    });
+    
+    bench::measure("trace/record-frame", ITERATIONS, [](std::size_t) {
+        static serial::TraceRecorder<> recorder;
+        recorder.recordFrame("c;1200;300;1.5708;1;"sv);
+        auto dropped = recorder.droppedRecords();
+        bench::doNotOptimize(dropped);
+    });
+} };
@@ -0,0 +1,56 @@
+#include "bench.hpp"
+
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/simulation/simulated_robot.hpp"
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+using namespace std::string_view_literals;
+using namespace utcoupe::asserv;
+
+namespace {
+    constexpr std::size_t STEP_ITERATIONS = 1'000'000;
+    constexpr std::size_t MATCH_ITERATIONS = 5;
+    
+    constexpr auto allOrders = serial::makeOrderTable(serial::createAllOrders<simulation::SimulatedRobot>());
+    
+    constexpr std::array loopOrders{
+        "d;1200;300;1;"sv, "d;1200;1200;1;"sv, "c;300;1200;3.14159;1;"sv, "d;300;300;-1;"sv,
+    };
+}
+
+bench::Suite simulatedRobotBench{ [] {
+    bench::measure("simulation/step", STEP_ITERATIONS, [](std::size_t i) {
+        static simulation::SimulatedRobot robot;
+        static serial::OrderParser parser{robot};
+        if (i == 0) {
+            parser.parseAndRunOrder(allOrders, "m;300;300;0;"sv);
+        }
+        if (robot.isIdle()) {
+            for (auto order : loopOrders) {
+                parser.parseAndRunOrder(allOrders, order);
+            }
+        }
+        robot.step();
+        auto pose = robot.pose();
+        bench::doNotOptimize(pose);
+    });
+    
+    bench::measure("simulation/match-100s", MATCH_ITERATIONS, [](std::size_t) {
+        simulation::SimulatedRobot robot;
+        serial::OrderParser parser{robot};
+        parser.parseAndRunOrder(allOrders, "m;300;300;0;"sv);
+        while (robot.time() < 100.) {
+            for (auto order : loopOrders) {
+                parser.parseAndRunOrder(allOrders, order);
+            }
+            robot.runUntilIdle(static_cast<float>(100. - robot.time()));
+        }
+        auto pose = robot.pose();
+        bench::doNotOptimize(pose);
+    });
+} };
@@ -0,0 +1,93 @@
+#include "fake_dispatcher.hpp"
+
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/decoded_order.hpp"
+#include "utcoupe/asserv/serial/emergency_filter.hpp"
+#include "utcoupe/asserv/serial/order_batch.hpp"
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/parse_error.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/serial/stream_decoder.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+
+using namespace utcoupe::asserv;
+
+namespace {
+    constexpr auto allOrders = serial::createAllOrders<test::FakeDispatcher>();
+    constexpr auto orderTable = serial::makeOrderTable(allOrders);
+    
+    /** Stops the fuzzing on a broken invariant, the same way a sanitizer error does. */
+    void check(bool invariant) {
+        if (!invariant) {
+            std::abort();
+        }
+    }
+    
+    /**
+     * Feeds a stream in chunks whose sizes are taken from the stream itself, to cover every split position.
+     * 
+     * The first byte picks the first size, and the last one whether the sizes cycle from 1 to 16 bytes or double up to the whole stream, like the bursts of a DMA. Binary frames all start with the same byte, so it can't pick both.
+     */
+    template<class FeedT>
+    void feedInChunks(std::string_view input, FeedT&& feed) {
+        const bool growing = !input.empty() && (input.back() & 0x10) != 0;
+        std::size_t chunkSize = input.empty() ? 1 : std::size_t{ static_cast<unsigned char>(input.front()) } % 16 + 1;
+        while (!input.empty()) {
+            const std::size_t size = std::min(chunkSize, input.size());
+            feed(input.substr(0, size));
+            input.remove_prefix(size);
+            chunkSize = growing ? chunkSize * 2 : chunkSize % 16 + 1;
+        }
+    }
+} // namespace
+
+/**
+ * Runs any input through every entry point of the serial layer, with all the orders of the protocol.
+ * 
+ * Besides the sanitizers, the table and the linear dispatch must agree on every input, and so must the parser and decodeOrder on the reason of a rejection.
+ */
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+    const std::string_view input{ reinterpret_cast<const char*>(data), size };
+    test::FakeDispatcher dispatcher;
+    serial::OrderParser parser{dispatcher};
+    
+    // A whole frame, as given by the stream decoder
+    const auto tableResult = parser.parseAndRunOrder(orderTable, input);
+    const auto linearResult = parser.parseAndRunOrder(allOrders, input);
+    check(tableResult == linearResult);
+    check(!tableResult || *tableResult == input.front());
+    check(tableResult.has_value() == (parser.lastError() == serial::ParseError::NONE));
+    check(serial::decodeOrder(orderTable, input).error() == parser.lastError());
+    
+    const auto binaryResult = parser.parseAndRunBinaryOrder(orderTable, input);
+    check(!binaryResult || serial::checkBinaryFrame(input).has_value());
+    
+    // A raw stream, received in chunks
+    serial::StreamDecoder asciiDecoder{parser, orderTable};
+    feedInChunks(input, [&asciiDecoder](std::string_view chunk) { asciiDecoder.feed(chunk); });
+    serial::StreamDecoder<test::FakeDispatcher, decltype(orderTable), 64, serial::FrameFormat::BINARY> binaryDecoder{parser, orderTable};
+    feedInChunks(input, [&binaryDecoder](std::string_view chunk) { binaryDecoder.feed(chunk); });
+    
+    serial::EmergencyFilter asciiFilter;
+    serial::EmergencyFilter<serial::FrameFormat::BINARY> binaryFilter;
+    feedInChunks(input, [&](std::string_view chunk) {
+        asciiFilter.feed(chunk);
+        binaryFilter.feed(chunk);
+    });
+    
+    // A batch is all or nothing
+    serial::OrderBatch batch{orderTable};
+    const bool decoded = batch.decode(input);
+    check(decoded == (batch.size() > 0));
+    if (auto frame = serial::checkBinaryFrame(input)) {
+        check(batch.decode(*frame) == (batch.size() > 0));
+    }
+    batch.run(parser);
+    return 0;
+}
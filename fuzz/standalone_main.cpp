@@ -0,0 +1,156 @@
+#include "fake_dispatcher.hpp"
+#include "line_noise.hpp"
+
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/order_batch.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size);
+
+using namespace std::string_view_literals;
+using namespace utcoupe::asserv;
+
+namespace {
+    constexpr auto orderTable = serial::makeOrderTable(serial::createAllOrders<test::FakeDispatcher>());
+    
+    /** Valid ASCII frames the generated inputs are derived from, so that the fuzzing goes past the order selection. */
+    constexpr std::array ASCII_SEEDS{
+        "d;100;200;1;"sv, "c;300;400;1.5708;1;"sv, "u;1.5;0.01;0.2;"sv, "k;-255;255;"sv, "T;31;20;"sv,
+        "m;1e3;-2e2;-3.14;"sv, "H;"sv, "A;1;"sv, "B;g;|d;100;200;1;|S;"sv, "d;2147483648;1;1;\nl;1e40;\n"sv,
+    };
+    
+    /** A binary frame of an order of the protocol, whose values must have the types of its callback. */
+    template<serial::OrderTypes Type, class... ValuesT>
+    std::string binaryOrder(ValuesT... values) {
+        const auto& order = std::get<orderTable.indexOf(static_cast<char>(Type))>(orderTable.orders);
+        std::array<char, serial::binaryFrameSize(serial::BINARY_MAX_PAYLOAD_SIZE)> buffer{};
+        return std::string{ buffer.data(), serial::encodeBinaryOrder(buffer, order, std::tuple{ values... }) };
+    }
+    
+    std::string binaryBatch() {
+        std::array<char, serial::binaryFrameSize(serial::BINARY_MAX_PAYLOAD_SIZE)> buffer{};
+        serial::BatchWriter<serial::FrameFormat::BINARY> writer{buffer};
+        writer.append('g');
+        writer.append('d', 100, 200, 1);
+        writer.append('c', 300, 400, 1.5708f, 1);
+        writer.append('S');
+        return std::string{ writer.finish() };
+    }
+    
+    /**
+     * Corrupted binary frames announcing more bytes than they hold, followed by other frames: the decoder resynchronizes on the start bytes already in its buffer.
+     */
+    std::string resynchronizedFrames() {
+        std::string frames{ "\xA5x\x0A\xA5y\x00ppppppp\xCC\xCC"sv };
+        frames.append(200, 'z');
+        frames += "\xA5x\x05"sv;
+        frames += binaryOrder<serial::OrderTypes::HALT>();
+        frames += "zz"sv;
+        return frames;
+    }
+    
+    /**
+     * The ASCII seeds, then binary frames: without them, random bytes would almost never pass the CRC, and the binary decoding, batches and emergency frames would never be reached.
+     */
+    std::vector<std::string> makeSeeds() {
+        std::vector<std::string> seeds{ ASCII_SEEDS.begin(), ASCII_SEEDS.end() };
+        seeds.push_back(binaryOrder<serial::OrderTypes::GOTO>(100, 200, 1));
+        seeds.push_back(binaryOrder<serial::OrderTypes::GOTO_WITH_ANGLE>(300, 400, 1.5708f, 1));
+        seeds.push_back(binaryOrder<serial::OrderTypes::PID_ALL>(1.5f, 0.01f, 0.2f));
+        seeds.push_back(binaryOrder<serial::OrderTypes::HALT>());
+        seeds.push_back(binaryOrder<serial::OrderTypes::SET_EMERGENCY_STOP>(1));
+        seeds.push_back(binaryOrder<serial::OrderTypes::SET_EMERGENCY_STOP>(0) + binaryOrder<serial::OrderTypes::START>());
+        seeds.push_back(binaryBatch());
+        seeds.push_back(resynchronizedFrames());
+        return seeds;
+    }
+    
+    void printUsage(const char* program) {
+        std::fprintf(stderr, "usage: %s [-runs=<count>] [-seed=<seed>] [input files...]\n", program);
+    }
+    
+    /** @return False if the argument isn't the option, or if its value isn't a number. */
+    bool parseOption(std::string_view arg, std::string_view name, std::uint64_t& value) {
+        if (!arg.starts_with(name)) {
+            return false;
+        }
+        arg.remove_prefix(name.size());
+        const auto [end, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), value);
+        return ec == std::errc{} && end == arg.data() + arg.size();
+    }
+    
+    int runInput(std::string_view input) {
+        return LLVMFuzzerTestOneInput(reinterpret_cast<const std::uint8_t*>(input.data()), input.size());
+    }
+    
+    bool runFile(const char* path) {
+        std::FILE* file = std::fopen(path, "rb");
+        if (file == nullptr) {
+            std::fprintf(stderr, "cannot open %s\n", path);
+            return false;
+        }
+        std::string input;
+        std::array<char, 4096> chunk;
+        for (std::size_t size; (size = std::fread(chunk.data(), 1, chunk.size(), file)) > 0;) {
+            input.append(chunk.data(), size);
+        }
+        std::fclose(file);
+        runInput(input);
+        return true;
+    }
+} // namespace
+
+/**
+ * Drives the fuzz target without libFuzzer, e.g. with GCC: replays the given inputs, or generates line noise from a seed.
+ * 
+ * Accepts the same -runs and -seed options as libFuzzer, so that both builds are run the same way.
+ */
+int main(int argc, char** argv) {
+    std::uint64_t runs = 100'000;
+    std::uint64_t seed = 1;
+    bool replayed = false;
+    
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (parseOption(arg, "-runs=", runs) || parseOption(arg, "-seed=", seed)) {
+            continue;
+        }
+        if (arg.starts_with("-")) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (!runFile(argv[i])) {
+            return 1;
+        }
+        replayed = true;
+    }
+    if (replayed) {
+        return 0;
+    }
+    
+    const std::vector<std::string> seeds = makeSeeds();
+    test::LineNoise noise{ seed };
+    for (std::uint64_t run = 0; run < runs; ++run) {
+        // Half random bytes, half damaged valid frames
+        if (run % 2 == 0) {
+            runInput(noise.randomBytes(noise.below(48)));
+        } else {
+            // Lightly damaged frames too, so that binary ones still pass their CRC now and then
+            runInput(noise.corrupt(seeds[noise.below(seeds.size())], noise.below(250)));
+        }
+    }
+    std::printf("%llu inputs run from seed %llu\n", static_cast<unsigned long long>(runs), static_cast<unsigned long long>(seed));
+    return 0;
+}
@@ -0,0 +1,118 @@
+#ifndef UTCOUPE_ASSERV_CONTROL_CONTROL_LOOP_HPP
+#define UTCOUPE_ASSERV_CONTROL_CONTROL_LOOP_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+namespace utcoupe::asserv::control {
+    /** Timing statistics of a FixedRateLoop. */
+    struct LoopStats {
+        /** Number of ticks run. */
+        std::uint64_t ticks = 0;
+        
+        /** Number of ticks which ended after the deadline of the next one. */
+        std::uint64_t overruns = 0;
+        
+        /** Number of ticks skipped to get back on schedule after overruns. */
+        std::uint64_t missedTicks = 0;
+        
+        /** Delay between the deadline of a tick and its actual start. */
+        std::chrono::nanoseconds minJitter{ 0 };
+        std::chrono::nanoseconds maxJitter{ 0 };
+        std::chrono::nanoseconds totalJitter{ 0 };
+        
+        /** Longest time spent in a tick. */
+        std::chrono::nanoseconds maxDuration{ 0 };
+        
+        std::chrono::nanoseconds meanJitter() const noexcept {
+            return ticks == 0 ? std::chrono::nanoseconds{ 0 } : totalJitter / static_cast<std::int64_t>(ticks);
+        }
+    };
+    
+    /**
+     * Schedules the ticks of a control loop at a fixed rate, and measures how well the schedule is kept.
+     * 
+     * Deadlines are absolute: they are computed from the start of the loop and never from the time a tick actually ran, so the rate doesn't drift. A tick which overruns the next deadline doesn't make the loop run several ticks in a row to catch up: the missed ticks are skipped, and the loop resumes at the next deadline still in the future, with the same phase.
+     * The loop doesn't sleep by itself, so it can be driven by any clock: e.g. clock_nanosleep on Linux, or a timer interrupt on the robot.
+     * 
+     * @code
+     * control::FixedRateLoop loop{ 5ms, std::chrono::steady_clock::now() };
+     * while (running) {
+     *     std::this_thread::sleep_until(loop.deadline());
+     *     loop.beginTick(std::chrono::steady_clock::now());
+     *     robot.step();
+     *     loop.endTick(std::chrono::steady_clock::now());
+     * }
+     * @endcode
+     * 
+     * @tparam Clock A monotonic clock, e.g. std::chrono::steady_clock.
+     */
+    template<class Clock = std::chrono::steady_clock>
+    class FixedRateLoop {
+    public:
+        using Duration = typename Clock::duration;
+        using TimePoint = typename Clock::time_point;
+        
+        /**
+         * @param period The time between two ticks, which must be positive.
+         * @param start The time the loop starts at, the first tick being due one period later.
+         */
+        FixedRateLoop(Duration period, TimePoint start) noexcept: m_period(period), m_deadline(start + period), m_tickStart(start) {}
+        
+        /** The time the next tick is due. */
+        TimePoint deadline() const noexcept {
+            return m_deadline;
+        }
+        
+        Duration period() const noexcept {
+            return m_period;
+        }
+        
+        /**
+         * Starts a tick, once woken up for its deadline.
+         * 
+         * @param now The current time, which gives the jitter of the tick.
+         */
+        void beginTick(TimePoint now) noexcept {
+            const auto jitter = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_deadline);
+            m_stats.minJitter = m_stats.ticks == 0 ? jitter : std::min(m_stats.minJitter, jitter);
+            m_stats.maxJitter = m_stats.ticks == 0 ? jitter : std::max(m_stats.maxJitter, jitter);
+            m_stats.totalJitter += jitter;
+            ++m_stats.ticks;
+            m_tickStart = now;
+        }
+        
+        /**
+         * Ends the tick started by beginTick, and schedules the next one.
+         * 
+         * @param now The current time.
+         * @return False if the tick overran the next deadline, which has then been pushed back by the ticks missed.
+         */
+        bool endTick(TimePoint now) noexcept {
+            m_stats.maxDuration = std::max(m_stats.maxDuration, std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_tickStart));
+            
+            m_deadline += m_period;
+            if (now <= m_deadline) {
+                return true;
+            }
+            const auto missed = (now - m_deadline) / m_period + 1;
+            m_deadline += missed * m_period;
+            m_stats.missedTicks += static_cast<std::uint64_t>(missed);
+            ++m_stats.overruns;
+            return false;
+        }
+        
+        const LoopStats& stats() const noexcept {
+            return m_stats;
+        }
+        
+    private:
+        Duration m_period;
+        TimePoint m_deadline;
+        TimePoint m_tickStart;
+        LoopStats m_stats;
+    };
+} // namespace utcoupe::asserv::control
+
+#endif // UTCOUPE_ASSERV_CONTROL_CONTROL_LOOP_HPP
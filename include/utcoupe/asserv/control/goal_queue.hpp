@@ -0,0 +1,251 @@
+#ifndef UTCOUPE_ASSERV_CONTROL_GOAL_QUEUE_HPP
+#define UTCOUPE_ASSERV_CONTROL_GOAL_QUEUE_HPP
+
+#include "utcoupe/asserv/control/motion_limits.hpp"
+#include "utcoupe/asserv/control/pose.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace utcoupe::asserv::control {
+    /** The kinds of goals, matching the GOTO, GOTO_WITH_ANGLE, ROT and ROT_MODULO orders. */
+    enum class GoalType : std::uint8_t {
+        GOTO,
+        GOTO_WITH_ANGLE,
+        ROT,
+        ROT_MODULO
+    };
+    
+    /** A target given by the host. */
+    struct Goal {
+        GoalType type = GoalType::GOTO;
+        
+        /** Target abscissa for GOTO goals, in millimeters. */
+        float x = 0.f;
+        
+        /** Target ordinate for GOTO goals, in millimeters. */
+        float y = 0.f;
+        
+        /** Target orientation for GOTO_WITH_ANGLE and ROT goals, in radians. */
+        float angle = 0.f;
+        
+        /** 1 to move forward, -1 to move backward, 0 to let the asserv choose. */
+        int direction = 1;
+    };
+    
+    /** A queued goal, along with the speeds planned to go through it. */
+    struct PlannedGoal {
+        Goal goal;
+        
+        /** Identifier of the goal, as returned by GET_LAST_ID. */
+        std::uint32_t id = 0;
+        
+        /** Length of the straight move of the goal, 0 for pure rotations. */
+        float length = 0.f;
+        
+        /** Linear speed at the start of the goal, in mm/s. */
+        float entrySpeed = 0.f;
+        
+        /** Linear speed at the end of the goal, in mm/s. 0 when the robot has to stop on the goal. */
+        float exitSpeed = 0.f;
+        
+        /** Unit vector of the straight move of the goal, in the robot moving direction. */
+        float dirX = 0.f;
+        float dirY = 0.f;
+    };
+    
+    /**
+     * Fixed-capacity FIFO of goals, planning the speeds at which consecutive goals are chained.
+     * 
+     * Instead of stopping on each waypoint, the robot goes through it at the highest speed allowing it to turn within MotionLimits::junctionDeviation, and still able to stop at the end of the last planned goal. Only the first LookAhead goals are planned, the last one of the window always ending at rest.
+     * Planning only happens when the queue or the robot state change (see plan), never on every control tick.
+     * 
+     * @tparam Capacity The maximum number of queued goals.
+     * @tparam LookAhead The number of goals considered to plan the speeds.
+     */
+    template<std::size_t Capacity = 32, std::size_t LookAhead = 8>
+    class GoalQueue {
+        static_assert(LookAhead > 0 && LookAhead <= Capacity, "The look-ahead window must fit in the queue.");
+        
+    public:
+        /**
+         * Adds a goal at the end of the queue.
+         * 
+         * @param goal The goal to add.
+         * @return The identifier of the goal, or std::nullopt if the queue is full.
+         */
+        std::optional<std::uint32_t> push(const Goal& goal) noexcept {
+            if (m_size >= Capacity) {
+                return std::nullopt;
+            }
+            PlannedGoal& planned = m_goals[(m_head + m_size) % Capacity];
+            planned = PlannedGoal{};
+            planned.goal = goal;
+            planned.id = m_nextId++;
+            ++m_size;
+            return planned.id;
+        }
+        
+        /** The goal being executed, or nullptr if the queue is empty. */
+        const PlannedGoal* front() const noexcept {
+            return m_size == 0 ? nullptr : &m_goals[m_head];
+        }
+        
+        /**
+         * The i-th queued goal, 0 being the one being executed.
+         * 
+         * @param i The position of the goal, which must be smaller than size().
+         */
+        const PlannedGoal& operator[](std::size_t i) const noexcept {
+            return m_goals[(m_head + i) % Capacity];
+        }
+        
+        /** Removes the goal being executed, once reached or killed. */
+        void pop() noexcept {
+            if (m_size == 0) {
+                return;
+            }
+            m_lastReachedId = m_goals[m_head].id;
+            m_head = (m_head + 1) % Capacity;
+            --m_size;
+        }
+        
+        /** Removes all the goals, see CLEAN_GOALS. */
+        void clear() noexcept {
+            m_size = 0;
+        }
+        
+        /** Restarts the goal identifiers from 0, see RESET_ID. */
+        void resetIds() noexcept {
+            m_nextId = 0;
+            m_lastReachedId = 0;
+        }
+        
+        /** Identifier of the last goal removed from the queue. */
+        std::uint32_t lastReachedId() const noexcept {
+            return m_lastReachedId;
+        }
+        
+        std::size_t size() const noexcept {
+            return m_size;
+        }
+        
+        bool empty() const noexcept {
+            return m_size == 0;
+        }
+        
+        /**
+         * Plans the entry and exit speeds of the first LookAhead goals.
+         * 
+         * Must be called whenever goals are added or removed, or when the limits change.
+         * 
+         * @param start The current pose of the robot.
+         * @param currentSpeed The current linear speed of the robot, in mm/s.
+         * @param limits The kinematic limits of the robot.
+         */
+        void plan(const Pose& start, float currentSpeed, const MotionLimits& limits) noexcept {
+            const std::size_t windowSize = std::min(m_size, LookAhead);
+            if (windowSize == 0) {
+                return;
+            }
+            
+            // Geometry of the straight moves, each goal starting where the previous one ends
+            float fromX = start.x;
+            float fromY = start.y;
+            for (std::size_t i = 0; i < windowSize; ++i) {
+                PlannedGoal& planned = at(i);
+                computeGeometry(planned, fromX, fromY);
+                if (isStraightMove(planned.goal.type)) {
+                    fromX = planned.goal.x;
+                    fromY = planned.goal.y;
+                }
+            }
+            
+            // Backward pass: the robot must be able to stop at the end of the window
+            float nextEntrySpeed = 0.f;
+            for (std::size_t i = windowSize; i-- > 0;) {
+                PlannedGoal& planned = at(i);
+                const float junctionSpeed = i + 1 < windowSize ? junctionMaxSpeed(planned, at(i + 1), limits) : 0.f;
+                planned.exitSpeed = std::min(junctionSpeed, nextEntrySpeed);
+                planned.entrySpeed = isStraightMove(planned.goal.type)
+                    ? std::min(limits.maxSpeed, reachableSpeed(planned.exitSpeed, limits.maxAcc, planned.length))
+                    : 0.f;
+                nextEntrySpeed = planned.entrySpeed;
+            }
+            
+            // Forward pass: the robot can't accelerate faster than maxAcc from its current speed
+            float entrySpeed = std::min(currentSpeed, at(0).entrySpeed);
+            for (std::size_t i = 0; i < windowSize; ++i) {
+                PlannedGoal& planned = at(i);
+                planned.entrySpeed = entrySpeed;
+                planned.exitSpeed = std::min(planned.exitSpeed, reachableSpeed(entrySpeed, limits.maxAcc, planned.length));
+                entrySpeed = planned.exitSpeed;
+            }
+        }
+        
+    private:
+        std::array<PlannedGoal, Capacity> m_goals{};
+        std::size_t m_head = 0;
+        std::size_t m_size = 0;
+        std::uint32_t m_nextId = 0;
+        std::uint32_t m_lastReachedId = 0;
+        
+        PlannedGoal& at(std::size_t i) noexcept {
+            return m_goals[(m_head + i) % Capacity];
+        }
+        
+        static constexpr bool isStraightMove(GoalType type) noexcept {
+            return type == GoalType::GOTO || type == GoalType::GOTO_WITH_ANGLE;
+        }
+        
+        /** Speed reachable after accelerating over a distance: v² = v0² + 2·a·d. */
+        static float reachableSpeed(float fromSpeed, float acc, float distance) noexcept {
+            return std::sqrt(fromSpeed * fromSpeed + 2.f * acc * distance);
+        }
+        
+        static void computeGeometry(PlannedGoal& planned, float fromX, float fromY) noexcept {
+            if (!isStraightMove(planned.goal.type)) {
+                planned.length = 0.f;
+                planned.dirX = 0.f;
+                planned.dirY = 0.f;
+                return;
+            }
+            const float dx = planned.goal.x - fromX;
+            const float dy = planned.goal.y - fromY;
+            planned.length = std::hypot(dx, dy);
+            planned.dirX = planned.length > 0.f ? dx / planned.length : 0.f;
+            planned.dirY = planned.length > 0.f ? dy / planned.length : 0.f;
+        }
+        
+        /**
+         * Maximum speed at the junction between two goals.
+         * 
+         * The robot stops when one of the goals isn't a plain GOTO, or when the moving direction is reversed. Otherwise, the speed is limited so that the centripetal acceleration of a circle tangent to both moves, and passing at junctionDeviation from the waypoint, doesn't exceed maxAcc.
+         */
+        static float junctionMaxSpeed(const PlannedGoal& from, const PlannedGoal& to, const MotionLimits& limits) noexcept {
+            if (from.goal.type != GoalType::GOTO || to.goal.type != GoalType::GOTO
+                || from.goal.direction != to.goal.direction
+                || from.length == 0.f || to.length == 0.f) {
+                return 0.f;
+            }
+            
+            // Cosine of the angle between the incoming move, reversed, and the outgoing move
+            const float cosTheta = -(from.dirX * to.dirX + from.dirY * to.dirY);
+            if (cosTheta > 0.999999f) {
+                return 0.f;
+            }
+            if (cosTheta < -0.999999f) {
+                return limits.maxSpeed;
+            }
+            const float sinHalfTheta = std::sqrt(0.5f * (1.f - cosTheta));
+            const float speed = std::sqrt(limits.maxAcc * limits.junctionDeviation * sinHalfTheta / (1.f - sinHalfTheta));
+            return std::min(speed, limits.maxSpeed);
+        }
+    };
+} // namespace utcoupe::asserv::control
+
+#endif // UTCOUPE_ASSERV_CONTROL_GOAL_QUEUE_HPP
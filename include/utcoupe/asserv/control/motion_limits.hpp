@@ -0,0 +1,25 @@
+#ifndef UTCOUPE_ASSERV_CONTROL_MOTION_LIMITS_HPP
+#define UTCOUPE_ASSERV_CONTROL_MOTION_LIMITS_HPP
+
+namespace utcoupe::asserv::control {
+    /** Kinematic limits used to plan the moves, set by the SPD_MAX and ACC_MAX orders. */
+    struct MotionLimits {
+        /** Maximum linear speed, in mm/s. */
+        float maxSpeed = 500.f;
+        
+        /** Maximum linear acceleration, in mm/s². */
+        float maxAcc = 1000.f;
+        
+        /** Maximum linear jerk, in mm/s³, only used by jerk-limited profiles. */
+        float maxJerk = 10000.f;
+        
+        /**
+         * Allowed deviation from a waypoint when going through it without stopping, in millimeters.
+         * 
+         * The bigger it is, the faster sharp turns are taken. 0 stops on every waypoint.
+         */
+        float junctionDeviation = 5.f;
+    };
+} // namespace utcoupe::asserv::control
+
+#endif // UTCOUPE_ASSERV_CONTROL_MOTION_LIMITS_HPP
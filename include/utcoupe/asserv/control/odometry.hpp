@@ -0,0 +1,165 @@
+#ifndef UTCOUPE_ASSERV_CONTROL_ODOMETRY_HPP
+#define UTCOUPE_ASSERV_CONTROL_ODOMETRY_HPP
+
+#include "utcoupe/asserv/control/pose.hpp"
+#include "utcoupe/asserv/fixed_point.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <span>
+
+namespace utcoupe::asserv::control {
+    /** Ticks counted by both encoders during one period of the control loop. */
+    struct EncoderSample {
+        std::int32_t left = 0;
+        std::int32_t right = 0;
+    };
+    
+    /** Geometry of the encoder wheels. */
+    template<class NumberT = Real>
+    struct OdometryConfig {
+        /** Distance traveled by the left wheel for one encoder tick, in millimeters. */
+        NumberT leftMmPerTick{ 0.1f };
+        
+        /** Distance traveled by the right wheel for one encoder tick, in millimeters. */
+        NumberT rightMmPerTick{ 0.1f };
+        
+        /** Distance between the contact points of the encoder wheels, in millimeters. */
+        NumberT wheelBase{ 250 };
+    };
+    
+    /**
+     * Integrates the encoder ticks into the pose of the robot.
+     * 
+     * Each sample is integrated as an exact circular arc, not as a straight segment. Instead of computing the sine and cosine of the orientation on every sample, they are kept up to date by rotating them by the angle of the sample, which is computed with a short Taylor series as it is always small. They are resynchronized with the orientation every RESYNC_PERIOD samples to not accumulate the rounding errors.
+     * 
+     * @tparam NumberT float, or a Fixed type for the boards without FPU.
+     */
+    template<class NumberT = Real>
+    class Odometry {
+    public:
+        /** Number of samples after which the cached sine and cosine are recomputed from the orientation. */
+        static constexpr std::uint32_t RESYNC_PERIOD = 1024;
+        
+        explicit Odometry(const OdometryConfig<NumberT>& config) noexcept: m_config(config) {
+            setPose({});
+        }
+        
+        /**
+         * Integrates one sample of the encoders.
+         * 
+         * @param sample The ticks counted since the previous sample.
+         */
+        void update(const EncoderSample& sample) noexcept {
+            m_leftCoder += sample.left;
+            m_rightCoder += sample.right;
+            
+            const NumberT left = static_cast<NumberT>(sample.left) * m_config.leftMmPerTick;
+            const NumberT right = static_cast<NumberT>(sample.right) * m_config.rightMmPerTick;
+            const NumberT distance = (left + right) * HALF;
+            const NumberT angle = (right - left) / m_config.wheelBase;
+            
+            NumberT cosAngle;
+            NumberT sinAngle;
+            // Displacement along and across the initial heading, divided by the distance
+            NumberT forward;
+            NumberT lateral;
+            if (angle > SMALL_ANGLE || angle < -SMALL_ANGLE) {
+                // Only happens if the robot is spinning very fast or the loop was very late
+                const auto angleF = static_cast<float>(angle);
+                cosAngle = NumberT{ std::cos(angleF) };
+                sinAngle = NumberT{ std::sin(angleF) };
+                forward = sinAngle / angle;
+                lateral = (ONE - cosAngle) / angle;
+            } else {
+                // sin(a) / a = 1 - a²/6 + a⁴/120, (1 - cos(a)) / a = a/2 - a³/24 + a⁵/720
+                const NumberT angle2 = angle * angle;
+                forward = ONE - angle2 / NumberT{ 6 } * (ONE - angle2 / NumberT{ 20 });
+                lateral = angle * HALF * (ONE - angle2 / NumberT{ 12 } * (ONE - angle2 / NumberT{ 30 }));
+                sinAngle = angle * forward;
+                cosAngle = ONE - angle * lateral;
+            }
+            
+            m_x += distance * (forward * m_cos - lateral * m_sin);
+            m_y += distance * (forward * m_sin + lateral * m_cos);
+            
+            const NumberT cosTheta = m_cos * cosAngle - m_sin * sinAngle;
+            m_sin = m_sin * cosAngle + m_cos * sinAngle;
+            m_cos = cosTheta;
+            
+            m_theta += angle;
+            if (m_theta > PI) {
+                m_theta -= TWO_PI;
+            } else if (m_theta <= -PI) {
+                m_theta += TWO_PI;
+            }
+            
+            if (++m_samplesSinceResync == RESYNC_PERIOD) {
+                resync();
+            }
+        }
+        
+        /**
+         * Integrates several samples at once, e.g. when the control loop was late and the encoders have been sampled by a timer in the meantime.
+         * 
+         * @param samples The samples, from the oldest to the newest.
+         */
+        void update(std::span<const EncoderSample> samples) noexcept {
+            for (const EncoderSample& sample : samples) {
+                update(sample);
+            }
+        }
+        
+        /** Sets the pose of the robot, e.g. on the SET_POS order or after a wall calibration. */
+        void setPose(const Pose& pose) noexcept {
+            m_x = NumberT{ pose.x };
+            m_y = NumberT{ pose.y };
+            m_theta = NumberT{ pose.theta };
+            resync();
+        }
+        
+        Pose pose() const noexcept {
+            return { static_cast<float>(m_x), static_cast<float>(m_y), static_cast<float>(m_theta) };
+        }
+        
+        /** Total ticks counted by the left encoder since the creation of the odometry, as returned by GET_CODER. */
+        std::int32_t leftCoder() const noexcept {
+            return m_leftCoder;
+        }
+        
+        /** Total ticks counted by the right encoder since the creation of the odometry, as returned by GET_CODER. */
+        std::int32_t rightCoder() const noexcept {
+            return m_rightCoder;
+        }
+        
+    private:
+        static constexpr NumberT ONE{ 1 };
+        static constexpr NumberT HALF{ 0.5f };
+        static constexpr NumberT PI{ 3.14159265f };
+        static constexpr NumberT TWO_PI{ 6.28318531f };
+        
+        /** Largest angle per sample for which the Taylor series are accurate to the float precision. */
+        static constexpr NumberT SMALL_ANGLE{ 0.25f };
+        
+        OdometryConfig<NumberT> m_config;
+        
+        NumberT m_x{};
+        NumberT m_y{};
+        NumberT m_theta{};
+        NumberT m_cos{ 1 };
+        NumberT m_sin{};
+        std::uint32_t m_samplesSinceResync = 0;
+        
+        std::int32_t m_leftCoder = 0;
+        std::int32_t m_rightCoder = 0;
+        
+        void resync() noexcept {
+            const auto theta = static_cast<float>(m_theta);
+            m_cos = NumberT{ std::cos(theta) };
+            m_sin = NumberT{ std::sin(theta) };
+            m_samplesSinceResync = 0;
+        }
+    };
+} // namespace utcoupe::asserv::control
+
+#endif // UTCOUPE_ASSERV_CONTROL_ODOMETRY_HPP
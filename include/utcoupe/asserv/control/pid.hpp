@@ -0,0 +1,177 @@
+#ifndef UTCOUPE_ASSERV_CONTROL_PID_HPP
+#define UTCOUPE_ASSERV_CONTROL_PID_HPP
+
+#include "utcoupe/asserv/fixed_point.hpp"
+#include "utcoupe/asserv/spsc_queue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace utcoupe::asserv::control {
+    /** The wheels driven by a DualPid, used as lane indices. */
+    enum class Wheel : std::uint8_t {
+        LEFT = 0,
+        RIGHT = 1
+    };
+    
+    /** Number of wheels driven by a DualPid. */
+    inline constexpr std::size_t WHEEL_COUNT = 2;
+    
+    /** One value per wheel, indexed by Wheel. */
+    template<class NumberT>
+    using WheelValues = std::array<NumberT, WHEEL_COUNT>;
+    
+    /** The wheels whose gains are changed, matching the PID_LEFT, PID_RIGHT and PID_ALL orders. */
+    enum class PidTarget : std::uint8_t {
+        LEFT = 1,
+        RIGHT = 2,
+        BOTH = LEFT | RIGHT
+    };
+    
+    template<class NumberT = Real>
+    struct PidGains {
+        NumberT p{};
+        NumberT i{};
+        NumberT d{};
+    };
+    
+    /** Settings of a DualPid which don't change while running. */
+    template<class NumberT = Real>
+    struct PidConfig {
+        /** Period of the control loop, in seconds. */
+        NumberT period{ 0.005f };
+        
+        /** The output is clamped to [-outputLimit, outputLimit], e.g. the maximum PWM. */
+        NumberT outputLimit{ 255 };
+        
+        /** The integral term is clamped to [-integralLimit, integralLimit]. */
+        NumberT integralLimit{ 100 };
+        
+        /** Time constant of the low-pass filter applied to the derivative term, in seconds. 0 disables the filter. */
+        NumberT derivativeTimeConstant{ 0.02f };
+    };
+    
+    /**
+     * Speed controller of both wheels, computed together.
+     * 
+     * Each wheel is a PID with:
+     *  - anti-windup: the integral term is clamped, and only grows while the output is saturated to fill what the other terms leave up to the limit;
+     *  - derivative on the measure (no kick on setpoint changes) through a first-order low-pass filter;
+     *  - bumpless gain changes: the integral term is accumulated already multiplied by the integral gain.
+     * 
+     * The state is stored as one array per quantity, so that tick computes both wheels with the same branchless instructions, which the compiler can vectorize.
+     * Gains are changed by setGains from the order context, and only applied at the beginning of the next tick: a tick never runs with gains coming from different orders.
+     * 
+     * @tparam NumberT float, or a Fixed type for the boards without FPU.
+     * @tparam UpdateCapacity The number of gain changes which can be pending between two ticks.
+     */
+    template<class NumberT = Real, std::size_t UpdateCapacity = 4>
+    class DualPid {
+    public:
+        explicit DualPid(const PidConfig<NumberT>& config) noexcept:
+            m_outputLimit(config.outputLimit),
+            m_integralLimit(config.integralLimit),
+            m_period(config.period),
+            m_derivativeSmoothing(config.period / (config.derivativeTimeConstant + config.period)) {}
+            
+        /**
+         * Requests new gains, applied at the beginning of the next tick. Must only be called from a single context, e.g. the one running the orders.
+         * 
+         * @param target The wheels to set the gains of.
+         * @param gains The new gains.
+         * @return False if too many changes are already pending, in which case the gains are ignored.
+         */
+        bool setGains(PidTarget target, const PidGains<NumberT>& gains) noexcept {
+            return m_pendingGains.push({ target, gains });
+        }
+        
+        /**
+         * Computes the outputs of both wheels for one period of the control loop. Must only be called from the control loop.
+         * 
+         * @param setpoints The target speed of each wheel.
+         * @param measures The measured speed of each wheel.
+         * @return The command of each wheel, within the output limit.
+         */
+        WheelValues<NumberT> tick(const WheelValues<NumberT>& setpoints, const WheelValues<NumberT>& measures) noexcept {
+            applyPendingGains();
+            
+            WheelValues<NumberT> outputs;
+            for (std::size_t w = 0; w < WHEEL_COUNT; ++w) {
+                const NumberT error = setpoints[w] - measures[w];
+                
+                // Multiplied by the period last: a small gain times the period would fall under the resolution of a Fixed
+                const NumberT integral = std::clamp(m_integral[w] + m_integralGain[w] * error * m_period, -m_integralLimit, m_integralLimit);
+                
+                const NumberT rate = m_previousMeasures[w] - measures[w];
+                m_filteredRate[w] += m_derivativeSmoothing * (rate - m_filteredRate[w]);
+                m_previousMeasures[w] = measures[w];
+                
+                // Conditional integration: the integral only grows towards a saturation up to the output limit, and never past
+                // its previous value when the other terms saturate by themselves, so it keeps its sign and its bound
+                const NumberT others = m_proportionalGain[w] * error + m_derivativeGain[w] * m_filteredRate[w];
+                const NumberT upper = std::max(m_integral[w], m_outputLimit - others);
+                const NumberT lower = std::min(m_integral[w], -m_outputLimit - others);
+                m_integral[w] = std::clamp(integral, lower, upper);
+                
+                outputs[w] = std::clamp(others + m_integral[w], -m_outputLimit, m_outputLimit);
+            }
+            return outputs;
+        }
+        
+        /**
+         * Clears the integral and derivative terms, e.g. when the motors have been disabled.
+         * 
+         * @param measures The current measures, so that the next tick doesn't see any derivative kick.
+         */
+        void reset(const WheelValues<NumberT>& measures = {}) noexcept {
+            m_integral = {};
+            m_filteredRate = {};
+            m_previousMeasures = measures;
+        }
+        
+        /** The gains currently applied to a wheel. Must only be called from the control loop. */
+        PidGains<NumberT> gains(Wheel wheel) const noexcept {
+            const auto w = static_cast<std::size_t>(wheel);
+            return { m_proportionalGain[w], m_integralGain[w], m_derivativeGain[w] * m_period };
+        }
+        
+    private:
+        struct GainsUpdate {
+            PidTarget target = PidTarget::BOTH;
+            PidGains<NumberT> gains;
+        };
+        
+        SpscQueue<GainsUpdate, UpdateCapacity> m_pendingGains;
+        
+        // The derivative gain is divided by the period ahead, so that the tick doesn't divide
+        WheelValues<NumberT> m_proportionalGain{};
+        WheelValues<NumberT> m_integralGain{};
+        WheelValues<NumberT> m_derivativeGain{};
+        
+        WheelValues<NumberT> m_integral{};
+        WheelValues<NumberT> m_filteredRate{};
+        WheelValues<NumberT> m_previousMeasures{};
+        
+        NumberT m_outputLimit;
+        NumberT m_integralLimit;
+        NumberT m_period;
+        NumberT m_derivativeSmoothing;
+        
+        void applyPendingGains() noexcept {
+            while (auto update = m_pendingGains.pop()) {
+                for (std::size_t w = 0; w < WHEEL_COUNT; ++w) {
+                    if ((static_cast<std::uint8_t>(update->target) & (1U << w)) == 0) {
+                        continue;
+                    }
+                    m_proportionalGain[w] = update->gains.p;
+                    m_integralGain[w] = update->gains.i;
+                    m_derivativeGain[w] = update->gains.d / m_period;
+                }
+            }
+        }
+    };
+} // namespace utcoupe::asserv::control
+
+#endif // UTCOUPE_ASSERV_CONTROL_PID_HPP
@@ -0,0 +1,18 @@
+#ifndef UTCOUPE_ASSERV_CONTROL_POSE_HPP
+#define UTCOUPE_ASSERV_CONTROL_POSE_HPP
+
+namespace utcoupe::asserv::control {
+    /** Position and orientation of the robot on the table. */
+    struct Pose {
+        /** Abscissa, in millimeters. */
+        float x = 0.f;
+        
+        /** Ordinate, in millimeters. */
+        float y = 0.f;
+        
+        /** Orientation, in radians. */
+        float theta = 0.f;
+    };
+} // namespace utcoupe::asserv::control
+
+#endif // UTCOUPE_ASSERV_CONTROL_POSE_HPP
@@ -0,0 +1,256 @@
+#ifndef UTCOUPE_ASSERV_CONTROL_VELOCITY_PROFILE_HPP
+#define UTCOUPE_ASSERV_CONTROL_VELOCITY_PROFILE_HPP
+
+#include "utcoupe/asserv/control/motion_limits.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace utcoupe::asserv::control {
+    /** The shapes of the speed profiles. */
+    enum class ProfileShape : std::uint8_t {
+        /** Constant acceleration phases: the acceleration steps between 0 and MotionLimits::maxAcc. */
+        TRAPEZOIDAL,
+        /** Jerk-limited phases: the acceleration ramps up to MotionLimits::maxAcc at MotionLimits::maxJerk. */
+        S_CURVE
+    };
+    
+    /** The setpoint given by a profile at a given time. */
+    struct ProfileState {
+        /** Distance traveled since the start of the profile. */
+        float position = 0.f;
+        float speed = 0.f;
+        float acceleration = 0.f;
+    };
+    
+    /**
+     * Speed profile moving over a given distance, from an entry speed to an exit speed, within some MotionLimits.
+     * 
+     * The profile is computed once per goal (see plan), as up to 7 phases of constant jerk. Evaluating it on a control tick (see at) only looks for the current phase and evaluates a cubic polynomial: no trigonometry nor square root.
+     * Distances may be negative, e.g. to move backward or rotate clockwise: the profile is then mirrored.
+     */
+    class VelocityProfile {
+    public:
+        /** Maximum number of phases of a profile: jerk up, constant acceleration, jerk down, cruise, and the same backward. */
+        static constexpr std::size_t MAX_PHASES = 7;
+        
+        /**
+         * Computes the fastest profile moving over a distance.
+         * 
+         * If the exit speed can't be reached within the distance, the profile ends at the closest reachable speed, see exitSpeed.
+         * 
+         * @param distance The signed distance to move over.
+         * @param entrySpeed The speed at the start of the profile, in absolute value.
+         * @param exitSpeed The speed at the end of the profile, in absolute value.
+         * @param limits The kinematic limits to honor.
+         * @param shape The shape of the acceleration phases.
+         * @return The computed profile.
+         */
+        static VelocityProfile plan(float distance, float entrySpeed, float exitSpeed, const MotionLimits& limits, ProfileShape shape = ProfileShape::TRAPEZOIDAL) noexcept {
+            VelocityProfile profile;
+            profile.m_sign = distance < 0.f ? -1.f : 1.f;
+            
+            const float length = std::abs(distance);
+            const Limits absLimits{ std::max(limits.maxSpeed, 0.f), std::max(limits.maxAcc, 0.f), std::max(limits.maxJerk, 0.f), shape };
+            if (absLimits.speed <= 0.f || absLimits.acc <= 0.f || (shape == ProfileShape::S_CURVE && absLimits.jerk <= 0.f)) {
+                return profile;
+            }
+            
+            const float v0 = std::clamp(entrySpeed, 0.f, absLimits.speed);
+            float v1 = std::clamp(exitSpeed, 0.f, absLimits.speed);
+            
+            // Lower the speed change until it fits in the distance
+            if (changeDistance(v0, v1, absLimits) > length) {
+                v1 = largestFitting(v0, v1, [&](float speed) { return changeDistance(v0, speed, absLimits) <= length; });
+            }
+            
+            // Then find the highest cruise speed still allowing to reach the exit speed
+            auto fits = [&](float speed) {
+                return changeDistance(v0, speed, absLimits) + changeDistance(speed, v1, absLimits) <= length;
+            };
+            const float cruiseSpeed = fits(absLimits.speed)
+                ? absLimits.speed
+                : largestFitting(std::max(v0, v1), absLimits.speed, fits);
+                
+            profile.m_start = { 0.f, v0, 0.f };
+            profile.addSpeedChange(v0, cruiseSpeed, absLimits);
+            const float cruiseDistance = length - changeDistance(v0, cruiseSpeed, absLimits) - changeDistance(cruiseSpeed, v1, absLimits);
+            if (cruiseSpeed > 0.f && cruiseDistance > 0.f) {
+                profile.addPhase(cruiseDistance / cruiseSpeed, 0.f, 0.f);
+            }
+            profile.addSpeedChange(cruiseSpeed, v1, absLimits);
+            
+            // Snap the end on the exact target to not accumulate the integration errors of each phase
+            profile.m_end = { length, v1, 0.f };
+            return profile;
+        }
+        
+        /**
+         * Evaluates the profile.
+         * 
+         * @param time The time elapsed since the start of the profile, in seconds.
+         * @return The setpoint at that time. Before the start or after the end, the profile is extended at constant speed.
+         */
+        ProfileState at(float time) const noexcept {
+            if (time >= m_duration) {
+                const float extra = time - m_duration;
+                return mirrored({ m_end.position + m_end.speed * extra, m_end.speed, 0.f });
+            }
+            if (time <= 0.f) {
+                return mirrored({ m_start.speed * time, m_start.speed, 0.f });
+            }
+            
+            std::size_t phase = 0;
+            while (phase + 1 < m_phaseCount && time >= m_phases[phase + 1].startTime) {
+                ++phase;
+            }
+            
+            const Phase& current = m_phases[phase];
+            const float dt = time - current.startTime;
+            const float acceleration = current.acceleration + current.jerk * dt;
+            const float speed = current.speed + (current.acceleration + current.jerk * dt * 0.5f) * dt;
+            const float position = current.position + (current.speed + (current.acceleration * 0.5f + current.jerk * dt * (1.f / 6.f)) * dt) * dt;
+            return mirrored({ position, speed, acceleration });
+        }
+        
+        /** Total duration of the profile, in seconds. */
+        float duration() const noexcept {
+            return m_duration;
+        }
+        
+        /** Signed distance moved over by the whole profile. */
+        float distance() const noexcept {
+            return m_sign * m_end.position;
+        }
+        
+        /** Speed at the end of the profile, in absolute value. Lower than the requested one if it couldn't be reached. */
+        float exitSpeed() const noexcept {
+            return m_end.speed;
+        }
+        
+        /** Number of constant jerk phases of the profile. */
+        std::size_t phaseCount() const noexcept {
+            return m_phaseCount;
+        }
+        
+    private:
+        struct Limits {
+            float speed;
+            float acc;
+            float jerk;
+            ProfileShape shape;
+        };
+        
+        /** A phase of constant jerk, along with the state at its start. */
+        struct Phase {
+            float startTime = 0.f;
+            float jerk = 0.f;
+            float position = 0.f;
+            float speed = 0.f;
+            float acceleration = 0.f;
+        };
+        
+        std::array<Phase, MAX_PHASES> m_phases{};
+        std::size_t m_phaseCount = 0;
+        float m_duration = 0.f;
+        float m_sign = 1.f;
+        ProfileState m_start;
+        ProfileState m_end;
+        
+        /** Number of bisection steps used to find the cruise and exit speeds, enough for a float. */
+        static constexpr int SEARCH_STEPS = 24;
+        
+        /**
+         * Time needed to change speed by some amount.
+         * 
+         * With an S-curve, the acceleration ramps up and down at the maximum jerk, and is held at the maximum acceleration only if the speed change is big enough.
+         */
+        static float changeDuration(float speedChange, const Limits& limits) noexcept {
+            if (limits.shape == ProfileShape::TRAPEZOIDAL) {
+                return speedChange / limits.acc;
+            }
+            if (speedChange >= limits.acc * limits.acc / limits.jerk) {
+                return speedChange / limits.acc + limits.acc / limits.jerk;
+            }
+            return 2.f * std::sqrt(speedChange / limits.jerk);
+        }
+        
+        /** Distance needed to change speed, both phase shapes being symmetric. */
+        static float changeDistance(float from, float to, const Limits& limits) noexcept {
+            return (from + to) * 0.5f * changeDuration(std::abs(to - from), limits);
+        }
+        
+        /**
+         * Finds the speed closest to target, between fallback and target, satisfying a predicate.
+         * 
+         * The predicate must hold for fallback and be monotonic over the interval.
+         */
+        template<class PredicateT>
+        static float largestFitting(float fallback, float target, PredicateT&& fits) noexcept {
+            float valid = fallback;
+            float invalid = target;
+            for (int step = 0; step < SEARCH_STEPS; ++step) {
+                const float middle = (valid + invalid) * 0.5f;
+                (fits(middle) ? valid : invalid) = middle;
+            }
+            return valid;
+        }
+        
+        /** Appends a phase, starting from the position and speed reached at the end of the previous one. */
+        void addPhase(float duration, float jerk, float acceleration) noexcept {
+            if (duration <= 0.f || m_phaseCount == MAX_PHASES) {
+                return;
+            }
+            
+            const ProfileState start = m_phaseCount == 0 ? m_start : currentEnd();
+            m_phases[m_phaseCount++] = { m_duration, jerk, start.position, start.speed, acceleration };
+            m_duration += duration;
+            m_end = currentEnd();
+        }
+        
+        /** State at the end of the last phase. */
+        ProfileState currentEnd() const noexcept {
+            const Phase& last = m_phases[m_phaseCount - 1];
+            const float dt = m_duration - last.startTime;
+            return {
+                last.position + (last.speed + (last.acceleration * 0.5f + last.jerk * dt * (1.f / 6.f)) * dt) * dt,
+                last.speed + (last.acceleration + last.jerk * dt * 0.5f) * dt,
+                last.acceleration + last.jerk * dt
+            };
+        }
+        
+        /** Appends the phases changing the speed, ending at null acceleration. */
+        void addSpeedChange(float from, float to, const Limits& limits) noexcept {
+            const float speedChange = std::abs(to - from);
+            const float direction = to < from ? -1.f : 1.f;
+            if (speedChange <= 0.f) {
+                return;
+            }
+            
+            if (limits.shape == ProfileShape::TRAPEZOIDAL) {
+                addPhase(speedChange / limits.acc, 0.f, direction * limits.acc);
+                return;
+            }
+            
+            if (speedChange >= limits.acc * limits.acc / limits.jerk) {
+                const float rampDuration = limits.acc / limits.jerk;
+                addPhase(rampDuration, direction * limits.jerk, 0.f);
+                addPhase(speedChange / limits.acc - rampDuration, 0.f, direction * limits.acc);
+                addPhase(rampDuration, -direction * limits.jerk, direction * limits.acc);
+            } else {
+                const float rampDuration = std::sqrt(speedChange / limits.jerk);
+                addPhase(rampDuration, direction * limits.jerk, 0.f);
+                addPhase(rampDuration, -direction * limits.jerk, direction * limits.jerk * rampDuration);
+            }
+        }
+        
+        ProfileState mirrored(const ProfileState& state) const noexcept {
+            return { m_sign * state.position, m_sign * state.speed, m_sign * state.acceleration };
+        }
+    };
+} // namespace utcoupe::asserv::control
+
+#endif // UTCOUPE_ASSERV_CONTROL_VELOCITY_PROFILE_HPP
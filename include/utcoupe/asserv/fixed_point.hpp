@@ -0,0 +1,236 @@
+#ifndef UTCOUPE_ASSERV_FIXED_POINT_HPP
+#define UTCOUPE_ASSERV_FIXED_POINT_HPP
+
+#include <charconv>
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+
+namespace utcoupe::asserv {
+    /**
+     * A signed fixed-point number stored in 32 bits, FractionalBits of them being after the binary point.
+     * 
+     * Meant for the boards without FPU: every operation is done on integers, rounding to the nearest representable value and saturating instead of overflowing.
+     * Conversions from and to floating-point values are explicit, so that generic code works the same with float and Fixed, see Real.
+     * 
+     * @tparam FractionalBits The number of bits after the binary point, 16 for the Q16.16 format.
+     */
+    template<int FractionalBits>
+    class Fixed {
+        static_assert(FractionalBits > 0 && FractionalBits < 31, "A Fixed needs both integer and fractional bits.");
+        
+    public:
+        using RawT = std::int32_t;
+        
+        static constexpr int FRACTIONAL_BITS = FractionalBits;
+        
+        /** Raw value of 1. */
+        static constexpr RawT ONE = RawT{ 1 } << FractionalBits;
+        
+        constexpr Fixed() noexcept = default;
+        
+        template<std::integral IntT>
+        constexpr explicit Fixed(IntT value) noexcept: m_raw(saturate(static_cast<std::int64_t>(value) * ONE)) {}
+        
+        template<std::floating_point FloatT>
+        constexpr explicit Fixed(FloatT value) noexcept: m_raw(fromFloating(value)) {}
+        
+        /** Builds a Fixed from its raw representation, i.e. its value multiplied by 2^FractionalBits. */
+        static constexpr Fixed fromRaw(RawT raw) noexcept {
+            Fixed value;
+            value.m_raw = raw;
+            return value;
+        }
+        
+        static constexpr Fixed max() noexcept {
+            return fromRaw(std::numeric_limits<RawT>::max());
+        }
+        
+        static constexpr Fixed lowest() noexcept {
+            return fromRaw(std::numeric_limits<RawT>::min());
+        }
+        
+        constexpr RawT raw() const noexcept {
+            return m_raw;
+        }
+        
+        template<std::floating_point FloatT>
+        constexpr explicit operator FloatT() const noexcept {
+            return static_cast<FloatT>(m_raw) / static_cast<FloatT>(ONE);
+        }
+        
+        /** Converts to an integer, rounding toward zero. */
+        template<std::integral IntT>
+        constexpr explicit operator IntT() const noexcept {
+            return static_cast<IntT>(m_raw / ONE);
+        }
+        
+        constexpr Fixed operator-() const noexcept {
+            return fromRaw(saturate(-static_cast<std::int64_t>(m_raw)));
+        }
+        
+        constexpr Fixed& operator+=(Fixed other) noexcept {
+            m_raw = saturate(static_cast<std::int64_t>(m_raw) + other.m_raw);
+            return *this;
+        }
+        
+        constexpr Fixed& operator-=(Fixed other) noexcept {
+            m_raw = saturate(static_cast<std::int64_t>(m_raw) - other.m_raw);
+            return *this;
+        }
+        
+        constexpr Fixed& operator*=(Fixed other) noexcept {
+            const std::int64_t product = static_cast<std::int64_t>(m_raw) * other.m_raw;
+            m_raw = saturate((product + (std::int64_t{ 1 } << (FractionalBits - 1))) >> FractionalBits);
+            return *this;
+        }
+        
+        /** Divides, saturating when dividing by zero. */
+        constexpr Fixed& operator/=(Fixed other) noexcept {
+            if (other.m_raw == 0) {
+                m_raw = m_raw < 0 ? std::numeric_limits<RawT>::min() : std::numeric_limits<RawT>::max();
+                return *this;
+            }
+            
+            const std::int64_t dividend = static_cast<std::int64_t>(m_raw) * ONE;
+            const std::int64_t halfDivisor = (other.m_raw < 0 ? -other.m_raw : other.m_raw) / 2;
+            const std::int64_t rounding = (dividend < 0) == (other.m_raw < 0) ? halfDivisor : -halfDivisor;
+            m_raw = saturate((dividend + rounding) / other.m_raw);
+            return *this;
+        }
+        
+        friend constexpr Fixed operator+(Fixed lhs, Fixed rhs) noexcept {
+            return lhs += rhs;
+        }
+        
+        friend constexpr Fixed operator-(Fixed lhs, Fixed rhs) noexcept {
+            return lhs -= rhs;
+        }
+        
+        friend constexpr Fixed operator*(Fixed lhs, Fixed rhs) noexcept {
+            return lhs *= rhs;
+        }
+        
+        friend constexpr Fixed operator/(Fixed lhs, Fixed rhs) noexcept {
+            return lhs /= rhs;
+        }
+        
+        constexpr auto operator<=>(const Fixed&) const noexcept = default;
+        
+    private:
+        RawT m_raw = 0;
+        
+        static constexpr RawT saturate(std::int64_t raw) noexcept {
+            if (raw > std::numeric_limits<RawT>::max()) {
+                return std::numeric_limits<RawT>::max();
+            }
+            if (raw < std::numeric_limits<RawT>::min()) {
+                return std::numeric_limits<RawT>::min();
+            }
+            return static_cast<RawT>(raw);
+        }
+        
+        template<std::floating_point FloatT>
+        static constexpr RawT fromFloating(FloatT value) noexcept {
+            const FloatT scaled = value * static_cast<FloatT>(ONE);
+            if (!(scaled < static_cast<FloatT>(std::numeric_limits<RawT>::max()))) {
+                // Also catches NaN
+                return scaled < 0 ? std::numeric_limits<RawT>::min() : std::numeric_limits<RawT>::max();
+            }
+            if (scaled <= static_cast<FloatT>(std::numeric_limits<RawT>::min())) {
+                return std::numeric_limits<RawT>::min();
+            }
+            return static_cast<RawT>(scaled < 0 ? scaled - FloatT{ 0.5 } : scaled + FloatT{ 0.5 });
+        }
+    };
+    
+    /** 16 integer bits (sign included) and 16 fractional bits: from -32768 to 32767.99998, by steps of 1.5e-5. */
+    using Q16_16 = Fixed<16>;
+    
+    template<class T>
+    inline constexpr bool isFixedPoint = false;
+    
+    template<int FractionalBits>
+    inline constexpr bool isFixedPoint<Fixed<FractionalBits>> = true;
+    
+    /** Indicates wether if the templated type is a Fixed. */
+    template<class T>
+    concept FixedPoint = isFixedPoint<T>;
+    
+    template<int FractionalBits>
+    constexpr Fixed<FractionalBits> abs(Fixed<FractionalBits> value) noexcept {
+        return value < Fixed<FractionalBits>{} ? -value : value;
+    }
+    
+    /**
+     * Writes a Fixed as a decimal number, with the shortest fractional part that is exact to the resolution of the type.
+     * 
+     * Works like std::to_chars, e.g. "1.5", "-0.035", "12".
+     */
+    template<int FractionalBits>
+    std::to_chars_result toChars(char* first, char* last, Fixed<FractionalBits> value) noexcept {
+        using FixedT = Fixed<FractionalBits>;
+        
+        // ceil(FractionalBits * log10(2)) digits tell apart any two consecutive values
+        constexpr int fractionalDigits = (FractionalBits * 3 + 9) / 10;
+        constexpr std::uint64_t fractionalScale = [] {
+            std::uint64_t scale = 1;
+            for (int i = 0; i < fractionalDigits; ++i) {
+                scale *= 10;
+            }
+            return scale;
+        }();
+        
+        constexpr auto one = static_cast<std::uint64_t>(FixedT::ONE);
+        
+        const bool negative = value.raw() < 0;
+        const auto magnitude = static_cast<std::uint64_t>(negative ? -static_cast<std::int64_t>(value.raw()) : value.raw());
+        std::uint64_t integerPart = magnitude >> FractionalBits;
+        std::uint64_t fractionalPart = ((magnitude & (one - 1)) * fractionalScale + one / 2) >> FractionalBits;
+        if (fractionalPart == fractionalScale) {
+            ++integerPart;
+            fractionalPart = 0;
+        }
+        
+        if (negative && (integerPart != 0 || fractionalPart != 0)) {
+            if (first == last) {
+                return { last, std::errc::value_too_large };
+            }
+            *first++ = '-';
+        }
+        
+        auto result = std::to_chars(first, last, integerPart);
+        if (result.ec != std::errc{} || fractionalPart == 0) {
+            return result;
+        }
+        
+        int digits = fractionalDigits;
+        for (; fractionalPart % 10 == 0; fractionalPart /= 10) {
+            --digits;
+        }
+        char* cur = result.ptr;
+        if (last - cur < digits + 1) {
+            return { last, std::errc::value_too_large };
+        }
+        *cur++ = '.';
+        for (int i = digits - 1; i >= 0; --i) {
+            cur[i] = static_cast<char>('0' + fractionalPart % 10);
+            fractionalPart /= 10;
+        }
+        return { cur + digits, std::errc{} };
+    }
+    
+    /**
+     * The number type of the control math and of the order parameters, selected per build.
+     * 
+     * Q16_16 when UTCOUPE_ASSERV_FIXED_POINT is defined (ENABLE_FIXED_POINT CMake option), float otherwise.
+     */
+#ifdef UTCOUPE_ASSERV_FIXED_POINT
+    using Real = Q16_16;
+#else
+    using Real = float;
+#endif
+} // namespace utcoupe::asserv
+
+#endif // UTCOUPE_ASSERV_FIXED_POINT_HPP
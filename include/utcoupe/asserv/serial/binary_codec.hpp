@@ -0,0 +1,205 @@
+#ifndef UTCOUPE_ASSERV_SERIAL_BINARY_CODEC_HPP
+#define UTCOUPE_ASSERV_SERIAL_BINARY_CODEC_HPP
+
+#include "utcoupe/asserv/serial/traits.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+namespace utcoupe::asserv::serial {
+    /** Encoding of the orders on a serial link. */
+    enum class FrameFormat {
+        /** Human-readable "c;x;y;" frames, ended by a '\n'. */
+        ASCII,
+        /** Compact frames whose parameters are stored as fixed-width little-endian fields, see encodeBinaryFrame. */
+        BINARY
+    };
+    
+    /** First byte of every binary frame, used to resynchronize after a corrupted frame. */
+    inline constexpr char BINARY_FRAME_START = static_cast<char>(0xA5);
+    
+    /** Size of the binary frame header: start byte, order character and payload size. */
+    inline constexpr std::size_t BINARY_HEADER_SIZE = 3;
+    
+    /** Size of the CRC ending every binary frame. */
+    inline constexpr std::size_t BINARY_CRC_SIZE = 2;
+    
+    /** Maximum size of the payload of a binary frame, as it is stored in a single byte. */
+    inline constexpr std::size_t BINARY_MAX_PAYLOAD_SIZE = UINT8_MAX;
+    
+    /**
+     * Computes the CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) of some bytes.
+     * 
+     * @param bytes The bytes to compute the CRC of.
+     * @return The CRC.
+     */
+    constexpr std::uint16_t crc16(std::string_view bytes) noexcept {
+        std::uint16_t crc = 0xFFFF;
+        for (char byte : bytes) {
+            crc = static_cast<std::uint16_t>(crc ^ (static_cast<unsigned char>(byte) << 8));
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = static_cast<std::uint16_t>((crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1);
+            }
+        }
+        return crc;
+    }
+    
+    /** Size of the payload of a binary frame carrying the given parameter types. */
+    template<class ArgsTupleT>
+    inline constexpr std::size_t binaryPayloadSize = 0;
+    
+    template<Deserializable... ArgsT>
+    inline constexpr std::size_t binaryPayloadSize<std::tuple<ArgsT...>> = (std::size_t{ 0 } + ... + sizeof(ArgsT));
+    
+    /**
+     * Size of a whole binary frame, from its start byte to its CRC.
+     * 
+     * @param payloadSize The size of the payload of the frame.
+     */
+    constexpr std::size_t binaryFrameSize(std::size_t payloadSize) noexcept {
+        return BINARY_HEADER_SIZE + payloadSize + BINARY_CRC_SIZE;
+    }
+    
+    namespace impl {
+        /**
+         * Copies the bytes of a value stored in little-endian into it.
+         * 
+         * On little-endian targets this is a plain memcpy.
+         */
+        template<Deserializable ArgT>
+        void loadLittleEndian(const char* src, ArgT& value) noexcept {
+            if constexpr (std::endian::native == std::endian::little) {
+                std::memcpy(&value, src, sizeof(ArgT));
+            } else {
+                std::array<char, sizeof(ArgT)> bytes;
+                std::reverse_copy(src, src + sizeof(ArgT), bytes.begin());
+                std::memcpy(&value, bytes.data(), sizeof(ArgT));
+            }
+        }
+        
+        /** Copies the bytes of a value into a buffer, in little-endian. */
+        template<Deserializable ArgT>
+        void storeLittleEndian(char* dst, ArgT value) noexcept {
+            std::memcpy(dst, &value, sizeof(ArgT));
+            if constexpr (std::endian::native != std::endian::little) {
+                std::reverse(dst, dst + sizeof(ArgT));
+            }
+        }
+    } // namespace impl
+    
+    /**
+     * Deserializes values stored as consecutive little-endian fields.
+     * 
+     * @param payload The payload of a binary frame, whose size must exactly match the arguments.
+     * @param values The tuple to set deserialized values.
+     * @return True if it succeeded, false else.
+     */
+    template<typename... ArgsT>
+    bool decodeBinaryParameters(std::string_view payload, std::tuple<ArgsT...>& values) noexcept {
+        if (payload.size() != binaryPayloadSize<std::tuple<ArgsT...>>) {
+            return false;
+        }
+        
+        std::apply(
+            [src = payload.data()](auto&... value) mutable {
+                ((impl::loadLittleEndian(src, value), src += sizeof(value)), ...);
+            },
+            values
+        );
+        return true;
+    }
+    
+    /** The content of a binary frame whose CRC has been checked. */
+    struct BinaryFrame {
+        /** The character identifying the order. */
+        char chOrder;
+        
+        /** The parameters of the order, see decodeBinaryParameters. */
+        std::string_view payload;
+    };
+    
+    /**
+     * Checks the structure and the CRC of a binary frame.
+     * 
+     * @param frame A whole frame, from its start byte to its CRC.
+     * @return The order character and payload of the frame, or std::nullopt if it is corrupted.
+     */
+    constexpr std::optional<BinaryFrame> checkBinaryFrame(std::string_view frame) noexcept {
+        if (frame.size() < binaryFrameSize(0) || frame[0] != BINARY_FRAME_START) {
+            return std::nullopt;
+        }
+        
+        const std::size_t payloadSize = static_cast<unsigned char>(frame[2]);
+        if (frame.size() != binaryFrameSize(payloadSize)) {
+            return std::nullopt;
+        }
+        
+        const std::size_t crcPos = BINARY_HEADER_SIZE + payloadSize;
+        const auto receivedCrc = static_cast<std::uint16_t>(
+            static_cast<unsigned char>(frame[crcPos]) | (static_cast<unsigned char>(frame[crcPos + 1]) << 8)
+        );
+        if (crc16(frame.substr(0, crcPos)) != receivedCrc) {
+            return std::nullopt;
+        }
+        
+        return BinaryFrame{ frame[1], frame.substr(BINARY_HEADER_SIZE, payloadSize) };
+    }
+    
+    /**
+     * Serializes an order into a binary frame.
+     * 
+     * @param buffer The buffer to write the frame into.
+     * @param chOrder The character identifying the order.
+     * @param values The parameters of the order, whose types must exactly match the callback ones.
+     * @return The size of the frame, or 0 if it doesn't fit into the buffer.
+     */
+    template<Deserializable... ArgsT>
+    std::size_t encodeBinaryFrame(std::span<char> buffer, char chOrder, ArgsT... values) noexcept {
+        constexpr std::size_t payloadSize = binaryPayloadSize<std::tuple<ArgsT...>>;
+        static_assert(payloadSize <= BINARY_MAX_PAYLOAD_SIZE, "Too many parameters for a binary frame.");
+        
+        constexpr std::size_t frameSize = binaryFrameSize(payloadSize);
+        if (buffer.size() < frameSize) {
+            return 0;
+        }
+        
+        buffer[0] = BINARY_FRAME_START;
+        buffer[1] = chOrder;
+        buffer[2] = static_cast<char>(payloadSize);
+        
+        char* dst = buffer.data() + BINARY_HEADER_SIZE;
+        ((impl::storeLittleEndian(dst, values), dst += sizeof(ArgsT)), ...);
+        
+        const std::uint16_t crc = crc16(std::string_view{ buffer.data(), BINARY_HEADER_SIZE + payloadSize });
+        impl::storeLittleEndian(dst, crc);
+        return frameSize;
+    }
+    
+    /**
+     * Serializes an order into a binary frame, taking the parameter types from the order itself.
+     * 
+     * @param buffer The buffer to write the frame into.
+     * @param order The Order to serialize.
+     * @param values The parameters of the order.
+     * @return The size of the frame, or 0 if it doesn't fit into the buffer.
+     */
+    template<class OrderT>
+    std::size_t encodeBinaryOrder(std::span<char> buffer, const OrderT& order, const typename OrderT::CallbackArgs& values) noexcept {
+        return std::apply(
+            [&buffer, &order](auto... value) {
+                return encodeBinaryFrame(buffer, order.ch_order, value...);
+            },
+            values
+        );
+    }
+} // namespace utcoupe::asserv::serial
+
+#endif // UTCOUPE_ASSERV_SERIAL_BINARY_CODEC_HPP
@@ -0,0 +1,163 @@
+#ifndef UTCOUPE_ASSERV_SERIAL_DECODED_ORDER_HPP
+#define UTCOUPE_ASSERV_SERIAL_DECODED_ORDER_HPP
+
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/order_stats.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/parse_error.hpp"
+#include "utcoupe/asserv/serial/parse_parameters.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <variant>
+
+namespace utcoupe::asserv::serial {
+    namespace impl {
+        /**
+         * Deserializes the parameters of an order, whatever the format of its frame.
+         * 
+         * @param serializedOrder The whole message for ASCII frames, or the payload for binary frames.
+         * @param values The tuple to set deserialized values.
+         * @return ParseError::NONE if it succeeded, the reason of the failure else.
+         */
+        template<FrameFormat Format, typename... ArgsT>
+        ParseError deserializeParameters(std::string_view serializedOrder, std::tuple<ArgsT...>& values) noexcept {
+            if constexpr (Format == FrameFormat::ASCII) {
+                // The order character and its separator come first
+                if (serializedOrder.size() < 2) {
+                    return ParseError::MISSING_ARG;
+                }
+                if (serializedOrder[1] != VALUE_SEPARATOR) {
+                    return ParseError::UNKNOWN_ORDER;
+                }
+                return parseAndSetParameters(serializedOrder.substr(2), values);
+            } else {
+                constexpr std::size_t payloadSize = binaryPayloadSize<std::tuple<ArgsT...>>;
+                if (serializedOrder.size() != payloadSize) {
+                    return serializedOrder.size() < payloadSize ? ParseError::MISSING_ARG : ParseError::TRAILING_DATA;
+                }
+                decodeBinaryParameters(serializedOrder, values);
+                return ParseError::NONE;
+            }
+        }
+    } // namespace impl
+    
+    /**
+     * An order whose parameters have been deserialized, but whose callback hasn't been run yet.
+     * 
+     * It is stored inline: the parameters of every order of the table share the same storage.
+     */
+    template<class... OrdersT>
+    struct DecodedOrder {
+        /** Position of the order inside the OrderTable. */
+        std::uint8_t index = impl::NO_ORDER;
+        
+        /** The parameters of the order, whose active alternative is the one at index. */
+        std::variant<typename OrdersT::CallbackArgs...> args;
+    };
+    
+    /** The DecodedOrder type matching an OrderTable type. */
+    template<class TableT>
+    struct DecodedOrderOf;
+    
+    template<class... OrdersT>
+    struct DecodedOrderOf<OrderTable<OrdersT...>> {
+        using type = DecodedOrder<OrdersT...>;
+    };
+    
+    template<class TableT>
+    using DecodedOrderOfT = typename DecodedOrderOf<std::remove_cv_t<TableT>>::type;
+    
+    namespace impl {
+        template<FrameFormat Format, class... OrdersT>
+        using DecoderT = ParseError(*)(std::string_view, DecodedOrder<OrdersT...>&);
+        
+        /** Jump table holding one decoder per order, indexed by the position of the order inside the tuple. The parameters are deserialized straight into the variant. */
+        template<FrameFormat Format, class... OrdersT>
+        inline constexpr auto DECODERS = []<std::size_t... idx>(std::index_sequence<idx...>) {
+            return std::array<DecoderT<Format, OrdersT...>, sizeof...(OrdersT)>{
+                [](std::string_view serializedOrder, DecodedOrder<OrdersT...>& order) -> ParseError {
+                    const ParseError error = deserializeParameters<Format>(serializedOrder, order.args.template emplace<idx>());
+                    order.index = error == ParseError::NONE ? static_cast<std::uint8_t>(idx) : NO_ORDER;
+                    return error;
+                }...
+            };
+        }(std::index_sequence_for<OrdersT...>{});
+        
+        template<FrameFormat Format, class... OrdersT>
+        ParseError decodeOrderAt(std::uint8_t idx, std::string_view serializedOrder, DecodedOrder<OrdersT...>& order) noexcept {
+            if (idx >= sizeof...(OrdersT)) {
+                order.index = NO_ORDER;
+                return ParseError::UNKNOWN_ORDER;
+            }
+            return DECODERS<Format, OrdersT...>[idx](serializedOrder, order);
+        }
+        
+        /** Records an order which couldn't be decoded into orderStats and parseErrors. */
+        inline void recordDecodingFailure(char chOrder, ParseError error) noexcept {
+            orderStats().recordFailure(chOrder);
+            parseErrors().record(error);
+        }
+    } // namespace impl
+    
+    /**
+     * Deserializes an ASCII order into an existing DecodedOrder, e.g. a slot of a queue or of a batch, without running it.
+     * 
+     * @param table The orders to select from, built by makeOrderTable.
+     * @param serializedOrder The message, e.g. "d;1.4;0.8;".
+     * @param order Set to the decoded order. Its index is impl::NO_ORDER on failure.
+     * @return ParseError::NONE if it succeeded, the reason why the order is unknown or malformed else.
+     */
+    template<class... OrdersT>
+    ParseError decodeOrderInto(const OrderTable<OrdersT...>& table, std::string_view serializedOrder, DecodedOrder<OrdersT...>& order) noexcept {
+        if (serializedOrder.empty()) {
+            order.index = impl::NO_ORDER;
+            parseErrors().record(ParseError::UNKNOWN_ORDER);
+            return ParseError::UNKNOWN_ORDER;
+        }
+        const ParseError error = impl::decodeOrderAt<FrameFormat::ASCII>(table.indexOf(serializedOrder.front()), serializedOrder, order);
+        if (error != ParseError::NONE) {
+            impl::recordDecodingFailure(serializedOrder.front(), error);
+        }
+        return error;
+    }
+    
+    /**
+     * Deserializes an already checked binary order into an existing DecodedOrder, without running it.
+     * 
+     * @param table The orders to select from, built by makeOrderTable.
+     * @param frame A frame returned by checkBinaryFrame.
+     * @param order Set to the decoded order. Its index is impl::NO_ORDER on failure.
+     * @return ParseError::NONE if it succeeded, the reason why the order is unknown or its payload size doesn't match else.
+     */
+    template<class... OrdersT>
+    ParseError decodeOrderInto(const OrderTable<OrdersT...>& table, const BinaryFrame& frame, DecodedOrder<OrdersT...>& order) noexcept {
+        const ParseError error = impl::decodeOrderAt<FrameFormat::BINARY>(table.indexOf(frame.chOrder), frame.payload, order);
+        if (error != ParseError::NONE) {
+            impl::recordDecodingFailure(frame.chOrder, error);
+        }
+        return error;
+    }
+    
+    /**
+     * Deserializes an order without running it, see OrderParser::runDecodedOrder.
+     * 
+     * @param table The orders to select from, built by makeOrderTable.
+     * @param frame An ASCII message, e.g. "d;1.4;0.8;", or a BinaryFrame returned by checkBinaryFrame.
+     * @return The decoded order, or the reason why it is unknown or malformed.
+     */
+    template<class... OrdersT, class FrameT>
+    ParseResult<DecodedOrder<OrdersT...>> decodeOrder(const OrderTable<OrdersT...>& table, const FrameT& frame) noexcept {
+        DecodedOrder<OrdersT...> order;
+        if (const ParseError error = decodeOrderInto(table, frame, order); error != ParseError::NONE) {
+            return error;
+        }
+        return order;
+    }
+} // namespace utcoupe::asserv::serial
+
+#endif // UTCOUPE_ASSERV_SERIAL_DECODED_ORDER_HPP
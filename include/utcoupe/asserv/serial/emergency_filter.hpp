@@ -0,0 +1,236 @@
+#ifndef UTCOUPE_ASSERV_SERIAL_EMERGENCY_FILTER_HPP
+#define UTCOUPE_ASSERV_SERIAL_EMERGENCY_FILTER_HPP
+
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/order_stats.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/serial/stream_decoder.hpp"
+
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+
+namespace utcoupe::asserv::serial {
+    /**
+     * Recognizes the emergency orders in the raw byte stream, before any decoding or queueing.
+     * 
+     * It is meant to see every received byte first, from the serial interrupt, and then to let them go through the StreamDecoder as usual. HALT and SET_EMERGENCY_STOP with a non-zero value are detected on the last byte of their frame, whatever the state of the rest of the pipeline: a partial frame in the decoder, a full OrderQueue, or a slow callback. The stop is then requested through a lock-free flag, which the control loop checks with apply at the beginning of each cycle, so it takes effect within one control cycle.
+     * A START, or a SET_EMERGENCY_STOP with a zero value, received after a stop and before apply cancels it: the orders received after the stop may already have been run, e.g. by a callback of the receiving context, and applying the stop after them would undo them. apply should still run before the orders received after the detection, so that the stop isn't delayed behind them.
+     * 
+     * Each byte costs a few comparisons and nothing is copied but the frames starting with an emergency order character, so the filter can run on every byte of the link.
+     * The orders still reach the executor through the normal path, which acknowledges them to the host; both orders are idempotent.
+     * 
+     * With FrameFormat::BINARY, every start byte begins a candidate frame, even inside the payload of another frame, so that a corrupted size never hides an emergency frame. Candidates are validated by their CRC.
+     * 
+     * @tparam Format The encoding of the orders on the link.
+     */
+    template<FrameFormat Format = FrameFormat::ASCII>
+    class EmergencyFilter {
+    public:
+        /**
+         * Scans received bytes for emergency frames. Must only be called by the receiving context.
+         * 
+         * @param chunk The received bytes, as given to StreamDecoder::feed.
+         * @return The number of emergency frames completed by this chunk, the releasing ones excluded.
+         */
+        std::size_t feed(std::string_view chunk) noexcept {
+            std::size_t detected = 0;
+            for (const char byte : chunk) {
+                Stop stop;
+                if constexpr (Format == FrameFormat::ASCII) {
+                    stop = feedAscii(byte);
+                } else {
+                    stop = feedBinary(byte);
+                }
+                if (stop == Stop::HALT || stop == Stop::EMERGENCY_STOP) {
+                    request(stop);
+                    ++detected;
+                } else if (stop != Stop::NONE) {
+                    cancel(stop);
+                }
+            }
+            return detected;
+        }
+        
+        /** True if a stop has been detected and not applied yet. */
+        bool pending() const noexcept {
+            return m_pending.load(std::memory_order_acquire) != 0;
+        }
+        
+        /**
+         * Stops the executor if an emergency frame has been detected since the last call. Must only be called by the context running the orders, e.g. first thing in each control cycle.
+         * 
+         * The delay between the detection and the stop is recorded into orderStats, as the latency of the emergency order.
+         * 
+         * @param executor The executor to stop, through its halt or setEmergencyStop callback.
+         * @return True if the executor has been stopped.
+         */
+        template<class Executor>
+        bool apply(Executor& executor) noexcept {
+            const std::uint8_t stops = m_pending.exchange(0, std::memory_order_acq_rel);
+            if (stops == 0) {
+                return false;
+            }
+            const std::uint32_t detectionTicks = m_detectionTicks.load(std::memory_order_relaxed);
+            if ((stops & HALT_FLAG) != 0) {
+                executor.halt();
+                orderStats().recordRun(static_cast<char>(OrderTypes::HALT), detectionTicks);
+            }
+            if ((stops & EMERGENCY_STOP_FLAG) != 0) {
+                executor.setEmergencyStop(1);
+                orderStats().recordRun(static_cast<char>(OrderTypes::SET_EMERGENCY_STOP), detectionTicks);
+            }
+            return true;
+        }
+        
+        /** Number of emergency frames detected since the creation of the filter. Only written by the receiving context. */
+        std::size_t detectedFrames() const noexcept {
+            return m_detectedFrames.load(std::memory_order_relaxed);
+        }
+        
+    private:
+        enum class Stop : std::uint8_t {
+            NONE,
+            HALT,
+            EMERGENCY_STOP,
+            /** START, cancelling a pending HALT. */
+            START,
+            /** SET_EMERGENCY_STOP with a zero value, cancelling a pending emergency stop. */
+            RELEASE
+        };
+        
+        static constexpr std::uint8_t HALT_FLAG = 1U << 0;
+        static constexpr std::uint8_t EMERGENCY_STOP_FLAG = 1U << 1;
+        
+        static constexpr char HALT_CHAR = static_cast<char>(OrderTypes::HALT);
+        static constexpr char EMERGENCY_STOP_CHAR = static_cast<char>(OrderTypes::SET_EMERGENCY_STOP);
+        static constexpr char START_CHAR = static_cast<char>(OrderTypes::START);
+        
+        /** Size of the payload of SET_EMERGENCY_STOP in a binary frame, see Executor::setEmergencyStop. */
+        static constexpr std::size_t EMERGENCY_STOP_PAYLOAD_SIZE = sizeof(std::int32_t);
+        
+        /** Longest frame kept: the longest emergency frame, e.g. "A;-2147483648;\r" or a binary SET_EMERGENCY_STOP. */
+        static constexpr std::size_t CANDIDATE_SIZE = Format == FrameFormat::ASCII ? 16 : binaryFrameSize(EMERGENCY_STOP_PAYLOAD_SIZE);
+        
+        /** The beginning of the frame being received, if it may be an emergency one. */
+        std::array<char, CANDIDATE_SIZE> m_candidate{};
+        std::size_t m_size = 0;
+        
+        /** ASCII only: true while the bytes of a frame which can't be an emergency one are skipped. */
+        bool m_skipping = false;
+        
+        std::atomic<std::uint8_t> m_pending{ 0 };
+        std::atomic<std::uint32_t> m_detectionTicks{ 0 };
+        // Relaxed, as it is only a statistic read by the control loop while the receiving context writes it
+        std::atomic<std::size_t> m_detectedFrames{ 0 };
+        
+        void request(Stop stop) noexcept {
+            m_detectedFrames.fetch_add(1, std::memory_order_relaxed);
+            if (m_pending.load(std::memory_order_relaxed) == 0) {
+                m_detectionTicks.store(latencyTicks(), std::memory_order_relaxed);
+            }
+            m_pending.fetch_or(stop == Stop::HALT ? HALT_FLAG : EMERGENCY_STOP_FLAG, std::memory_order_release);
+        }
+        
+        void cancel(Stop release) noexcept {
+            m_pending.fetch_and(static_cast<std::uint8_t>(release == Stop::START ? ~HALT_FLAG : ~EMERGENCY_STOP_FLAG), std::memory_order_release);
+        }
+        
+        Stop feedAscii(char byte) noexcept {
+            if (byte == FRAME_TERMINATOR) {
+                const Stop stop = m_skipping ? Stop::NONE : matchAscii(std::string_view{ m_candidate.data(), m_size });
+                m_size = 0;
+                m_skipping = false;
+                return stop;
+            }
+            if (m_skipping) {
+                return Stop::NONE;
+            }
+            if ((m_size == 0 && byte != HALT_CHAR && byte != EMERGENCY_STOP_CHAR && byte != START_CHAR) || m_size == CANDIDATE_SIZE) {
+                m_size = 0;
+                m_skipping = true;
+                return Stop::NONE;
+            }
+            m_candidate[m_size++] = byte;
+            return Stop::NONE;
+        }
+        
+        static Stop matchAscii(std::string_view frame) noexcept {
+            if (!frame.empty() && frame.back() == '\r') {
+                frame.remove_suffix(1);
+            }
+            if (frame == "H;") {
+                return Stop::HALT;
+            }
+            if (frame == "S;") {
+                return Stop::START;
+            }
+            if (frame.size() < 4 || frame[0] != EMERGENCY_STOP_CHAR || frame[1] != ';' || frame.back() != ';') {
+                return Stop::NONE;
+            }
+            std::int32_t enable = 0;
+            const char* last = frame.data() + frame.size() - 1;
+            const auto [end, ec] = std::from_chars(frame.data() + 2, last, enable);
+            if (ec != std::errc{} || end != last) {
+                return Stop::NONE;
+            }
+            return enable != 0 ? Stop::EMERGENCY_STOP : Stop::RELEASE;
+        }
+        
+        Stop feedBinary(char byte) noexcept {
+            if (m_size == 0 && byte != BINARY_FRAME_START) {
+                return Stop::NONE;
+            }
+            m_candidate[m_size++] = byte;
+            
+            // Rejecting a candidate may leave another one, starting inside it, to be checked as well
+            while (m_size >= BINARY_HEADER_SIZE) {
+                const auto payloadSize = static_cast<unsigned char>(m_candidate[2]);
+                const bool emergencyHeader = ((m_candidate[1] == HALT_CHAR || m_candidate[1] == START_CHAR) && payloadSize == 0)
+                    || (m_candidate[1] == EMERGENCY_STOP_CHAR && payloadSize == EMERGENCY_STOP_PAYLOAD_SIZE);
+                if (!emergencyHeader) {
+                    resynchronize();
+                    continue;
+                }
+                if (m_size < binaryFrameSize(payloadSize)) {
+                    return Stop::NONE;
+                }
+                
+                const auto frame = checkBinaryFrame(std::string_view{ m_candidate.data(), m_size });
+                if (!frame) {
+                    resynchronize();
+                    continue;
+                }
+                m_size = 0;
+                if (frame->chOrder != EMERGENCY_STOP_CHAR) {
+                    return frame->chOrder == HALT_CHAR ? Stop::HALT : Stop::START;
+                }
+                std::int32_t enable = 0;
+                impl::loadLittleEndian(frame->payload.data(), enable);
+                return enable != 0 ? Stop::EMERGENCY_STOP : Stop::RELEASE;
+            }
+            return Stop::NONE;
+        }
+        
+        /**
+         * Drops the start byte of the candidate frame and restarts from the next start byte it holds, if any.
+         */
+        void resynchronize() noexcept {
+            std::string_view pending{ m_candidate.data() + 1, m_size - 1 };
+            const std::size_t startPos = pending.find(BINARY_FRAME_START);
+            if (startPos == std::string_view::npos) {
+                m_size = 0;
+                return;
+            }
+            m_size = pending.size() - startPos;
+            std::memmove(m_candidate.data(), pending.data() + startPos, m_size);
+        }
+    };
+} // namespace utcoupe::asserv::serial
+
+#endif // UTCOUPE_ASSERV_SERIAL_EMERGENCY_FILTER_HPP
@@ -0,0 +1,302 @@
+#ifndef UTCOUPE_ASSERV_SERIAL_ORDER_BATCH_HPP
+#define UTCOUPE_ASSERV_SERIAL_ORDER_BATCH_HPP
+
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/decoded_order.hpp"
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_stats.hpp"
+#include "utcoupe/asserv/serial/parse_error.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/serial/traits.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace utcoupe::asserv::serial {
+    /** Character identifying a batch frame, in place of the order character. */
+    inline constexpr char BATCH_FRAME = static_cast<char>(OrderTypes::BATCH);
+    
+    /** Character separating the orders of an ASCII batch frame. */
+    inline constexpr char BATCH_SEPARATOR = '|';
+    
+    /** Size of the header of each order inside a binary batch frame: order character and payload size. */
+    inline constexpr std::size_t BATCH_ENTRY_HEADER_SIZE = 2;
+    
+    /** True if an ASCII frame is a batch frame, to be given to OrderBatch instead of OrderParser. */
+    constexpr bool isBatchFrame(std::string_view frame) noexcept {
+        return frame.size() >= 2 && frame[0] == BATCH_FRAME && frame[1] == ';';
+    }
+    
+    /** True if a binary frame is a batch frame, to be given to OrderBatch instead of OrderParser. */
+    constexpr bool isBatchFrame(const BinaryFrame& frame) noexcept {
+        return frame.chOrder == BATCH_FRAME;
+    }
+    
+    /**
+     * Several orders carried by a single frame, validated as a whole before any of them is run.
+     * 
+     * This lets the host upload a whole path (e.g. CLEAN_GOALS, a series of GOTO and START) with a single frame and a single acknowledgement, instead of one round trip per order:
+     * - ASCII: "B;" followed by the orders separated by '|', e.g. "B;g;|d;100;200;1;|d;300;200;1;|S;". The StreamDecoder buffer must be large enough for the whole batch.
+     * - Binary: a frame whose order character is 'B' and whose payload is the concatenation of the orders, each one being its character, its payload size and its payload. The CRC of the batch frame covers all of them.
+     * 
+     * decode deserializes every order into the batch. If any of them is unknown or malformed, the whole batch is rejected and nothing is run. The batch is then acknowledged once, e.g. by writing a BATCH response holding the number of orders run.
+     * 
+     * @tparam TableT The OrderTable the orders are selected from.
+     * @tparam MaxOrders The maximum number of orders of a batch.
+     */
+    template<class TableT, std::size_t MaxOrders = 16>
+    class OrderBatch {
+    public:
+        using DecodedOrderT = DecodedOrderOfT<TableT>;
+        
+        explicit OrderBatch(const TableT& table) noexcept: m_table(table) {}
+        
+        /**
+         * Deserializes all the orders of an ASCII batch frame, replacing the previous ones.
+         * 
+         * @param frame The frame, e.g. "B;g;|d;100;200;1;|S;".
+         * @return False if the frame isn't a batch, if it has too many orders, or if any of them is unknown or malformed; the batch is then empty and lastError tells why.
+         */
+        bool decode(std::string_view frame) noexcept {
+            m_size = 0;
+            m_lastError = ParseError::NONE;
+            if (!isBatchFrame(frame)) {
+                return reject(ParseError::UNKNOWN_ORDER);
+            }
+            frame.remove_prefix(2);
+            
+            while (!frame.empty()) {
+                const std::size_t separatorPos = frame.find(BATCH_SEPARATOR);
+                const std::string_view order = frame.substr(0, separatorPos);
+                frame.remove_prefix(separatorPos == std::string_view::npos ? frame.size() : separatorPos + 1);
+                
+                // Every order holds at least its character and a separator
+                if (order.size() < 2) {
+                    return reject(ParseError::MISSING_ARG);
+                }
+                if (m_size == MaxOrders) {
+                    return reject(ParseError::OUT_OF_RANGE);
+                }
+                if (const ParseError error = push(order); error != ParseError::NONE) {
+                    return reject(error);
+                }
+            }
+            return m_size > 0 || reject(ParseError::MISSING_ARG);
+        }
+        
+        /**
+         * Deserializes all the orders of a checked binary batch frame, replacing the previous ones.
+         * 
+         * @param frame A frame returned by checkBinaryFrame.
+         * @return False if the frame isn't a batch, if it has too many orders, or if any of them is unknown or malformed; the batch is then empty and lastError tells why.
+         */
+        bool decode(const BinaryFrame& frame) noexcept {
+            m_size = 0;
+            m_lastError = ParseError::NONE;
+            if (!isBatchFrame(frame)) {
+                return reject(ParseError::UNKNOWN_ORDER);
+            }
+            
+            std::string_view payload = frame.payload;
+            while (!payload.empty()) {
+                if (payload.size() < BATCH_ENTRY_HEADER_SIZE) {
+                    return reject(ParseError::MISSING_ARG);
+                }
+                if (m_size == MaxOrders) {
+                    return reject(ParseError::OUT_OF_RANGE);
+                }
+                const std::size_t orderSize = static_cast<unsigned char>(payload[1]);
+                if (orderSize > payload.size() - BATCH_ENTRY_HEADER_SIZE) {
+                    return reject(ParseError::MISSING_ARG);
+                }
+                if (const ParseError error = push(BinaryFrame{ payload[0], payload.substr(BATCH_ENTRY_HEADER_SIZE, orderSize) }); error != ParseError::NONE) {
+                    return reject(error);
+                }
+                payload.remove_prefix(BATCH_ENTRY_HEADER_SIZE + orderSize);
+            }
+            return m_size > 0 || reject(ParseError::MISSING_ARG);
+        }
+        
+        /**
+         * Runs the decoded orders in their batch order, then empties the batch.
+         * 
+         * @param parser The parser whose executor runs the callbacks.
+         * @param onResult Called with the result of each order.
+         * @return The number of orders run.
+         */
+        template<class Executor, class ResultHandler>
+        std::size_t run(OrderParser<Executor>& parser, ResultHandler&& onResult) noexcept {
+            const std::size_t runOrders = m_size;
+            for (std::size_t i = 0; i < runOrders; ++i) {
+                onResult(parser.runDecodedOrder(m_table, std::move(m_orders[i])));
+            }
+            m_size = 0;
+            return runOrders;
+        }
+        
+        /**
+         * Runs the decoded orders in their batch order, ignoring their results, then empties the batch.
+         * 
+         * @return The number of orders run.
+         */
+        template<class Executor>
+        std::size_t run(OrderParser<Executor>& parser) noexcept {
+            return run(parser, [](const auto&) {});
+        }
+        
+        /** Number of orders decoded and not run yet. */
+        std::size_t size() const noexcept {
+            return m_size;
+        }
+        
+        /**
+         * Reason of the rejection of the last decoded frame, e.g. to answer it with ResponseWriter::writeError.
+         * 
+         * @return The error of the first malformed order, OUT_OF_RANGE if the batch has too many orders, or ParseError::NONE if the frame has been accepted.
+         */
+        ParseError lastError() const noexcept {
+            return m_lastError;
+        }
+        
+    private:
+        const TableT& m_table;
+        std::array<DecodedOrderT, MaxOrders> m_orders{};
+        std::size_t m_size = 0;
+        ParseError m_lastError = ParseError::NONE;
+        
+        /** Decodes an order straight into the next slot of the batch, as copying decoded orders costs as much as decoding them. */
+        template<class FrameT>
+        ParseError push(const FrameT& frame) noexcept {
+            const ParseError error = decodeOrderInto(m_table, frame, m_orders[m_size]);
+            if (error == ParseError::NONE) {
+                ++m_size;
+            }
+            return error;
+        }
+        
+        bool reject(ParseError error) noexcept {
+            m_size = 0;
+            m_lastError = error;
+            orderStats().recordFailure(BATCH_FRAME);
+            return false;
+        }
+    };
+    
+    /**
+     * Builds a batch frame on the host side, see OrderBatch.
+     * 
+     * @tparam Format The encoding of the frame.
+     */
+    template<FrameFormat Format = FrameFormat::ASCII>
+    class BatchWriter {
+    public:
+        /**
+         * @param buffer The buffer to write the frame into. For binary frames, it must hold the header and the CRC as well.
+         */
+        explicit BatchWriter(std::span<char> buffer) noexcept: m_buffer(buffer) {
+            if constexpr (Format == FrameFormat::ASCII) {
+                put(BATCH_FRAME);
+                put(';');
+            } else {
+                m_size = BINARY_HEADER_SIZE;
+                m_failed = m_buffer.size() < binaryFrameSize(0);
+            }
+        }
+        
+        /**
+         * Appends an order to the batch.
+         * 
+         * @param chOrder The character identifying the order.
+         * @param values The parameters of the order, whose types must exactly match the callback ones.
+         * @return False if the order doesn't fit, in which case the whole frame is invalid.
+         */
+        template<Deserializable... ArgsT>
+        bool append(char chOrder, ArgsT... values) noexcept {
+            if constexpr (Format == FrameFormat::ASCII) {
+                if (m_orders > 0) {
+                    put(BATCH_SEPARATOR);
+                }
+                put(chOrder);
+                put(';');
+                (appendAscii(values), ...);
+            } else {
+                constexpr std::size_t payloadSize = binaryPayloadSize<std::tuple<ArgsT...>>;
+                if (m_failed || m_size + BATCH_ENTRY_HEADER_SIZE + payloadSize > BINARY_HEADER_SIZE + BINARY_MAX_PAYLOAD_SIZE
+                    || m_size + BATCH_ENTRY_HEADER_SIZE + payloadSize + BINARY_CRC_SIZE > m_buffer.size()) {
+                    m_failed = true;
+                    return false;
+                }
+                m_buffer[m_size++] = chOrder;
+                m_buffer[m_size++] = static_cast<char>(payloadSize);
+                ((impl::storeLittleEndian(m_buffer.data() + m_size, values), m_size += sizeof(ArgsT)), ...);
+            }
+            ++m_orders;
+            return !m_failed;
+        }
+        
+        /**
+         * Ends the frame.
+         * 
+         * @return The whole frame, without the ASCII terminator, or an empty string if it doesn't fit or holds no order.
+         */
+        std::string_view finish() noexcept {
+            if (m_failed || m_orders == 0) {
+                return {};
+            }
+            if constexpr (Format == FrameFormat::BINARY) {
+                m_buffer[0] = BINARY_FRAME_START;
+                m_buffer[1] = BATCH_FRAME;
+                m_buffer[2] = static_cast<char>(m_size - BINARY_HEADER_SIZE);
+                const std::uint16_t crc = crc16(std::string_view{ m_buffer.data(), m_size });
+                impl::storeLittleEndian(m_buffer.data() + m_size, crc);
+                m_size += BINARY_CRC_SIZE;
+            }
+            return { m_buffer.data(), m_size };
+        }
+        
+        /** Number of orders appended. */
+        std::size_t size() const noexcept {
+            return m_orders;
+        }
+        
+    private:
+        std::span<char> m_buffer;
+        std::size_t m_size = 0;
+        std::size_t m_orders = 0;
+        bool m_failed = false;
+        
+        template<Deserializable ValueT>
+        void appendAscii(const ValueT& value) noexcept {
+            if (m_failed) {
+                return;
+            }
+            std::to_chars_result result;
+            if constexpr (FixedPoint<ValueT>) {
+                result = toChars(m_buffer.data() + m_size, m_buffer.data() + m_buffer.size(), value);
+            } else {
+                result = std::to_chars(m_buffer.data() + m_size, m_buffer.data() + m_buffer.size(), value);
+            }
+            if (result.ec != std::errc{}) {
+                m_failed = true;
+                return;
+            }
+            m_size = static_cast<std::size_t>(result.ptr - m_buffer.data());
+            put(';');
+        }
+        
+        void put(char c) noexcept {
+            if (m_failed || m_size >= m_buffer.size()) {
+                m_failed = true;
+                return;
+            }
+            m_buffer[m_size++] = c;
+        }
+    };
+} // namespace utcoupe::asserv::serial
+
+#endif // UTCOUPE_ASSERV_SERIAL_ORDER_BATCH_HPP
@@ -0,0 +1,87 @@
+#ifndef UTCOUPE_ASSERV_SERIAL_ORDER_CLIENT_HPP
+#define UTCOUPE_ASSERV_SERIAL_ORDER_CLIENT_HPP
+
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/serial/response_writer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace utcoupe::asserv::serial {
+    /**
+     * Encodes orders on the host side, with the parameter types of the OrderTable the asserv is built with.
+     * 
+     * Everything is resolved at compile time from the table: sending an order that isn't part of it, or with parameters of the wrong number or types, doesn't compile. Frames are written as the StreamDecoder expects them, several of them can be appended to the same buffer before sending it.
+     * 
+     * @code
+     * constexpr auto allOrders = serial::makeOrderTable(serial::createAllOrders<Executor>());
+     * serial::OrderClient<allOrders> client{buffer};
+     * client.send<serial::OrderTypes::GOTO>({ 100, 200, 1 });
+     * link.write(client.data());
+     * @endcode
+     * 
+     * @tparam Table The OrderTable of the asserv, which must have static storage duration.
+     * @tparam Format The encoding of the frames on the link.
+     */
+    template<const auto& Table, FrameFormat Format = FrameFormat::ASCII>
+    class OrderClient {
+        using TableT = std::remove_cvref_t<decltype(Table)>;
+        
+        template<OrderTypes Type>
+        struct OrderLookup {
+            static constexpr std::uint8_t index = Table.indexOf(static_cast<char>(Type));
+            static_assert(index != impl::NO_ORDER, "This order isn't part of the table.");
+            
+            using type = std::tuple_element_t<index, decltype(TableT::orders)>;
+        };
+        
+    public:
+        /** The Order identified by an order type in the table. */
+        template<OrderTypes Type>
+        using OrderOf = typename OrderLookup<Type>::type;
+        
+        /** The parameters of an order, in the types expected by its callback. */
+        template<OrderTypes Type>
+        using ArgsOf = typename OrderOf<Type>::CallbackArgs;
+        
+        /**
+         * @param buffer The buffer to write the frames into.
+         */
+        explicit OrderClient(std::span<char> buffer) noexcept: m_writer(buffer) {}
+        
+        /**
+         * Appends an order to the buffer.
+         * 
+         * Nothing is written if the frame doesn't fit in the remaining space.
+         * 
+         * @tparam Type The order to send, which must be part of the table.
+         * @param values The parameters of the order.
+         * @return True if the frame has been written, false else.
+         */
+        template<OrderTypes Type>
+        bool send(const ArgsOf<Type>& values = {}) noexcept {
+            return m_writer.write(static_cast<char>(Type), values);
+        }
+        
+        /** All the frames written since the construction or the last clear. */
+        std::string_view data() const noexcept {
+            return m_writer.data();
+        }
+        
+        /** Empties the buffer, e.g. once its frames have been sent. */
+        void clear() noexcept {
+            m_writer.clear();
+        }
+        
+    private:
+        ResponseWriter<Format> m_writer;
+    };
+} // namespace utcoupe::asserv::serial
+
+#endif // UTCOUPE_ASSERV_SERIAL_ORDER_CLIENT_HPP
@@ -1,11 +1,18 @@
 #ifndef UTCOUPE_ASSERV_SERIAL_ORDER_PARSER_HPP
 #define UTCOUPE_ASSERV_SERIAL_ORDER_PARSER_HPP
 
-#include "utcoupe/asserv/serial/parse_parameters.hpp"
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/decoded_order.hpp"
+#include "utcoupe/asserv/serial/order.hpp"
+#include "utcoupe/asserv/serial/order_stats.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/parse_error.hpp"
 
+#include <array>
 #include <optional>
 #include <string_view>
 #include <tuple>
+#include <utility>
 
 namespace utcoupe::asserv::serial {
     template<class Executor>
@@ -13,41 +20,180 @@ namespace utcoupe::asserv::serial {
     public:
         OrderParser(Executor& executor): m_executor(executor) {}
         
+        /**
+         * Parses an order and runs its callback, selecting the order through the table in constant time.
+         * 
+         * @param table The orders to select from, built by makeOrderTable.
+         * @param serializedOrder The message, e.g. "d;1.4;0.8;".
+         * @return The value returned by the callback, or std::nullopt if the order is unknown or malformed, see lastError.
+         */
+        template<class... OrdersT>
+        constexpr std::optional<typename Executor::OrderReturnT> parseAndRunOrder(const OrderTable<OrdersT...>& table, std::string_view serializedOrder) noexcept {
+            if (serializedOrder.empty()) {
+                return reject(ParseError::UNKNOWN_ORDER);
+            }
+            return runOrderAt<FrameFormat::ASCII>(table.indexOf(serializedOrder.front()), serializedOrder.front(), serializedOrder, table.orders);
+        }
+        
+        /**
+         * Checks a binary frame and runs the callback of its order.
+         * 
+         * @param table The orders to select from, built by makeOrderTable.
+         * @param frame A whole binary frame, see encodeBinaryFrame.
+         * @return The value returned by the callback, or std::nullopt if the order is unknown or the frame is corrupted.
+         */
+        template<class... OrdersT>
+        std::optional<typename Executor::OrderReturnT> parseAndRunBinaryOrder(const OrderTable<OrdersT...>& table, std::string_view frame) noexcept {
+            auto binaryFrame = checkBinaryFrame(frame);
+            if (!binaryFrame) {
+                return reject(ParseError::BAD_CHECKSUM);
+            }
+            return parseAndRunOrder(table, *binaryFrame);
+        }
+        
+        /**
+         * Runs the callback of the order carried by an already checked binary frame.
+         * 
+         * @param table The orders to select from, built by makeOrderTable.
+         * @param frame A frame returned by checkBinaryFrame.
+         * @return The value returned by the callback, or std::nullopt if the order is unknown or its payload size doesn't match.
+         */
+        template<class... OrdersT>
+        std::optional<typename Executor::OrderReturnT> parseAndRunOrder(const OrderTable<OrdersT...>& table, const BinaryFrame& frame) noexcept {
+            return runOrderAt<FrameFormat::BINARY>(table.indexOf(frame.chOrder), frame.chOrder, frame.payload, table.orders);
+        }
+        
+        /**
+         * Runs the callback of an order deserialized beforehand by decodeOrder.
+         * 
+         * @param table The table the order has been decoded with.
+         * @param order The decoded order.
+         * @return The value returned by the callback, or std::nullopt if the order doesn't belong to the table.
+         */
+        template<class... OrdersT>
+        std::optional<typename Executor::OrderReturnT> runDecodedOrder(const OrderTable<OrdersT...>& table, DecodedOrder<OrdersT...>&& order) noexcept {
+            if (order.index >= sizeof...(OrdersT) || order.index != order.args.index()) {
+                return reject(ParseError::UNKNOWN_ORDER);
+            }
+            m_lastError = ParseError::NONE;
+            return s_decodedRunners<OrdersT...>[order.index](*this, std::move(order), table.orders);
+        }
+        
+        /**
+         * Parses an order and runs its callback, searching the order linearly in the tuple.
+         * 
+         * Prefer the OrderTable overload when the orders are known at compile time.
+         * 
+         * @param orders The orders to select from.
+         * @param serializedOrder The message, e.g. "d;1.4;0.8;".
+         * @return The value returned by the callback, or std::nullopt if the order is unknown or malformed, see lastError.
+         */
         template<class... OrdersT>
         constexpr std::optional<typename Executor::OrderReturnT> parseAndRunOrder(const std::tuple<OrdersT...>& orders, std::string_view serializedOrder) noexcept {
-            return selectAndRunOrder<0>(serializedOrder, orders);
+            if (serializedOrder.empty()) {
+                return reject(ParseError::UNKNOWN_ORDER);
+            }
+            return runOrderAt<FrameFormat::ASCII>(findOrderIndex(orders, serializedOrder.front()), serializedOrder.front(), serializedOrder, orders);
+        }
+        
+        /**
+         * The reason why the last order given to the parser hasn't been run, e.g. to answer with ResponseWriter::writeError so that the host sends it again.
+         * 
+         * @return ParseError::NONE if its callback has been run.
+         */
+        constexpr ParseError lastError() const noexcept {
+            return m_lastError;
         }
         
     private:
+        using ResultT = std::optional<typename Executor::OrderReturnT>;
+        
+        template<class... OrdersT>
+        using RunnerT = ResultT(*)(OrderParser&, std::string_view, const std::tuple<OrdersT...>&);
+        
         Executor& m_executor;
+        ParseError m_lastError = ParseError::NONE;
+        
+        /** Records an order which can't be run into parseErrors, see lastError. */
+        constexpr ResultT reject(ParseError error) noexcept {
+            m_lastError = error;
+            parseErrors().record(error);
+            return std::nullopt;
+        }
+        
+        template<class... OrdersT>
+        static constexpr std::uint8_t findOrderIndex(const std::tuple<OrdersT...>& orders, char chOrder) noexcept {
+            return [&orders, chOrder]<std::size_t... idx>(std::index_sequence<idx...>) {
+                std::uint8_t found = impl::NO_ORDER;
+                static_cast<void>(((std::get<idx>(orders).ch_order == chOrder ? (found = static_cast<std::uint8_t>(idx), true) : false) || ...));
+                return found;
+            }(std::index_sequence_for<OrdersT...>{});
+        }
+        
+        /**
+         * Jump table holding one runner per order, indexed by the position of the order inside the tuple.
+         */
+        template<FrameFormat Format, class... OrdersT>
+        static constexpr auto makeRunners() noexcept {
+            return []<std::size_t... idx>(std::index_sequence<idx...>) {
+                return std::array<RunnerT<OrdersT...>, sizeof...(OrdersT)>{
+                    [](OrderParser& parser, std::string_view serializedOrder, const std::tuple<OrdersT...>& orders) -> ResultT {
+                        return parser.template runOrder<Format>(serializedOrder, std::get<idx>(orders));
+                    }...
+                };
+            }(std::index_sequence_for<OrdersT...>{});
+        }
+        
+        template<FrameFormat Format, class... OrdersT>
+        static constexpr std::array<RunnerT<OrdersT...>, sizeof...(OrdersT)> s_runners = makeRunners<Format, OrdersT...>();
+        
+        template<class... OrdersT>
+        using DecodedRunnerT = ResultT(*)(OrderParser&, DecodedOrder<OrdersT...>&&, const std::tuple<OrdersT...>&);
+        
+        template<class... OrdersT>
+        static constexpr auto s_decodedRunners = []<std::size_t... idx>(std::index_sequence<idx...>) {
+            return std::array<DecodedRunnerT<OrdersT...>, sizeof...(OrdersT)>{
+                [](OrderParser& parser, DecodedOrder<OrdersT...>&& order, const std::tuple<OrdersT...>& orders) -> ResultT {
+                    const std::uint32_t startTicks = impl::startOrderTrace();
+                    auto result = executeOrder(parser.m_executor, std::get<idx>(orders), std::get<idx>(std::move(order.args)));
+                    orderStats().recordRun(std::get<idx>(orders).ch_order, startTicks);
+                    return result;
+                }...
+            };
+        }(std::index_sequence_for<OrdersT...>{});
         
-        template<std::size_t idx, class... OrdersT>
-        constexpr std::optional<typename Executor::OrderReturnT> selectAndRunOrder(std::string_view serializedOrder, const std::tuple<OrdersT...>& orders) noexcept {
-            if constexpr (idx >= std::tuple_size<typename std::tuple<OrdersT...>>::value) {
-                return std::nullopt;
-            } else {
-                auto& order = std::get<idx>(orders);
-                if (order.ch_order == serializedOrder.at(0)) {
-                    return runOrder(serializedOrder, order);
-                } else {
-                    return selectAndRunOrder<idx+1, OrdersT...>(serializedOrder, orders);
-                }
+        template<FrameFormat Format, class... OrdersT>
+        constexpr ResultT runOrderAt(std::uint8_t idx, char chOrder, std::string_view serializedOrder, const std::tuple<OrdersT...>& orders) noexcept {
+            if (idx >= sizeof...(OrdersT)) {
+                orderStats().recordFailure(chOrder);
+                return reject(ParseError::UNKNOWN_ORDER);
             }
+            return s_runners<Format, OrdersT...>[idx](*this, serializedOrder, orders);
         }
         
-        template<class OrderT>
+        /**
+         * Deserializes the parameters of an order and runs its callback.
+         * 
+         * Both steps are timed into orderStats when ORDER_STATS_ENABLED.
+         * 
+         * @param serializedOrder The whole message for ASCII frames, or the payload for binary frames.
+         * @param order The Order to run.
+         */
+        template<FrameFormat Format, class OrderT>
         std::optional<typename Executor::OrderReturnT> runOrder(std::string_view serializedOrder, OrderT& order) {
+            const std::uint32_t startTicks = impl::startOrderTrace();
             typename OrderT::CallbackArgs values;
-            bool success = parseAndSetParameters(
-                serializedOrder.substr(2, serializedOrder.size()),
-                values
-            );
+            const ParseError error = impl::deserializeParameters<Format>(serializedOrder, values);
             
-            if (!success) {
-                return std::nullopt;
+            if (error != ParseError::NONE) {
+                orderStats().recordFailure(order.ch_order);
+                return reject(error);
             }
             
-            return executeOrder(m_executor, order, std::move(values));
+            m_lastError = ParseError::NONE;
+            auto result = executeOrder(m_executor, order, std::move(values));
+            orderStats().recordRun(order.ch_order, startTicks);
+            return result;
         }
         
     };
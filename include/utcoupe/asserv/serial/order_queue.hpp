@@ -0,0 +1,94 @@
+#ifndef UTCOUPE_ASSERV_SERIAL_ORDER_QUEUE_HPP
+#define UTCOUPE_ASSERV_SERIAL_ORDER_QUEUE_HPP
+
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/decoded_order.hpp"
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/spsc_queue.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <string_view>
+
+namespace utcoupe::asserv::serial {
+    /**
+     * Decouples the reception of orders from their execution.
+     * 
+     * Frames are deserialized as soon as they are received (typically from the serial interrupt, through StreamDecoder::feedFrames) and stored in a wait-free single-producer/single-consumer queue. Their callbacks are only run when the control loop calls runPending, at a deterministic point of its cycle, so a slow callback never blocks the reception and never races with the control loop.
+     * 
+     * @tparam TableT The OrderTable the orders are selected from.
+     * @tparam Capacity The maximum number of pending orders, which must be a power of two.
+     */
+    template<class TableT, std::size_t Capacity = 16>
+    class OrderQueue {
+    public:
+        using DecodedOrderT = DecodedOrderOfT<TableT>;
+        
+        explicit OrderQueue(const TableT& table) noexcept: m_table(table) {}
+        
+        /**
+         * Decodes a frame and queues its order. Must only be called by the producer.
+         * 
+         * @param frame An ASCII frame, or a BinaryFrame checked by checkBinaryFrame.
+         * @return False if the order is unknown, malformed, or if the queue is full.
+         */
+        template<class FrameT>
+        bool push(const FrameT& frame) noexcept {
+            auto order = decodeOrder(m_table, frame);
+            if (!order) {
+                m_rejectedOrders.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (!m_orders.push(std::move(*order))) {
+                m_overflowedOrders.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            return true;
+        }
+        
+        /**
+         * Runs the callbacks of the pending orders, in their reception order. Must only be called by the consumer.
+         * 
+         * @param parser The parser whose executor runs the callbacks.
+         * @param onResult Called with the result of each order.
+         * @param maxOrders The maximum number of orders to run, to bound the time spent in a control cycle.
+         * @return The number of orders run.
+         */
+        template<class Executor, class ResultHandler>
+        std::size_t runPending(OrderParser<Executor>& parser, ResultHandler&& onResult, std::size_t maxOrders = Capacity) noexcept {
+            std::size_t runOrders = 0;
+            for (; runOrders < maxOrders; ++runOrders) {
+                auto order = m_orders.pop();
+                if (!order) {
+                    break;
+                }
+                onResult(parser.runDecodedOrder(m_table, std::move(*order)));
+            }
+            return runOrders;
+        }
+        
+        /** Number of orders waiting to be run. */
+        std::size_t size() const noexcept {
+            return m_orders.size();
+        }
+        
+        /** Number of frames that couldn't be decoded. Only written by the producer, and readable from any context. */
+        std::size_t rejectedOrders() const noexcept {
+            return m_rejectedOrders.load(std::memory_order_relaxed);
+        }
+        
+        /** Number of orders lost because the queue was full. Only written by the producer, and readable from any context. */
+        std::size_t overflowedOrders() const noexcept {
+            return m_overflowedOrders.load(std::memory_order_relaxed);
+        }
+        
+    private:
+        const TableT& m_table;
+        SpscQueue<DecodedOrderT, Capacity> m_orders;
+        // Relaxed atomics, as they are read by the consumer while the producer writes them
+        std::atomic<std::size_t> m_rejectedOrders{ 0 };
+        std::atomic<std::size_t> m_overflowedOrders{ 0 };
+    };
+} // namespace utcoupe::asserv::serial
+
+#endif // UTCOUPE_ASSERV_SERIAL_ORDER_QUEUE_HPP
@@ -0,0 +1,204 @@
+#ifndef UTCOUPE_ASSERV_SERIAL_ORDER_ROUTER_HPP
+#define UTCOUPE_ASSERV_SERIAL_ORDER_ROUTER_HPP
+
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/decoded_order.hpp"
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/spsc_queue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <tuple>
+#include <utility>
+
+namespace utcoupe::asserv::serial {
+    /** True for the orders that jump ahead of every queued order, whatever the link they come from. */
+    constexpr bool isUrgentOrder(char chOrder) noexcept {
+        return chOrder == static_cast<char>(OrderTypes::HALT) || chOrder == static_cast<char>(OrderTypes::SET_EMERGENCY_STOP);
+    }
+    
+    /** True for the urgent orders that also discard the orders received before them, e.g. the moves a HALT stops. */
+    constexpr bool isPreemptingOrder(char chOrder) noexcept {
+        return chOrder == static_cast<char>(OrderTypes::HALT);
+    }
+    
+    /**
+     * Serves several hosts on separate links with a single executor, e.g. the main computer and a debug tool.
+     * 
+     * Each link has its own pair of wait-free queues, filled by its own producer (typically its serial interrupt, through StreamDecoder::feedFrames), so the links never contend with each other. The control loop runs the pending orders with runPending:
+     * - Urgent orders (see isUrgentOrder) are run first, from every link, and aren't limited by maxOrders: they wait at most one control cycle no matter the load.
+     * - A preempting order (see isPreemptingOrder) discards the orders received before it on every link, so a HALT isn't followed by the moves it was meant to stop.
+     * - The other orders are run link by link, the highest priority first, links of equal priority in their index order.
+     * 
+     * Each result is given back along with the index of the link it came from, so that the answer goes to the host that sent the order.
+     * 
+     * @tparam TableT The OrderTable the orders are selected from.
+     * @tparam LinkCount The number of links.
+     * @tparam Capacity The maximum number of pending orders of a link, which must be a power of two.
+     * @tparam UrgentCapacity The maximum number of pending urgent orders of a link, which must be a power of two.
+     */
+    template<class TableT, std::size_t LinkCount, std::size_t Capacity = 16, std::size_t UrgentCapacity = 4>
+    class OrderRouter {
+    public:
+        using DecodedOrderT = DecodedOrderOfT<TableT>;
+        
+        /**
+         * @param table The orders to select from.
+         * @param priorities The priority of each link, higher being served first.
+         */
+        explicit OrderRouter(const TableT& table, const std::array<std::uint8_t, LinkCount>& priorities = {}) noexcept: m_table(table) {
+            m_orderChars = std::apply([](const auto&... order) { return std::array<char, sizeof...(order)>{ order.ch_order... }; }, table.orders);
+            for (std::size_t link = 0; link < LinkCount; ++link) {
+                m_links[link].priority = priorities[link];
+            }
+            std::iota(m_servingOrder.begin(), m_servingOrder.end(), std::size_t{ 0 });
+            std::stable_sort(m_servingOrder.begin(), m_servingOrder.end(), [&priorities](std::size_t lhs, std::size_t rhs) {
+                return priorities[lhs] > priorities[rhs];
+            });
+        }
+        
+        /**
+         * Decodes a frame received on a link and queues its order. Must only be called by the producer of this link.
+         * 
+         * @param link The index of the link the frame has been received on.
+         * @param frame An ASCII frame, or a BinaryFrame checked by checkBinaryFrame.
+         * @return False if the order is unknown, malformed, or if the queue of the link is full.
+         */
+        template<class FrameT>
+        bool push(std::size_t link, const FrameT& frame) noexcept {
+            Link& source = m_links[link];
+            auto order = decodeOrder(m_table, frame);
+            if (!order) {
+                source.rejectedOrders.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            
+            RoutedOrder routed{ std::move(*order), m_sequence.fetch_add(1, std::memory_order_relaxed) };
+            const bool queued = isUrgentOrder(m_orderChars[routed.order.index])
+                ? source.urgentOrders.push(std::move(routed))
+                : source.orders.push(std::move(routed));
+            if (!queued) {
+                source.overflowedOrders.fetch_add(1, std::memory_order_relaxed);
+            }
+            return queued;
+        }
+        
+        /**
+         * Runs the pending orders of every link. Must only be called by the consumer.
+         * 
+         * @param parser The parser whose executor runs the callbacks.
+         * @param onResult Called with the index of the link, the character of the order and its result, e.g. to write the answer with the ResponseWriter of this link.
+         * @param maxOrders The maximum number of non-urgent orders to run, to bound the time spent in a control cycle.
+         * @return The number of orders run, urgent ones included.
+         */
+        template<class Executor, class ResultHandler>
+        std::size_t runPending(OrderParser<Executor>& parser, ResultHandler&& onResult, std::size_t maxOrders = Capacity) noexcept {
+            std::size_t runOrders = 0;
+            for (const std::size_t link : m_servingOrder) {
+                while (auto routed = m_links[link].urgentOrders.pop()) {
+                    if (isPreemptingOrder(m_orderChars[routed->order.index])) {
+                        preemptOrdersBefore(routed->sequence);
+                    }
+                    run(parser, link, std::move(routed->order), onResult);
+                    ++runOrders;
+                }
+            }
+            
+            std::size_t budget = maxOrders;
+            for (const std::size_t link : m_servingOrder) {
+                for (; budget > 0; --budget) {
+                    auto routed = m_links[link].orders.pop();
+                    if (!routed) {
+                        break;
+                    }
+                    run(parser, link, std::move(routed->order), onResult);
+                    ++runOrders;
+                }
+            }
+            return runOrders;
+        }
+        
+        /** Number of orders of a link waiting to be run, urgent ones included. */
+        std::size_t size(std::size_t link) const noexcept {
+            return m_links[link].orders.size() + m_links[link].urgentOrders.size();
+        }
+        
+        /** Priority of a link, given at construction. */
+        std::uint8_t priority(std::size_t link) const noexcept {
+            return m_links[link].priority;
+        }
+        
+        /** Number of frames of a link that couldn't be decoded. Only written by the producer of this link, and readable from any context. */
+        std::size_t rejectedOrders(std::size_t link) const noexcept {
+            return m_links[link].rejectedOrders.load(std::memory_order_relaxed);
+        }
+        
+        /** Number of orders of a link lost because its queue was full. Only written by the producer of this link, and readable from any context. */
+        std::size_t overflowedOrders(std::size_t link) const noexcept {
+            return m_links[link].overflowedOrders.load(std::memory_order_relaxed);
+        }
+        
+        /** Number of orders discarded by preempting orders. Only written by the consumer. */
+        std::size_t preemptedOrders() const noexcept {
+            return m_preemptedOrders;
+        }
+        
+    private:
+        /** A decoded order, along with its reception rank among every link. */
+        struct RoutedOrder {
+            DecodedOrderT order;
+            std::uint32_t sequence = 0;
+        };
+        
+        struct Link {
+            SpscQueue<RoutedOrder, Capacity> orders;
+            SpscQueue<RoutedOrder, UrgentCapacity> urgentOrders;
+            std::uint8_t priority = 0;
+            // Relaxed atomics, as they are read by the consumer or the host while the producer writes them
+            std::atomic<std::size_t> rejectedOrders{ 0 };
+            std::atomic<std::size_t> overflowedOrders{ 0 };
+        };
+        
+        const TableT& m_table;
+        
+        /** The character of each order of the table, indexed like the table. */
+        std::array<char, std::tuple_size_v<decltype(TableT::orders)>> m_orderChars{};
+        
+        std::array<Link, LinkCount> m_links;
+        
+        /** The link indices, sorted by decreasing priority. */
+        std::array<std::size_t, LinkCount> m_servingOrder{};
+        
+        /** Rank of the next received order, shared by every producer. */
+        std::atomic<std::uint32_t> m_sequence{ 0 };
+        
+        std::size_t m_preemptedOrders = 0;
+        
+        /**
+         * Discards the non-urgent orders received before a given rank.
+         * 
+         * Ranks are compared through their difference, so that they can wrap around.
+         */
+        void preemptOrdersBefore(std::uint32_t sequence) noexcept {
+            for (Link& link : m_links) {
+                for (const RoutedOrder* front = link.orders.front(); front != nullptr && static_cast<std::int32_t>(front->sequence - sequence) < 0; front = link.orders.front()) {
+                    link.orders.pop();
+                    ++m_preemptedOrders;
+                }
+            }
+        }
+        
+        template<class Executor, class ResultHandler>
+        void run(OrderParser<Executor>& parser, std::size_t link, DecodedOrderT&& order, ResultHandler& onResult) noexcept {
+            const char chOrder = m_orderChars[order.index];
+            onResult(link, chOrder, parser.runDecodedOrder(m_table, std::move(order)));
+        }
+    };
+} // namespace utcoupe::asserv::serial
+
+#endif // UTCOUPE_ASSERV_SERIAL_ORDER_ROUTER_HPP
@@ -0,0 +1,182 @@
+#ifndef UTCOUPE_ASSERV_SERIAL_ORDER_STATS_HPP
+#define UTCOUPE_ASSERV_SERIAL_ORDER_STATS_HPP
+
+#include "utcoupe/asserv/serial/order_table.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+
+#ifdef UTCOUPE_ASSERV_CYCLE_COUNTER
+/**
+ * Returns the current value of a free-running cycle counter, e.g. DWT->CYCCNT on Cortex-M.
+ * 
+ * Provided by the firmware when UTCOUPE_ASSERV_CYCLE_COUNTER is defined.
+ */
+extern "C" std::uint32_t utcoupe_asserv_cycle_count() noexcept;
+#endif
+
+namespace utcoupe::asserv::serial {
+    /**
+     * True if the latencies of the orders are recorded, see OrderStats.
+     * 
+     * Enabled by defining UTCOUPE_ASSERV_ORDER_STATS (ENABLE_ORDER_STATS CMake option). When disabled, the recording compiles to nothing and the stats take no memory.
+     */
+#ifdef UTCOUPE_ASSERV_ORDER_STATS
+    inline constexpr bool ORDER_STATS_ENABLED = true;
+#else
+    inline constexpr bool ORDER_STATS_ENABLED = false;
+#endif
+
+    /** Number of buckets of the latency histogram, one per bit of a tick count. */
+    inline constexpr std::size_t LATENCY_BUCKETS = std::numeric_limits<std::uint32_t>::digits + 1;
+    
+    /**
+     * Reads the clock the latencies are measured with.
+     * 
+     * @return CPU cycles if the firmware provides a cycle counter, nanoseconds otherwise. Wraps around.
+     */
+    inline std::uint32_t latencyTicks() noexcept {
+#ifdef UTCOUPE_ASSERV_CYCLE_COUNTER
+        return utcoupe_asserv_cycle_count();
+#else
+        const auto elapsed = std::chrono::steady_clock::now().time_since_epoch();
+        return static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+#endif
+    }
+    
+    /** Latency summary of one order type, as sent back by the DIAGNOSTICS order. */
+    struct LatencySummary {
+        /** Number of times the order has been run. */
+        std::uint32_t count = 0;
+        
+        /** Number of times the order has been received but couldn't be parsed. */
+        std::uint32_t failures = 0;
+        
+        std::uint32_t minTicks = 0;
+        std::uint32_t maxTicks = 0;
+        std::uint32_t meanTicks = 0;
+        
+        /** The fields in the order they are written in responses. */
+        constexpr auto asTuple() const noexcept {
+            return std::tuple{ count, failures, minTicks, maxTicks, meanTicks };
+        }
+    };
+    
+    /**
+     * Latency statistics of the orders, from their reception to the return of their callback.
+     * 
+     * Each order character has its own counters, and a histogram gathers the latencies of all the orders by powers of two: bucket i counts latencies in [2^(i-1), 2^i) ticks.
+     * Runs are recorded by the context running the orders only, so they aren't synchronized. Failures are also recorded where the orders are decoded, e.g. by OrderQueue::push from the serial interrupt, so they are counted with relaxed atomics.
+     */
+    class OrderStats {
+    public:
+        /** Records an order which has been run, see latencyTicks. */
+        void recordRun(char chOrder, std::uint32_t startTicks) noexcept {
+            if constexpr (ORDER_STATS_ENABLED) {
+                const std::uint32_t ticks = latencyTicks() - startTicks;
+                Counters& counters = m_counters[impl::dispatchIndex(chOrder)];
+                counters.minTicks = counters.count == 0 ? ticks : std::min(counters.minTicks, ticks);
+                counters.maxTicks = std::max(counters.maxTicks, ticks);
+                counters.totalTicks += ticks;
+                ++counters.count;
+                ++m_histogram[static_cast<std::size_t>(std::bit_width(ticks))];
+            }
+        }
+        
+        /** Records an order which is unknown or couldn't be parsed. */
+        void recordFailure(char chOrder) noexcept {
+            if constexpr (ORDER_STATS_ENABLED) {
+                m_failures[impl::dispatchIndex(chOrder)].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        
+        /** Summary of one order type. */
+        LatencySummary summary(char chOrder) const noexcept {
+            if constexpr (ORDER_STATS_ENABLED) {
+                const std::size_t index = impl::dispatchIndex(chOrder);
+                return summarize(m_counters[index], m_failures[index].load(std::memory_order_relaxed));
+            } else {
+                return {};
+            }
+        }
+        
+        /** Summary of all the order types together. */
+        LatencySummary total() const noexcept {
+            Counters all;
+            std::uint32_t failures = 0;
+            for (const auto& orderFailures : m_failures) {
+                failures += orderFailures.load(std::memory_order_relaxed);
+            }
+            for (const Counters& counters : m_counters) {
+                if (counters.count != 0) {
+                    all.minTicks = all.count == 0 ? counters.minTicks : std::min(all.minTicks, counters.minTicks);
+                }
+                all.maxTicks = std::max(all.maxTicks, counters.maxTicks);
+                all.totalTicks += counters.totalTicks;
+                all.count += counters.count;
+            }
+            return summarize(all, failures);
+        }
+        
+        /** Number of orders whose latency falls into a bucket, see LATENCY_BUCKETS. */
+        std::uint32_t histogram(std::size_t bucket) const noexcept {
+            return bucket < m_histogram.size() ? m_histogram[bucket] : 0;
+        }
+        
+        void reset() noexcept {
+            m_counters = {};
+            m_histogram = {};
+            for (auto& failures : m_failures) {
+                failures.store(0, std::memory_order_relaxed);
+            }
+        }
+        
+    private:
+        struct Counters {
+            std::uint32_t count = 0;
+            std::uint32_t minTicks = 0;
+            std::uint32_t maxTicks = 0;
+            std::uint64_t totalTicks = 0;
+        };
+        
+        std::array<Counters, ORDER_STATS_ENABLED ? impl::DISPATCH_TABLE_SIZE : 0> m_counters{};
+        std::array<std::uint32_t, ORDER_STATS_ENABLED ? LATENCY_BUCKETS : 0> m_histogram{};
+        std::array<std::atomic<std::uint32_t>, ORDER_STATS_ENABLED ? impl::DISPATCH_TABLE_SIZE : 0> m_failures{};
+        
+        static LatencySummary summarize(const Counters& counters, std::uint32_t failures) noexcept {
+            return {
+                counters.count,
+                failures,
+                counters.minTicks,
+                counters.maxTicks,
+                counters.count == 0 ? 0 : static_cast<std::uint32_t>(counters.totalTicks / counters.count)
+            };
+        }
+    };
+    
+    /** The statistics recorded by every OrderParser. */
+    inline OrderStats& orderStats() noexcept {
+        static OrderStats stats;
+        return stats;
+    }
+    
+    namespace impl {
+        /** Reads the clock to time an order, or does nothing if the stats are disabled. */
+        inline std::uint32_t startOrderTrace() noexcept {
+            if constexpr (ORDER_STATS_ENABLED) {
+                return latencyTicks();
+            } else {
+                return 0;
+            }
+        }
+    } // namespace impl
+} // namespace utcoupe::asserv::serial
+
+#endif // UTCOUPE_ASSERV_SERIAL_ORDER_STATS_HPP
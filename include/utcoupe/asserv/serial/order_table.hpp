@@ -0,0 +1,112 @@
+#ifndef UTCOUPE_ASSERV_SERIAL_ORDER_TABLE_HPP
+#define UTCOUPE_ASSERV_SERIAL_ORDER_TABLE_HPP
+
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+namespace utcoupe::asserv::serial {
+    namespace impl {
+        /** Index stored in the dispatch table for the characters that aren't bound to any order. */
+        inline constexpr std::uint8_t NO_ORDER = UINT8_MAX;
+        
+        /** Number of entries of a dispatch table, one per possible char value. */
+        inline constexpr std::size_t DISPATCH_TABLE_SIZE = 1U << CHAR_BIT;
+        
+        /**
+         * Converts an order character into its dispatch table index.
+         * 
+         * Goes through unsigned char so that negative chars don't index outside the table.
+         */
+        constexpr std::size_t dispatchIndex(char chOrder) noexcept {
+            return static_cast<unsigned char>(chOrder);
+        }
+        
+        /**
+         * Intentionally not constexpr: reaching it while evaluating makeOrderTable stops the compilation.
+         */
+        inline void orderCharacterIsDuplicated() noexcept {}
+    } // namespace impl
+    
+    /**
+     * Checks that no two orders of the tuple share the same identifying character.
+     * 
+     * @param orders A tuple of Order.
+     * @return True if all the characters are distinct, false else.
+     */
+    template<class... OrdersT>
+    constexpr bool hasUniqueOrderChars(const std::tuple<OrdersT...>& orders) noexcept {
+        const std::array<char, sizeof...(OrdersT)> chars = std::apply(
+            [](const auto&... order) {
+                return std::array<char, sizeof...(OrdersT)>{ order.ch_order... };
+            },
+            orders
+        );
+        
+        for (std::size_t i = 0; i < chars.size(); ++i) {
+            for (std::size_t j = i + 1; j < chars.size(); ++j) {
+                if (chars[i] == chars[j]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    
+    /**
+     * A set of orders along with a dispatch table mapping each character to the position of its order in the tuple.
+     * 
+     * It must be built at compile time through makeOrderTable, so that selecting an order is a single array lookup no matter how many orders are registered.
+     */
+    template<class... OrdersT>
+    struct OrderTable {
+        static_assert(sizeof...(OrdersT) < impl::NO_ORDER, "Too many orders for a single dispatch table.");
+        
+        /** All the orders of the table, in their registration order. */
+        std::tuple<OrdersT...> orders;
+        
+        /** Position inside orders of the order identified by each character, or impl::NO_ORDER. */
+        std::array<std::uint8_t, impl::DISPATCH_TABLE_SIZE> indices;
+        
+        /**
+         * Finds the position of the order identified by a character.
+         * 
+         * @param chOrder The character identifying the order.
+         * @return The position of the order inside the tuple, or impl::NO_ORDER if the character is unknown.
+         */
+        constexpr std::uint8_t indexOf(char chOrder) const noexcept {
+            return indices[impl::dispatchIndex(chOrder)];
+        }
+    };
+    
+    /**
+     * Builds the dispatch table of a set of orders at compile time.
+     * 
+     * Fails to compile if two orders share the same character.
+     * 
+     * @param orders A tuple of Order, e.g. the one returned by createAllOrders.
+     * @return An OrderTable to give to OrderParser::parseAndRunOrder.
+     */
+    template<class... OrdersT>
+    consteval OrderTable<OrdersT...> makeOrderTable(const std::tuple<OrdersT...>& orders) noexcept {
+        OrderTable<OrdersT...> table{ orders, {} };
+        table.indices.fill(impl::NO_ORDER);
+        
+        [&table]<std::size_t... idx>(std::index_sequence<idx...>) {
+            auto registerOrder = [&table](char chOrder, std::size_t orderIdx) {
+                auto& entry = table.indices[impl::dispatchIndex(chOrder)];
+                if (entry != impl::NO_ORDER) {
+                    impl::orderCharacterIsDuplicated();
+                }
+                entry = static_cast<std::uint8_t>(orderIdx);
+            };
+            (registerOrder(std::get<idx>(table.orders).ch_order, idx), ...);
+        }(std::index_sequence_for<OrdersT...>{});
+        
+        return table;
+    }
+} // namespace utcoupe::asserv::serial
+
+#endif // UTCOUPE_ASSERV_SERIAL_ORDER_TABLE_HPP
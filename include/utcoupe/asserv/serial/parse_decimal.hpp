@@ -0,0 +1,262 @@
+#ifndef UTCOUPE_ASSERV_SERIAL_PARSE_DECIMAL_HPP
+#define UTCOUPE_ASSERV_SERIAL_PARSE_DECIMAL_HPP
+
+#include "utcoupe/asserv/fixed_point.hpp"
+
+#include <array>
+#include <limits>
+#include <concepts>
+#include <cstdint>
+#include <optional>
+
+namespace utcoupe::asserv::serial {
+    namespace impl {
+        /**
+         * A decimal number split into its significant digits and its power of ten: value = mantissa * 10^exponent.
+         */
+        struct DecimalNumber {
+            /** The first significant digits of the number, without its dot. */
+            std::uint64_t mantissa = 0;
+            
+            /** The power of ten the mantissa has to be multiplied by. */
+            int exponent = 0;
+            
+            /** True if the number starts with a '-'. */
+            bool negative = false;
+            
+            /** The address +1 of the last parsed char. */
+            const char* end = nullptr;
+        };
+        
+        /** Maximum number of digits kept inside DecimalNumber::mantissa, the following ones only shift the exponent. */
+        inline constexpr int MAX_MANTISSA_DIGITS = 19;
+        
+        /** Largest power of ten exactly representable by a double. */
+        inline constexpr int MAX_EXACT_POW10_DOUBLE = 22;
+        
+        /** Largest power of ten exactly representable by a float. */
+        inline constexpr int MAX_EXACT_POW10_FLOAT = 10;
+        
+        /** Largest integer whose all smaller integers are exactly representable by a float. */
+        inline constexpr std::uint64_t MAX_EXACT_MANTISSA_FLOAT = std::uint64_t{ 1 } << 24;
+        
+        /** Largest integer whose all smaller integers are exactly representable by a double. */
+        inline constexpr std::uint64_t MAX_EXACT_MANTISSA_DOUBLE = std::uint64_t{ 1 } << 53;
+        
+        constexpr std::array<double, MAX_EXACT_POW10_DOUBLE + 1> POW10_DOUBLE{
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        
+        constexpr std::array<float, MAX_EXACT_POW10_FLOAT + 1> POW10_FLOAT{
+            1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+        };
+        
+        /** Largest power of ten representable by a std::uint64_t. */
+        inline constexpr int MAX_POW10_UINT64 = 19;
+        
+        constexpr std::array<std::uint64_t, MAX_POW10_UINT64 + 1> POW10_UINT64 = [] {
+            std::array<std::uint64_t, MAX_POW10_UINT64 + 1> pow10{};
+            pow10[0] = 1;
+            for (std::size_t i = 1; i < pow10.size(); ++i) {
+                pow10[i] = pow10[i - 1] * 10;
+            }
+            return pow10;
+        }();
+        
+        constexpr bool isDigit(char c) noexcept {
+            return c >= '0' && c <= '9';
+        }
+        
+        /**
+         * Reads a decimal number in the [first, last) range, with the same syntax as std::from_chars in general format.
+         * 
+         * Accepts an optional '-', digits with an optional dot, and an optional exponent (e.g. "-12.5e-3"). Never reads outside the range and doesn't depend on the locale.
+         * 
+         * @param first The address of the first char of the string
+         * @param last The address +1 of the last char of the string
+         * @return The number, or std::nullopt if the range doesn't start with a number
+         */
+        constexpr std::optional<DecimalNumber> scanDecimal(const char* first, const char* last) noexcept {
+            DecimalNumber number;
+            const char* cur = first;
+            
+            if (cur != last && *cur == '-') {
+                number.negative = true;
+                ++cur;
+            }
+            
+            int digits = 0;
+            int keptDigits = 0;
+            auto readDigit = [&number, &keptDigits](char c) {
+                // Leading zeros aren't significant
+                if (keptDigits == 0 && c == '0') {
+                    return true;
+                }
+                if (keptDigits < MAX_MANTISSA_DIGITS) {
+                    number.mantissa = number.mantissa * 10 + static_cast<std::uint64_t>(c - '0');
+                    ++keptDigits;
+                    return true;
+                }
+                return false;
+            };
+            
+            for (; cur != last && isDigit(*cur); ++cur, ++digits) {
+                if (!readDigit(*cur)) {
+                    ++number.exponent;
+                }
+            }
+            if (cur != last && *cur == '.') {
+                ++cur;
+                for (; cur != last && isDigit(*cur); ++cur, ++digits) {
+                    if (readDigit(*cur)) {
+                        --number.exponent;
+                    }
+                }
+            }
+            if (digits == 0) {
+                return std::nullopt;
+            }
+            
+            // The exponent is only consumed if it is complete, like std::from_chars does
+            if (cur != last && (*cur == 'e' || *cur == 'E')) {
+                const char* expCur = cur + 1;
+                bool negativeExp = false;
+                if (expCur != last && (*expCur == '-' || *expCur == '+')) {
+                    negativeExp = *expCur == '-';
+                    ++expCur;
+                }
+                if (expCur != last && isDigit(*expCur)) {
+                    int exponent = 0;
+                    for (; expCur != last && isDigit(*expCur); ++expCur) {
+                        // Saturates, any bigger exponent overflows anyway
+                        if (exponent < 10000) {
+                            exponent = exponent * 10 + (*expCur - '0');
+                        }
+                    }
+                    number.exponent += negativeExp ? -exponent : exponent;
+                    cur = expCur;
+                }
+            }
+            
+            number.end = cur;
+            return number;
+        }
+        
+        /**
+         * Scales a mantissa by a power of ten.
+         * 
+         * The result is correctly rounded when both the mantissa and the power of ten are exactly representable by FloatT (Clinger's fast path), which covers the short decimal values of the protocol. Other values are approximated through repeated multiplications.
+         */
+        template<std::floating_point FloatT>
+        constexpr FloatT scaleByPow10(std::uint64_t mantissa, int exponent) noexcept {
+            if constexpr (std::is_same_v<FloatT, float>) {
+                if (mantissa <= MAX_EXACT_MANTISSA_FLOAT && exponent >= -MAX_EXACT_POW10_FLOAT && exponent <= MAX_EXACT_POW10_FLOAT) {
+                    const auto value = static_cast<float>(mantissa);
+                    const float pow10 = POW10_FLOAT[static_cast<std::size_t>(exponent < 0 ? -exponent : exponent)];
+                    return exponent < 0 ? value / pow10 : value * pow10;
+                }
+                return static_cast<float>(scaleByPow10<double>(mantissa, exponent));
+            } else {
+                auto value = static_cast<FloatT>(mantissa);
+                if (value == 0) {
+                    return value;
+                }
+                if (mantissa <= MAX_EXACT_MANTISSA_DOUBLE && exponent >= -MAX_EXACT_POW10_DOUBLE && exponent <= MAX_EXACT_POW10_DOUBLE) {
+                    const auto pow10 = static_cast<FloatT>(POW10_DOUBLE[static_cast<std::size_t>(exponent < 0 ? -exponent : exponent)]);
+                    return exponent < 0 ? value / pow10 : value * pow10;
+                }
+                
+                const auto maxPow10 = static_cast<FloatT>(POW10_DOUBLE[MAX_EXACT_POW10_DOUBLE]);
+                for (; exponent > MAX_EXACT_POW10_DOUBLE && value <= std::numeric_limits<FloatT>::max(); exponent -= MAX_EXACT_POW10_DOUBLE) {
+                    value *= maxPow10;
+                }
+                for (; exponent < -MAX_EXACT_POW10_DOUBLE && value != 0; exponent += MAX_EXACT_POW10_DOUBLE) {
+                    value /= maxPow10;
+                }
+                if (exponent > MAX_EXACT_POW10_DOUBLE || exponent < -MAX_EXACT_POW10_DOUBLE) {
+                    return value;
+                }
+                const auto pow10 = static_cast<FloatT>(POW10_DOUBLE[static_cast<std::size_t>(exponent < 0 ? -exponent : exponent)]);
+                return exponent < 0 ? value / pow10 : value * pow10;
+            }
+        }
+        
+        /**
+         * Helper when std::from_chars for floating-point types is not available.
+         * 
+         * Unlike std::strtof/strtod/strtold, it respects the [first, last) bounds, doesn't depend on the locale and doesn't allocate. It is tuned for the short decimal values carried by the protocol (PID gains, angles, speeds), for which the result is correctly rounded.
+         * @param first The address of the first char of the string
+         * @param last The address +1 of the last char of the string
+         * @param value The variable to set in case of success, or remain untouched
+         * @return The address +1 of the last parsed char, or std::nullopt in case of error or if the value is out of range
+         */
+        template<std::floating_point ArgT>
+        constexpr std::optional<const char *> from_chars_fp(const char* first, const char* last, ArgT& value) noexcept {
+            auto number = scanDecimal(first, last);
+            if (!number) {
+                return std::nullopt;
+            }
+            
+            ArgT result = scaleByPow10<ArgT>(number->mantissa, number->exponent);
+            if (result > std::numeric_limits<ArgT>::max()) {
+                return std::nullopt;
+            }
+            value = number->negative ? -result : result;
+            return number->end;
+        }
+        
+        /**
+         * Reads a decimal number into a Fixed, only using integer arithmetic.
+         * 
+         * The value is rounded to the nearest representable one. Digits beyond the precision of 64-bit integers are ignored.
+         * @param first The address of the first char of the string
+         * @param last The address +1 of the last char of the string
+         * @param value The variable to set in case of success, or remain untouched
+         * @return The address +1 of the last parsed char, or std::nullopt in case of error or if the value is out of range
+         */
+        template<FixedPoint ArgT>
+        constexpr std::optional<const char *> from_chars_fixed(const char* first, const char* last, ArgT& value) noexcept {
+            auto number = scanDecimal(first, last);
+            if (!number) {
+                return std::nullopt;
+            }
+            
+            constexpr int fractionalBits = ArgT::FRACTIONAL_BITS;
+            // The magnitude of the most negative value, one more than the most positive one
+            constexpr std::uint64_t rawLimit = std::uint64_t{ 1 } << 31;
+            
+            std::uint64_t mantissa = number->mantissa;
+            int exponent = number->exponent;
+            
+            // Drop the digits that would overflow once shifted by the fractional bits, or once divided by a too big power of ten
+            while (mantissa >= (std::uint64_t{ 1 } << (63 - fractionalBits)) || exponent < -MAX_POW10_UINT64) {
+                mantissa /= 10;
+                ++exponent;
+            }
+            
+            std::uint64_t raw = 0;
+            if (mantissa != 0 && exponent >= 0) {
+                for (; exponent > 0; --exponent) {
+                    mantissa *= 10;
+                    if (mantissa > (rawLimit >> fractionalBits)) {
+                        return std::nullopt;
+                    }
+                }
+                raw = mantissa << fractionalBits;
+            } else if (mantissa != 0) {
+                const std::uint64_t divisor = POW10_UINT64[static_cast<std::size_t>(-exponent)];
+                raw = ((mantissa << fractionalBits) + divisor / 2) / divisor;
+            }
+            
+            if (raw > (number->negative ? rawLimit : rawLimit - 1)) {
+                return std::nullopt;
+            }
+            const auto signedRaw = static_cast<std::int64_t>(raw);
+            value = ArgT::fromRaw(static_cast<typename ArgT::RawT>(number->negative ? -signedRaw : signedRaw));
+            return number->end;
+        }
+    } // namespace impl
+} // namespace utcoupe::asserv::serial
+
+#endif // UTCOUPE_ASSERV_SERIAL_PARSE_DECIMAL_HPP
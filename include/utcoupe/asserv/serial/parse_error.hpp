@@ -0,0 +1,137 @@
+#ifndef UTCOUPE_ASSERV_SERIAL_PARSE_ERROR_HPP
+#define UTCOUPE_ASSERV_SERIAL_PARSE_ERROR_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace utcoupe::asserv::serial {
+    /** The reason why an order couldn't be run, sent back to the host in a PARSE_ERROR_RESPONSE. */
+    enum class ParseError : std::uint8_t {
+        /** The order has been parsed. */
+        NONE,
+        /** The order character isn't part of the table, or isn't followed by a separator. */
+        UNKNOWN_ORDER,
+        /** The frame ends before all the parameters, or their separators, have been received. */
+        MISSING_ARG,
+        /** A parameter isn't a number, or isn't followed by a separator. */
+        BAD_NUMBER,
+        /** Something follows the last parameter. */
+        TRAILING_DATA,
+        /** A parameter is a number out of the range of its type. */
+        OUT_OF_RANGE,
+        /** The CRC of a binary frame doesn't match its content. */
+        BAD_CHECKSUM
+    };
+    
+    /** Number of values of ParseError, NONE included. */
+    inline constexpr std::size_t PARSE_ERROR_COUNT = static_cast<std::size_t>(ParseError::BAD_CHECKSUM) + 1;
+    
+    /**
+     * Character of the response sent instead of the result of an order which couldn't be run, see ResponseWriter::writeError.
+     * 
+     * It isn't an order character, so the host tells it apart from the other responses.
+     */
+    inline constexpr char PARSE_ERROR_RESPONSE = '!';
+    
+    /** The name of an error, as written in the protocol schema. */
+    constexpr std::string_view parseErrorName(ParseError error) noexcept {
+        switch (error) {
+            case ParseError::NONE: return "NONE";
+            case ParseError::UNKNOWN_ORDER: return "UNKNOWN_ORDER";
+            case ParseError::MISSING_ARG: return "MISSING_ARG";
+            case ParseError::BAD_NUMBER: return "BAD_NUMBER";
+            case ParseError::TRAILING_DATA: return "TRAILING_DATA";
+            case ParseError::OUT_OF_RANGE: return "OUT_OF_RANGE";
+            case ParseError::BAD_CHECKSUM: return "BAD_CHECKSUM";
+        }
+        return {};
+    }
+    
+    /**
+     * Parsed values, or the reason why they couldn't be parsed.
+     * 
+     * It can be used like a std::optional, and holds the error instead of nothing.
+     * 
+     * @tparam T The parsed values, which must be default constructible.
+     */
+    template<class T>
+    class ParseResult {
+    public:
+        constexpr ParseResult(T value) noexcept: m_value(std::move(value)) {}
+        constexpr ParseResult(ParseError error) noexcept: m_error(error) {}
+        
+        constexpr bool has_value() const noexcept {
+            return m_error == ParseError::NONE;
+        }
+        
+        constexpr explicit operator bool() const noexcept {
+            return has_value();
+        }
+        
+        constexpr T& operator*() noexcept {
+            return m_value;
+        }
+        
+        constexpr const T& operator*() const noexcept {
+            return m_value;
+        }
+        
+        /** ParseError::NONE if the values have been parsed. */
+        constexpr ParseError error() const noexcept {
+            return m_error;
+        }
+        
+    private:
+        T m_value{};
+        ParseError m_error = ParseError::NONE;
+    };
+    
+    /**
+     * Number of orders rejected for each ParseError, for the host to detect a corrupted link.
+     * 
+     * Unlike OrderStats, the counters are always enabled: recording is a single relaxed increment. Errors are recorded from both the context decoding the orders and the one running them, hence the atomics.
+     */
+    class ParseErrorCounters {
+    public:
+        void record(ParseError error) noexcept {
+            if (error != ParseError::NONE) {
+                m_counts[static_cast<std::size_t>(error)].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        
+        /** Number of orders rejected with an error, 0 for ParseError::NONE. */
+        std::uint32_t count(ParseError error) const noexcept {
+            return m_counts[static_cast<std::size_t>(error)].load(std::memory_order_relaxed);
+        }
+        
+        /** Number of orders rejected, whatever the error. */
+        std::uint32_t total() const noexcept {
+            std::uint32_t rejected = 0;
+            for (const auto& count : m_counts) {
+                rejected += count.load(std::memory_order_relaxed);
+            }
+            return rejected;
+        }
+        
+        void reset() noexcept {
+            for (auto& count : m_counts) {
+                count.store(0, std::memory_order_relaxed);
+            }
+        }
+        
+    private:
+        std::array<std::atomic<std::uint32_t>, PARSE_ERROR_COUNT> m_counts{};
+    };
+    
+    /** The errors recorded by every OrderParser and decodeOrder. */
+    inline ParseErrorCounters& parseErrors() noexcept {
+        static ParseErrorCounters counters;
+        return counters;
+    }
+} // namespace utcoupe::asserv::serial
+
+#endif // UTCOUPE_ASSERV_SERIAL_PARSE_ERROR_HPP
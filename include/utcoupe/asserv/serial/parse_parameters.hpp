@@ -1,46 +1,19 @@
 #ifndef UTCOUPE_ASSERV_SERIAL_PARSE_PARAMETERS_HPP
 #define UTCOUPE_ASSERV_SERIAL_PARSE_PARAMETERS_HPP
 
+#include "utcoupe/asserv/serial/parse_decimal.hpp"
+#include "utcoupe/asserv/serial/parse_error.hpp"
 #include "utcoupe/asserv/serial/traits.hpp"
 
 #include <charconv>
-#include <cstdlib>
 #include <concepts>
-#include <optional>
+#include <string_view>
+#include <system_error>
 #include <tuple>
 
 namespace utcoupe::asserv::serial {
-    namespace impl {
-        /**
-         * Helper when std::from_chars for floating-point types is not available.
-         * 
-         * It internaly uses std::strtof/strtod/strtold, which are not as fast as std::from_chars<double>(...). It also does NOT CHECK boundaries, the string MUST either ends with '\0' or contain a char that isn't a part of a floating point value string representation.
-         * @param first The address of the first char of the string
-         * @param value The variable to set in case of success, or remain untouched
-         * @return The address +1 of the last parsed char, or std::nullopt in case of error
-         */
-        template<std::floating_point ArgT>
-        std::optional<const char *> from_chars_fp(const char* first, ArgT& value) {
-            char* last = nullptr;
-            ArgT result;
-            
-            // std::remove_cv_t is not be needed
-            if constexpr (std::is_same_v<ArgT, float>) {
-                result = std::strtof(first, &last);
-            } else if constexpr (std::is_same_v<ArgT, double>) {
-                result = std::strtod(first, &last);
-            } else /* if constexpr (std::is_same_v<ArgT, long double>) */ {
-                result = std::strtold(first, &last);
-            }
-            
-            // std::strtof/strtod/strtold sets the value of last to first if it failed to parse.
-            if (last == first) {
-                return std::nullopt;
-            }
-            value = result;
-            return last;
-        }
-    } // namespace impl
+    /** Character separating the values of an ASCII order or response. */
+    inline constexpr char VALUE_SEPARATOR = ';';
     
     /**
      * Helper when std::from_chars for current type is not available.
@@ -51,41 +24,79 @@ namespace utcoupe::asserv::serial {
      * @param last A pointer to the last char of the string
      */
     template<typename CurArgT, typename... OtherArgsT>
-    std::optional<std::tuple<CurArgT, OtherArgsT...>> parseParameters([[maybe_unused]] const char* first, [[maybe_unused]] const char* last) noexcept {
-        return std::nullopt;
+    ParseResult<std::tuple<CurArgT, OtherArgsT...>> parseParameters([[maybe_unused]] const char* first, [[maybe_unused]] const char* last) noexcept {
+        return ParseError::BAD_NUMBER;
     }
     
+    // Declared ahead so that each overload can parse the parameters following its own, whatever their types
+    template<std::floating_point CurArgT, typename... OtherArgsT>
+    requires (not CanIntantiateFromChars<CurArgT>)
+    ParseResult<std::tuple<CurArgT, OtherArgsT...>> parseParameters(const char* first, const char* last) noexcept;
+    
+    template<typename CurArgT, typename... OtherArgsT>
+    requires CanIntantiateFromChars<CurArgT>
+    ParseResult<std::tuple<CurArgT, OtherArgsT...>> parseParameters(const char* first, const char* last) noexcept;
+    
+    template<FixedPoint CurArgT, typename... OtherArgsT>
+    ParseResult<std::tuple<CurArgT, OtherArgsT...>> parseParameters(const char* first, const char* last) noexcept;
+    
+    namespace impl {
+        /**
+         * Checks the separator following a parsed value, then parses the next parameters, or checks that nothing follows the last one.
+         * 
+         * @param value The parsed value.
+         * @param next A pointer to the first char following the value
+         * @param last A pointer to the last char of the string
+         */
+        template<typename CurArgT, typename... OtherArgsT>
+        ParseResult<std::tuple<CurArgT, OtherArgsT...>> parseFollowingParameters(CurArgT value, const char* next, const char* last) noexcept {
+            if (next == last) {
+                return ParseError::MISSING_ARG;
+            }
+            if (*next != VALUE_SEPARATOR) {
+                return ParseError::BAD_NUMBER;
+            }
+            
+            if constexpr (sizeof ...(OtherArgsT) == 0) {
+                if (next + 1 != last) {
+                    return ParseError::TRAILING_DATA;
+                }
+                return std::tuple{ value };
+            } else {
+                auto otherValues = parseParameters<OtherArgsT...>(next + 1, last);
+                if (!otherValues) {
+                    return otherValues.error();
+                }
+                return std::tuple_cat(std::tuple{ value }, *otherValues);
+            }
+        }
+        
+        /** Tells apart a number too big for its type from something which isn't a number, once the parsing of a decimal value has failed. */
+        constexpr ParseError decimalError(const char* first, const char* last) noexcept {
+            return scanDecimal(first, last) ? ParseError::OUT_OF_RANGE : ParseError::BAD_NUMBER;
+        }
+    } // namespace impl
+    
     /**
      * Helper when std::from_chars for floating-point types is not available.
      * 
-     * @TODO 
+     * Floating-point values are read by impl::from_chars_fp, which respects the string boundaries.
      * 
      * @param first A pointer to the first char of the string
      * @param last A pointer to the last char of the string
      */
     template<std::floating_point CurArgT, typename... OtherArgsT>
     requires (not CanIntantiateFromChars<CurArgT>)
-    std::optional<std::tuple<float, OtherArgsT...>> parseParameters(const char* first, const char* last) noexcept {
-        if (first + 1 >= last) {
-            return std::nullopt;
+    ParseResult<std::tuple<CurArgT, OtherArgsT...>> parseParameters(const char* first, const char* last) noexcept {
+        if (first == last) {
+            return ParseError::MISSING_ARG;
         }
         CurArgT val;
-        auto nextFirstOpt = impl::from_chars_fp(first, val);
+        auto nextFirstOpt = impl::from_chars_fp(first, last, val);
         if (!nextFirstOpt) {
-            return std::nullopt;
-        }
-        
-        // Same as general parseParameters
-        if constexpr (sizeof ...(OtherArgsT) == 0) {
-            // TODO maybe warn unused parameters? (if nextFirst + 1 < last)
-            return std::tuple{ val };
-        } else {
-            auto otherValues = parseParameters<OtherArgsT...>(*nextFirstOpt + 1, last);
-            if (!otherValues) {
-                return std::nullopt;
-            }
-            return std::tuple_cat(std::tuple{ val }, otherValues.value());
+            return impl::decimalError(first, last);
         }
+        return impl::parseFollowingParameters<CurArgT, OtherArgsT...>(val, *nextFirstOpt, last);
     }
     
     
@@ -93,61 +104,74 @@ namespace utcoupe::asserv::serial {
      * Parse numbers given in a string, and returns filled arguments in a tuple.
      * 
      * Compatible types are all integer types, float, double, long double. Floating point version may not be implemented in your compiler.
-     * Parameters must be separed by a character like ' ', ';', ..., that can't be interpreted as part of a number. See https://en.cppreference.com/w/cpp/utility/from_chars for more details
-     * If the number of parameters is smaller than the number of arguments to fill, it will return std::nullopt.
+     * Each parameter must be followed by a VALUE_SEPARATOR, and nothing may follow the last one, e.g. "12;-3.5;". See https://en.cppreference.com/w/cpp/utility/from_chars for the syntax of the numbers.
      * 
      * @param first Address of first character of the string
      * @param last Address + 1 of the last character of the string
-     * @return A tuple containing values for all given argument types, in the same order, or std::nullopt if it has failed
+     * @return A tuple containing values for all given argument types, in the same order, or the reason why the string couldn't be parsed
      */
     template<typename CurArgT, typename... OtherArgsT>
     requires CanIntantiateFromChars<CurArgT>
-    std::optional<std::tuple<CurArgT, OtherArgsT...>> parseParameters(const char* first, const char* last) noexcept {
-        if (first + 1 >= last) {
-            return std::nullopt;
+    ParseResult<std::tuple<CurArgT, OtherArgsT...>> parseParameters(const char* first, const char* last) noexcept {
+        if (first == last) {
+            return ParseError::MISSING_ARG;
         }
         CurArgT val;
         auto [nextFirst, ec] = std::from_chars(first, last, val);
+        if (ec == std::errc::result_out_of_range) {
+            return ParseError::OUT_OF_RANGE;
+        }
         if (ec != std::errc{}) {
-            return std::nullopt;
+            return ParseError::BAD_NUMBER;
         }
-        
-        if constexpr (sizeof ...(OtherArgsT) == 0) {
-            // TODO maybe warn unused parameters? (if nextFirst + 1 < last)
-            return std::tuple{ val };
-        } else {
-            auto otherValues = parseParameters<OtherArgsT...>(nextFirst + 1, last);
-            if (!otherValues) {
-                return std::nullopt;
-            }
-            return std::tuple_cat(std::tuple{ val }, otherValues.value());
+        return impl::parseFollowingParameters<CurArgT, OtherArgsT...>(val, nextFirst, last);
+    }
+    
+    /**
+     * Parses fixed-point numbers, without going through floating-point values.
+     * 
+     * Values are read by impl::from_chars_fixed, which respects the string boundaries.
+     * 
+     * @param first A pointer to the first char of the string
+     * @param last A pointer to the last char of the string
+     */
+    template<FixedPoint CurArgT, typename... OtherArgsT>
+    ParseResult<std::tuple<CurArgT, OtherArgsT...>> parseParameters(const char* first, const char* last) noexcept {
+        if (first == last) {
+            return ParseError::MISSING_ARG;
+        }
+        CurArgT val;
+        auto nextFirstOpt = impl::from_chars_fixed(first, last, val);
+        if (!nextFirstOpt) {
+            return impl::decimalError(first, last);
         }
+        return impl::parseFollowingParameters<CurArgT, OtherArgsT...>(val, *nextFirstOpt, last);
     }
     
     /**
      * Deserializes values contained in the string.
      * 
-     * This function does handle empty tuples (tuple without values).
+     * This function does handle empty tuples (tuple without values), whose string must then be empty.
      * @param str The string containing the serialized values.
      * @param values The tuple to set deserialized values.
-     * @return True if it succeeded, false else.
+     * @return ParseError::NONE if it succeeded, the reason of the failure else.
      */
     template<typename... ArgsT>
-    bool parseAndSetParameters(std::string_view str, std::tuple<ArgsT...>& values) {
+    ParseError parseAndSetParameters(std::string_view str, std::tuple<ArgsT...>& values) noexcept {
         if constexpr (sizeof ...(ArgsT) == 0) {
             values = {};
-            return true;
+            return str.empty() ? ParseError::NONE : ParseError::TRAILING_DATA;
         } else {
             auto results = parseParameters<ArgsT...>(
                 str.data(), str.data() + str.size()
             );
             
             if (!results) {
-                return false;
+                return results.error();
             }
             
             values = *results;
-            return true;
+            return ParseError::NONE;
         }
     }
 } // namespace utcoupe::asserv::serial
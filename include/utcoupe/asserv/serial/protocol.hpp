@@ -2,12 +2,19 @@
 #define UTCOUPE_ASSERV_SERIAL_PROTOCOL_HPP
 
 #include "utcoupe/asserv/serial/order.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+
+#include <string_view>
+#include <tuple>
 
 namespace utcoupe::asserv::serial {
     
     enum class OrderTypes : char {
         ACC_MAX = 'l',
+        /** Not an order by itself: a frame carrying several orders, see OrderBatch. */
+        BATCH = 'B',
         CLEAN_GOALS = 'g',
+        DIAGNOSTICS = 'D',
         GET_CODER = 'j',
         GET_LAST_ID = 't',
         GET_POS = 'n',
@@ -33,9 +40,65 @@ namespace utcoupe::asserv::serial {
         SPD = 'b',
         SPD_MAX = 'x',
         START = 'S',
+        TELEMETRY = 'T',
         WHO_AMI = 'w'
     };
     
+    /**
+     * Gives the name of an order type, as written in OrderTypes.
+     * 
+     * @param orderType The order type.
+     * @return Its name, or an empty string if it isn't an order type.
+     */
+    constexpr std::string_view orderName(OrderTypes orderType) noexcept {
+        switch (orderType) {
+            case OrderTypes::ACC_MAX: return "ACC_MAX";
+            case OrderTypes::BATCH: return "BATCH";
+            case OrderTypes::CLEAN_GOALS: return "CLEAN_GOALS";
+            case OrderTypes::DIAGNOSTICS: return "DIAGNOSTICS";
+            case OrderTypes::GET_CODER: return "GET_CODER";
+            case OrderTypes::GET_LAST_ID: return "GET_LAST_ID";
+            case OrderTypes::GET_POS: return "GET_POS";
+            case OrderTypes::GET_POS_ID: return "GET_POS_ID";
+            case OrderTypes::GET_SPD: return "GET_SPD";
+            case OrderTypes::GET_TARGET_SPD: return "GET_TARGET_SPD";
+            case OrderTypes::GOTO: return "GOTO";
+            case OrderTypes::GOTO_WITH_ANGLE: return "GOTO_WITH_ANGLE";
+            case OrderTypes::HALT: return "HALT";
+            case OrderTypes::KILL_GOAL: return "KILL_GOAL";
+            case OrderTypes::PAUSE: return "PAUSE";
+            case OrderTypes::PID_ALL: return "PID_ALL";
+            case OrderTypes::PID_LEFT: return "PID_LEFT";
+            case OrderTypes::PID_RIGHT: return "PID_RIGHT";
+            case OrderTypes::PING_PING: return "PING_PING";
+            case OrderTypes::PWM: return "PWM";
+            case OrderTypes::RESET_ID: return "RESET_ID";
+            case OrderTypes::RESUME: return "RESUME";
+            case OrderTypes::ROT: return "ROT";
+            case OrderTypes::ROT_MODULO: return "ROT_MODULO";
+            case OrderTypes::SET_EMERGENCY_STOP: return "SET_EMERGENCY_STOP";
+            case OrderTypes::SET_POS: return "SET_POS";
+            case OrderTypes::SPD: return "SPD";
+            case OrderTypes::SPD_MAX: return "SPD_MAX";
+            case OrderTypes::START: return "START";
+            case OrderTypes::TELEMETRY: return "TELEMETRY";
+            case OrderTypes::WHO_AMI: return "WHO_AMI";
+        }
+        return {};
+    }
+    
+    /**
+     * Instanciates and returns a new Order struct identified by one of the protocol order types.
+     * 
+     * @param orderType The order type, whose value is the character identifying the order.
+     * @param callback A pointer to member function that will be called when this order will be successfully dessirialized.
+     * @return An initialized Order.
+     */
+    template<typename CbReturnT, typename Executor, typename... CallbackArgsT>
+    constexpr auto createOrder(OrderTypes orderType, CbReturnT(Executor::* callback)(CallbackArgsT...)) noexcept {
+        return createOrder(static_cast<char>(orderType), callback);
+    }
+    
     template<class Executor>
     // FIXME maybe consteval ?
     constexpr auto createStateMachineOrders() noexcept {
@@ -85,14 +148,39 @@ namespace utcoupe::asserv::serial {
         };
     }
     
+    template<class Executor>
+    // FIXME maybe consteval ?
+    constexpr auto createTelemetryOrders() noexcept {
+        return std::tuple{
+            createOrder(OrderTypes::TELEMETRY, &Executor::setTelemetry)
+        };
+    }
+    
+    /**
+     * Orders querying the health of the asserv.
+     * 
+     * DIAGNOSTICS takes the ASCII code of an order character and answers with its LatencySummary, or the one of all the orders for 0. See OrderStats.
+     */
+    template<class Executor>
+    // FIXME maybe consteval ?
+    constexpr auto createDiagnosticsOrders() noexcept {
+        return std::tuple{
+            createOrder(OrderTypes::DIAGNOSTICS, &Executor::getDiagnostics)
+        };
+    }
+    
     template<class Executor>
     // FIXME maybe consteval ?
     constexpr auto createAllOrders() noexcept {
-        return std::tuple_cat(
+        constexpr auto allOrders = std::tuple_cat(
             createMoveOrders<Executor>(),
             createConfigOrders<Executor>(),
-            createStateMachineOrders<Executor>()
+            createStateMachineOrders<Executor>(),
+            createTelemetryOrders<Executor>(),
+            createDiagnosticsOrders<Executor>()
         );
+        static_assert(hasUniqueOrderChars(allOrders), "Two orders of the protocol share the same character.");
+        return allOrders;
     }
 } // namespace utcoupe::asserv::serial
 
@@ -0,0 +1,281 @@
+#ifndef UTCOUPE_ASSERV_SERIAL_PROTOCOL_SCHEMA_HPP
+#define UTCOUPE_ASSERV_SERIAL_PROTOCOL_SCHEMA_HPP
+
+#include "utcoupe/asserv/fixed_point.hpp"
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/parse_error.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/serial/response_writer.hpp"
+#include "utcoupe/asserv/serial/stream_decoder.hpp"
+
+#include <array>
+#include <charconv>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <variant>
+
+namespace utcoupe::asserv::serial {
+    /** The kinds of values carried by the orders and their results. */
+    enum class ValueKind : std::uint8_t {
+        /** No value, e.g. std::monostate or void. */
+        NONE,
+        BOOL,
+        SIGNED,
+        UNSIGNED,
+        FLOAT,
+        /** A Fixed number. */
+        FIXED,
+        /** Several values one after the other, e.g. the parameters of an order. */
+        TUPLE,
+        /** One value among several alternatives. */
+        VARIANT
+    };
+    
+    /** Description of a C++ type sent on the link, built at compile time by typeSchemaOf. */
+    struct TypeSchema {
+        ValueKind kind = ValueKind::NONE;
+        
+        /** Size of the value in bits, 0 for NONE, TUPLE and VARIANT. */
+        std::uint8_t bits = 0;
+        
+        /** Number of fractional bits of FIXED values. */
+        std::uint8_t fractionalBits = 0;
+        
+        /** The elements of TUPLE values, or the alternatives of VARIANT values. */
+        std::span<const TypeSchema> elements{};
+    };
+    
+    namespace impl {
+        template<class T>
+        struct TypeSchemaOf;
+        
+        template<>
+        struct TypeSchemaOf<void> {
+            static constexpr TypeSchema value{};
+        };
+        
+        template<>
+        struct TypeSchemaOf<std::monostate> {
+            static constexpr TypeSchema value{};
+        };
+        
+        template<>
+        struct TypeSchemaOf<bool> {
+            static constexpr TypeSchema value{ ValueKind::BOOL, CHAR_BIT * sizeof(bool) };
+        };
+        
+        template<std::integral T>
+        struct TypeSchemaOf<T> {
+            static constexpr TypeSchema value{ std::signed_integral<T> ? ValueKind::SIGNED : ValueKind::UNSIGNED, CHAR_BIT * sizeof(T) };
+        };
+        
+        template<std::floating_point T>
+        struct TypeSchemaOf<T> {
+            static constexpr TypeSchema value{ ValueKind::FLOAT, CHAR_BIT * sizeof(T) };
+        };
+        
+        template<int FractionalBits>
+        struct TypeSchemaOf<Fixed<FractionalBits>> {
+            static constexpr TypeSchema value{ ValueKind::FIXED, CHAR_BIT * sizeof(Fixed<FractionalBits>), FractionalBits };
+        };
+        
+        template<class... ElementsT>
+        struct TypeSchemaOf<std::tuple<ElementsT...>> {
+            static constexpr std::array<TypeSchema, sizeof...(ElementsT)> elements{ TypeSchemaOf<ElementsT>::value... };
+            static constexpr TypeSchema value{ ValueKind::TUPLE, 0, 0, elements };
+        };
+        
+        template<class... AlternativesT>
+        struct TypeSchemaOf<std::variant<AlternativesT...>> {
+            static constexpr std::array<TypeSchema, sizeof...(AlternativesT)> elements{ TypeSchemaOf<AlternativesT>::value... };
+            static constexpr TypeSchema value{ ValueKind::VARIANT, 0, 0, elements };
+        };
+        
+        /** The type returned by an order callback. */
+        template<class CallbackT>
+        struct CallbackResult;
+        
+        template<typename CbReturnT, typename Executor, typename... CallbackArgsT>
+        struct CallbackResult<CbReturnT(Executor::*)(CallbackArgsT...)> {
+            using type = CbReturnT;
+        };
+        
+        template<class OrderT>
+        using CallbackResultOf = typename CallbackResult<decltype(OrderT::callback)>::type;
+    } // namespace impl
+    
+    /** The TypeSchema of a type handled by the parser or the ResponseWriter, a tuple or a variant of them. */
+    template<class T>
+    inline constexpr const TypeSchema& typeSchemaOf = impl::TypeSchemaOf<T>::value;
+    
+    /** Description of an order of an OrderTable. */
+    struct OrderSchema {
+        /** The character identifying the order. */
+        char chOrder;
+        
+        /** The name of the order in OrderTypes, empty if it isn't part of the protocol. */
+        std::string_view name;
+        
+        /** The parameters of the order, always a TUPLE. */
+        TypeSchema args;
+        
+        /** The value returned by the callback of the order. */
+        TypeSchema result;
+        
+        /** Size of the payload of the order in a binary frame. */
+        std::size_t binaryPayloadSize;
+    };
+    
+    /**
+     * Describes every order of a table at compile time.
+     * 
+     * The schema is derived from the callbacks themselves, so it can't get out of sync with what the asserv actually parses.
+     * 
+     * @param table An OrderTable, e.g. one built from createAllOrders.
+     * @return The description of each order, in the table order.
+     */
+    template<class... OrdersT>
+    consteval std::array<OrderSchema, sizeof...(OrdersT)> makeProtocolSchema(const OrderTable<OrdersT...>& table) noexcept {
+        return std::apply(
+            [](const auto&... order) {
+                return std::array<OrderSchema, sizeof...(OrdersT)>{
+                    OrderSchema{
+                        order.ch_order,
+                        orderName(static_cast<OrderTypes>(order.ch_order)),
+                        typeSchemaOf<typename OrdersT::CallbackArgs>,
+                        typeSchemaOf<impl::CallbackResultOf<OrdersT>>,
+                        binaryPayloadSize<typename OrdersT::CallbackArgs>
+                    }...
+                };
+            },
+            table.orders
+        );
+    }
+    
+    namespace impl {
+        template<class Sink>
+        void writeJsonNumber(Sink& write, std::size_t value) noexcept {
+            std::array<char, 24> digits;
+            const auto [end, ec] = std::to_chars(digits.begin(), digits.end(), value);
+            write(std::string_view{ digits.data(), static_cast<std::size_t>(end - digits.data()) });
+        }
+        
+        template<class Sink>
+        void writeJsonChar(Sink& write, char c) noexcept {
+            write("\"");
+            switch (c) {
+                case '"': write("\\\""); break;
+                case '\\': write("\\\\"); break;
+                case '\n': write("\\n"); break;
+                default: write(std::string_view{ &c, 1 }); break;
+            }
+            write("\"");
+        }
+        
+        template<class Sink>
+        void writeJsonElements(Sink& write, std::span<const TypeSchema> elements) noexcept;
+        
+        /** Writes scalars as a type name, e.g. "int32" or "q16.16", tuples as an array and variants as {"oneOf": [...]}. */
+        template<class Sink>
+        void writeJsonType(Sink& write, const TypeSchema& type) noexcept {
+            switch (type.kind) {
+                case ValueKind::NONE:
+                    write("null");
+                    return;
+                case ValueKind::BOOL:
+                    write("\"bool\"");
+                    return;
+                case ValueKind::SIGNED:
+                    write("\"int");
+                    break;
+                case ValueKind::UNSIGNED:
+                    write("\"uint");
+                    break;
+                case ValueKind::FLOAT:
+                    write("\"float");
+                    break;
+                case ValueKind::FIXED:
+                    write("\"q");
+                    writeJsonNumber(write, type.bits - type.fractionalBits);
+                    write(".");
+                    writeJsonNumber(write, type.fractionalBits);
+                    write("\"");
+                    return;
+                case ValueKind::TUPLE:
+                    writeJsonElements(write, type.elements);
+                    return;
+                case ValueKind::VARIANT:
+                    write("{\"oneOf\": ");
+                    writeJsonElements(write, type.elements);
+                    write("}");
+                    return;
+            }
+            writeJsonNumber(write, type.bits);
+            write("\"");
+        }
+        
+        template<class Sink>
+        void writeJsonElements(Sink& write, std::span<const TypeSchema> elements) noexcept {
+            write("[");
+            for (std::size_t i = 0; i < elements.size(); ++i) {
+                if (i > 0) {
+                    write(", ");
+                }
+                writeJsonType(write, elements[i]);
+            }
+            write("]");
+        }
+    } // namespace impl
+    
+    /**
+     * Writes a schema as JSON, for the tools of the host to generate their clients from.
+     * 
+     * The document holds the framing constants, the names of the ParseError codes in their numeric order, and one object per order: its character, name, parameters, result and binary payload size.
+     * 
+     * @param schema A schema built by makeProtocolSchema.
+     * @param write Called with each piece of the document, e.g. to append it to a file.
+     */
+    template<class Sink>
+    void writeSchemaJson(std::span<const OrderSchema> schema, Sink&& write) noexcept {
+        write("{\n  \"valueSeparator\": ");
+        impl::writeJsonChar(write, VALUE_SEPARATOR);
+        write(",\n  \"frameTerminator\": ");
+        impl::writeJsonChar(write, FRAME_TERMINATOR);
+        write(",\n  \"binaryFrameStart\": ");
+        impl::writeJsonNumber(write, static_cast<unsigned char>(BINARY_FRAME_START));
+        write(",\n  \"parseErrorResponse\": ");
+        impl::writeJsonChar(write, PARSE_ERROR_RESPONSE);
+        write(",\n  \"parseErrors\": [");
+        for (std::size_t i = 0; i < PARSE_ERROR_COUNT; ++i) {
+            write(i > 0 ? ", \"" : "\"");
+            write(parseErrorName(static_cast<ParseError>(i)));
+            write("\"");
+        }
+        write("],\n  \"orders\": [");
+        for (std::size_t i = 0; i < schema.size(); ++i) {
+            const OrderSchema& order = schema[i];
+            write(i > 0 ? ",\n    " : "\n    ");
+            write("{\"char\": ");
+            impl::writeJsonChar(write, order.chOrder);
+            write(", \"name\": \"");
+            write(order.name);
+            write("\", \"args\": ");
+            impl::writeJsonType(write, order.args);
+            write(", \"result\": ");
+            impl::writeJsonType(write, order.result);
+            write(", \"binaryPayloadSize\": ");
+            impl::writeJsonNumber(write, order.binaryPayloadSize);
+            write("}");
+        }
+        write("\n  ]\n}\n");
+    }
+} // namespace utcoupe::asserv::serial
+
+#endif // UTCOUPE_ASSERV_SERIAL_PROTOCOL_SCHEMA_HPP
@@ -0,0 +1,190 @@
+#ifndef UTCOUPE_ASSERV_SERIAL_RESPONSE_WRITER_HPP
+#define UTCOUPE_ASSERV_SERIAL_RESPONSE_WRITER_HPP
+
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/parse_error.hpp"
+#include "utcoupe/asserv/serial/parse_parameters.hpp"
+#include "utcoupe/asserv/serial/stream_decoder.hpp"
+#include "utcoupe/asserv/serial/traits.hpp"
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <variant>
+
+namespace utcoupe::asserv::serial {
+    /**
+     * Serializes order results into a buffer given by the caller, to be sent back to the host as is.
+     * 
+     * Responses use the same framing as orders: "c;x;y;\n" for FrameFormat::ASCII, or a binary frame (see encodeBinaryFrame) whose payload holds the values for FrameFormat::BINARY. Several responses can be appended to the same buffer before sending it.
+     * Values are written with std::to_chars (toChars for Fixed values) and never allocate. Results can be any Serializable value, a tuple of them, or a variant of those (only the active alternative is written). std::monostate writes a response without any value, to acknowledge an order.
+     * 
+     * @tparam Format The encoding of the responses on the link.
+     */
+    template<FrameFormat Format = FrameFormat::ASCII>
+    class ResponseWriter {
+    public:
+        explicit ResponseWriter(std::span<char> buffer) noexcept: m_buffer(buffer) {}
+        
+        /**
+         * Appends a response to the buffer.
+         * 
+         * Nothing is written if the response doesn't fit in the remaining space.
+         * 
+         * @param chOrder The character of the order this response answers to.
+         * @param value The result of the order.
+         * @return True if the response has been written, false else.
+         */
+        template<class ValueT>
+        bool write(char chOrder, const ValueT& value) noexcept {
+            beginResponse(chOrder);
+            append(value);
+            return endResponse();
+        }
+        
+        /**
+         * Appends a PARSE_ERROR_RESPONSE in place of the response of an order which couldn't be run, for the host to send it again.
+         * 
+         * @param chOrder The first character of the rejected frame, written as its code since it may be any byte.
+         * @param error The reason of the rejection, see OrderParser::lastError.
+         * @return True if the response has been written, false else.
+         */
+        bool writeError(char chOrder, ParseError error) noexcept {
+            return write(PARSE_ERROR_RESPONSE, std::tuple{ static_cast<std::uint8_t>(chOrder), static_cast<std::uint8_t>(error) });
+        }
+        
+        /**
+         * Starts a response whose values will be given by append, e.g. when they are only known at runtime.
+         * 
+         * @param chOrder The character of the order this response answers to.
+         */
+        void beginResponse(char chOrder) noexcept {
+            m_frameStart = m_size;
+            m_failed = false;
+            if constexpr (Format == FrameFormat::ASCII) {
+                put(chOrder);
+                put(VALUE_SEPARATOR);
+            } else {
+                put(BINARY_FRAME_START);
+                put(chOrder);
+                // Payload size, set by endResponse
+                put('\0');
+            }
+        }
+        
+        /**
+         * Appends values to the response started by beginResponse.
+         * 
+         * @param value A Serializable value, a tuple or a variant of them.
+         */
+        template<Serializable ValueT>
+        void append(const ValueT& value) noexcept {
+            if (m_failed) {
+                return;
+            }
+            if constexpr (Format == FrameFormat::ASCII) {
+                auto [end, ec] = toCharsOf(m_buffer.data() + m_size, m_buffer.data() + m_buffer.size(), value);
+                if (ec != std::errc{}) {
+                    m_failed = true;
+                    return;
+                }
+                m_size = static_cast<std::size_t>(end - m_buffer.data());
+                put(VALUE_SEPARATOR);
+            } else {
+                if (sizeof(ValueT) > m_buffer.size() - m_size) {
+                    m_failed = true;
+                    return;
+                }
+                impl::storeLittleEndian(m_buffer.data() + m_size, value);
+                m_size += sizeof(ValueT);
+            }
+        }
+        
+        void append(std::monostate) noexcept {}
+        
+        template<class... ValuesT>
+        void append(const std::tuple<ValuesT...>& values) noexcept {
+            std::apply([this](const auto&... value) { (append(value), ...); }, values);
+        }
+        
+        template<class... AlternativesT>
+        void append(const std::variant<AlternativesT...>& value) noexcept {
+            std::visit([this](const auto& alternative) { append(alternative); }, value);
+        }
+        
+        /**
+         * Ends the response started by beginResponse.
+         * 
+         * @return True if the whole response has been written, false if it didn't fit and has been discarded.
+         */
+        bool endResponse() noexcept {
+            if constexpr (Format == FrameFormat::ASCII) {
+                put(FRAME_TERMINATOR);
+            } else {
+                const std::size_t payloadSize = m_size - m_frameStart - BINARY_HEADER_SIZE;
+                if (!m_failed && payloadSize <= BINARY_MAX_PAYLOAD_SIZE && BINARY_CRC_SIZE <= m_buffer.size() - m_size) {
+                    m_buffer[m_frameStart + 2] = static_cast<char>(payloadSize);
+                    const std::uint16_t crc = crc16(std::string_view{ m_buffer.data() + m_frameStart, m_size - m_frameStart });
+                    impl::storeLittleEndian(m_buffer.data() + m_size, crc);
+                    m_size += BINARY_CRC_SIZE;
+                } else {
+                    m_failed = true;
+                }
+            }
+            
+            if (m_failed) {
+                m_size = m_frameStart;
+            }
+            return !m_failed;
+        }
+        
+        /** The responses written since the last clear. */
+        std::string_view data() const noexcept {
+            return { m_buffer.data(), m_size };
+        }
+        
+        /** Number of bytes still available in the buffer. */
+        std::size_t available() const noexcept {
+            return m_buffer.size() - m_size;
+        }
+        
+        /** Discards all the responses, e.g. once they have been sent. */
+        void clear() noexcept {
+            m_size = 0;
+        }
+        
+    private:
+        std::span<char> m_buffer;
+        std::size_t m_size = 0;
+        
+        /** Position of the response being written. */
+        std::size_t m_frameStart = 0;
+        
+        /** True if the response being written doesn't fit in the buffer. */
+        bool m_failed = false;
+        
+        template<Serializable ValueT>
+        static std::to_chars_result toCharsOf(char* first, char* last, const ValueT& value) noexcept {
+            if constexpr (FixedPoint<ValueT>) {
+                return toChars(first, last, value);
+            } else {
+                return std::to_chars(first, last, value);
+            }
+        }
+        
+        void put(char c) noexcept {
+            if (m_failed || m_size >= m_buffer.size()) {
+                m_failed = true;
+                return;
+            }
+            m_buffer[m_size++] = c;
+        }
+    };
+} // namespace utcoupe::asserv::serial
+
+#endif // UTCOUPE_ASSERV_SERIAL_RESPONSE_WRITER_HPP
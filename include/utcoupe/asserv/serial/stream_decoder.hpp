@@ -0,0 +1,243 @@
+#ifndef UTCOUPE_ASSERV_SERIAL_STREAM_DECODER_HPP
+#define UTCOUPE_ASSERV_SERIAL_STREAM_DECODER_HPP
+
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/order_parser.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+namespace utcoupe::asserv::serial {
+    /** Character ending every ASCII order frame on the serial link. */
+    inline constexpr char FRAME_TERMINATOR = '\n';
+    
+    /**
+     * Splits a serial byte stream into order frames and runs each of them as soon as it is complete.
+     * 
+     * Bytes can be given in chunks of any size, as delivered by UART/DMA interrupts. Complete ASCII frames lying inside a chunk are parsed in place, without any copy; only the beginning of a frame which isn't terminated yet is kept in a fixed-size buffer until the next chunks complete it.
+     * A frame longer than BufferSize is dropped up to its terminator.
+     * 
+     * With FrameFormat::BINARY, frames are delimited by their start byte and payload size instead of a terminator. They are always gathered in the buffer, and the decoder resynchronizes on the next start byte when a frame is corrupted.
+     * 
+     * @tparam Executor The class running the orders, see OrderParser.
+     * @tparam TableT The OrderTable the orders are selected from.
+     * @tparam BufferSize Maximum size of a frame, terminator excluded.
+     * @tparam Format The encoding of the orders on the link.
+     */
+    template<class Executor, class TableT, std::size_t BufferSize = 64, FrameFormat Format = FrameFormat::ASCII>
+    class StreamDecoder {
+    public:
+        StreamDecoder(OrderParser<Executor>& parser, const TableT& table): m_parser(parser), m_table(table) {}
+        
+        /**
+         * Decodes a chunk of the byte stream, running every order completed by this chunk.
+         * 
+         * @param chunk The received bytes.
+         * @param onResult Called with the result of OrderParser::parseAndRunOrder for each completed frame.
+         * @return The number of frames completed by this chunk, dropped ones included.
+         */
+        template<class ResultHandler>
+        std::size_t feed(std::string_view chunk, ResultHandler&& onResult) noexcept {
+            return feedFrames(chunk, [this, &onResult](const auto& frame) {
+                onResult(m_parser.parseAndRunOrder(m_table, frame));
+            });
+        }
+        
+        /**
+         * Splits a chunk of the byte stream into frames, without running them.
+         * 
+         * This lets the frames be decoded at reception and run later, see OrderQueue.
+         * 
+         * @param chunk The received bytes.
+         * @param onFrame Called for each completed frame with its content: a std::string_view for ASCII frames, a checked BinaryFrame for binary ones.
+         * @return The number of frames completed by this chunk, dropped ones included.
+         */
+        template<class FrameHandler>
+        std::size_t feedFrames(std::string_view chunk, FrameHandler&& onFrame) noexcept {
+            if constexpr (Format == FrameFormat::ASCII) {
+                return feedAscii(chunk, onFrame);
+            } else {
+                return feedBinary(chunk, onFrame);
+            }
+        }
+        
+        /**
+         * Decodes a chunk of the byte stream, ignoring the orders results.
+         * 
+         * @param chunk The received bytes.
+         * @return The number of frames completed by this chunk, dropped ones included.
+         */
+        std::size_t feed(std::string_view chunk) noexcept {
+            return feed(chunk, [](const auto&) {});
+        }
+        
+        /** Discards the frame being received, e.g. after a link error. */
+        void reset() noexcept {
+            m_size = 0;
+            m_overflowed = false;
+        }
+        
+        /** Number of bytes of the frame currently being received. */
+        std::size_t pendingSize() const noexcept {
+            return m_size;
+        }
+        
+        /** Number of frames dropped since the creation of the decoder because they exceeded BufferSize or were corrupted. */
+        std::size_t droppedFrames() const noexcept {
+            return m_droppedFrames.load(std::memory_order_relaxed);
+        }
+        
+    private:
+        OrderParser<Executor>& m_parser;
+        const TableT& m_table;
+        
+        std::array<char, BufferSize> m_buffer{};
+        std::size_t m_size = 0;
+        bool m_overflowed = false;
+        // Relaxed atomic, as it is read by the control loop while the receiving context, e.g. the serial interrupt, writes it
+        std::atomic<std::size_t> m_droppedFrames{ 0 };
+        
+        template<class FrameHandler>
+        std::size_t feedAscii(std::string_view chunk, FrameHandler& onFrame) noexcept {
+            std::size_t completedFrames = 0;
+            
+            while (!chunk.empty()) {
+                const std::size_t terminatorPos = chunk.find(FRAME_TERMINATOR);
+                if (terminatorPos == std::string_view::npos) {
+                    bufferPartialFrame(chunk);
+                    break;
+                }
+                
+                std::string_view frameEnd = chunk.substr(0, terminatorPos);
+                chunk.remove_prefix(terminatorPos + 1);
+                ++completedFrames;
+                
+                if (m_overflowed) {
+                    m_overflowed = false;
+                    m_size = 0;
+                    continue;
+                }
+                
+                if (m_size == 0) {
+                    dispatch(frameEnd, onFrame);
+                } else if (bufferPartialFrame(frameEnd)) {
+                    dispatch(std::string_view{ m_buffer.data(), m_size }, onFrame);
+                }
+                m_size = 0;
+                m_overflowed = false;
+            }
+            
+            return completedFrames;
+        }
+        
+        template<class FrameHandler>
+        std::size_t feedBinary(std::string_view chunk, FrameHandler& onFrame) noexcept {
+            std::size_t completedFrames = 0;
+            
+            // The buffered bytes are processed even once the chunk is consumed, as a resynchronization may leave whole frames in them
+            while (true) {
+                if (m_size == 0) {
+                    const std::size_t startPos = chunk.find(BINARY_FRAME_START);
+                    if (startPos == std::string_view::npos) {
+                        break;
+                    }
+                    chunk.remove_prefix(startPos);
+                }
+                
+                // The header has to be received first to know the size of the whole frame
+                const std::size_t expectedSize = m_size < BINARY_HEADER_SIZE
+                    ? BINARY_HEADER_SIZE
+                    : binaryFrameSize(static_cast<unsigned char>(m_buffer[2]));
+                if (expectedSize > BufferSize) {
+                    m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+                    resynchronize();
+                    continue;
+                }
+                
+                if (m_size < expectedSize) {
+                    const std::size_t copied = chunk.copy(m_buffer.data() + m_size, expectedSize - m_size);
+                    m_size += copied;
+                    chunk.remove_prefix(copied);
+                    if (m_size < expectedSize) {
+                        break;
+                    }
+                }
+                if (expectedSize == BINARY_HEADER_SIZE) {
+                    continue;
+                }
+                
+                ++completedFrames;
+                auto frame = checkBinaryFrame(std::string_view{ m_buffer.data(), expectedSize });
+                if (!frame) {
+                    m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+                    resynchronize();
+                    continue;
+                }
+                onFrame(*frame);
+                discard(expectedSize);
+            }
+            
+            return completedFrames;
+        }
+        
+        /**
+         * Appends bytes to the frame being received.
+         * 
+         * @return False if the frame doesn't fit in the buffer anymore, in which case it will be dropped.
+         */
+        bool bufferPartialFrame(std::string_view bytes) noexcept {
+            if (m_overflowed) {
+                return false;
+            }
+            if (bytes.size() > BufferSize - m_size) {
+                m_overflowed = true;
+                m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            m_size += bytes.copy(m_buffer.data() + m_size, bytes.size());
+            return true;
+        }
+        
+        /**
+         * Drops the start byte of the pending binary frame and moves the next start byte, if any, at the beginning of the buffer.
+         */
+        void resynchronize() noexcept {
+            discard(1);
+        }
+        
+        /**
+         * Drops the first bytes of the buffer and moves the next start byte after them, if any, at the beginning of the buffer.
+         */
+        void discard(std::size_t count) noexcept {
+            std::string_view pending{ m_buffer.data() + count, m_size - count };
+            const std::size_t startPos = pending.find(BINARY_FRAME_START);
+            if (startPos == std::string_view::npos) {
+                m_size = 0;
+                return;
+            }
+            m_size = pending.size() - startPos;
+            std::memmove(m_buffer.data(), pending.data() + startPos, m_size);
+        }
+        
+        template<class FrameHandler>
+        void dispatch(std::string_view frame, FrameHandler& onFrame) noexcept {
+            if (!frame.empty() && frame.back() == '\r') {
+                frame.remove_suffix(1);
+            }
+            if (frame.empty()) {
+                return;
+            }
+            if (frame.size() > BufferSize) {
+                m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            onFrame(frame);
+        }
+    };
+} // namespace utcoupe::asserv::serial
+
+#endif // UTCOUPE_ASSERV_SERIAL_STREAM_DECODER_HPP
@@ -0,0 +1,135 @@
+#ifndef UTCOUPE_ASSERV_SERIAL_TELEMETRY_HPP
+#define UTCOUPE_ASSERV_SERIAL_TELEMETRY_HPP
+
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/serial/response_writer.hpp"
+#include "utcoupe/asserv/tasks_dispatcher_like.concept.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace utcoupe::asserv::serial {
+    /** The values that can be streamed by TelemetryStreamer, combined as a bit mask. */
+    enum class TelemetryField : std::uint32_t {
+        POS = 1U << 0,
+        SPEED = 1U << 1,
+        CODER = 1U << 2,
+        TARGET_SPEED = 1U << 3,
+        POS_ID = 1U << 4
+    };
+    
+    /** Bit mask selecting every TelemetryField. */
+    inline constexpr std::uint32_t ALL_TELEMETRY_FIELDS = (1U << 5) - 1;
+    
+    constexpr std::uint32_t operator|(TelemetryField lhs, TelemetryField rhs) noexcept {
+        return static_cast<std::uint32_t>(lhs) | static_cast<std::uint32_t>(rhs);
+    }
+    
+    constexpr std::uint32_t operator|(std::uint32_t lhs, TelemetryField rhs) noexcept {
+        return lhs | static_cast<std::uint32_t>(rhs);
+    }
+    
+    /** Character identifying telemetry frames, which is also the character of the subscription order. */
+    inline constexpr char TELEMETRY_FRAME = static_cast<char>(OrderTypes::TELEMETRY);
+    
+    /**
+     * Pushes a set of values to the host at a fixed period, instead of letting it poll them with GET_POS, GET_SPD, ...
+     * 
+     * tick must be called once per control loop cycle. Every period, all the subscribed fields are read from the dispatcher getters and written in a single frame: "T;sequence;fields;values...;", fields being ordered as in TelemetryField. The sequence number increases by one for each frame, so the host can detect lost ones.
+     */
+    class TelemetryStreamer {
+    public:
+        /**
+         * @param tickPeriodUs The period of the control loop, in microseconds. It is clamped to 1, as the subscriptions divide by it.
+         */
+        explicit TelemetryStreamer(std::uint32_t tickPeriodUs) noexcept: m_tickPeriodUs(std::max<std::uint32_t>(1, tickPeriodUs)) {}
+        
+        /**
+         * Starts streaming some fields, replacing any previous subscription.
+         * 
+         * @param fields A mask of TelemetryField, 0 to stop streaming.
+         * @param periodMs The period between two frames, in milliseconds. It is rounded to a multiple of the control loop period, 0 stopping the streaming.
+         * @return False if the mask contains unknown fields, in which case the subscription is left untouched.
+         */
+        bool subscribe(std::uint32_t fields, std::uint32_t periodMs) noexcept {
+            if ((fields & ~ALL_TELEMETRY_FIELDS) != 0) {
+                return false;
+            }
+            
+            m_fields = fields;
+            const std::uint64_t periodUs = std::uint64_t{ periodMs } * 1000;
+            m_periodTicks = periodMs == 0 ? 0 : static_cast<std::uint32_t>(
+                std::max<std::uint64_t>(1, (periodUs + m_tickPeriodUs / 2) / m_tickPeriodUs)
+            );
+            m_ticksUntilNextFrame = m_periodTicks;
+            return true;
+        }
+        
+        /** Stops streaming. */
+        void unsubscribe() noexcept {
+            m_fields = 0;
+            m_periodTicks = 0;
+        }
+        
+        /** True if frames are currently streamed. */
+        bool isActive() const noexcept {
+            return m_fields != 0 && m_periodTicks != 0;
+        }
+        
+        /** The subscribed period, in control loop ticks. */
+        std::uint32_t periodTicks() const noexcept {
+            return m_periodTicks;
+        }
+        
+        /**
+         * Writes a frame if the period has elapsed since the last one.
+         * 
+         * @param dispatcher The dispatcher to read the fields from.
+         * @param writer The writer of the link the frames are streamed on.
+         * @return True if a frame has been written.
+         */
+        template<TasksDispatcherLike Dispatcher, FrameFormat Format>
+        bool tick(Dispatcher& dispatcher, ResponseWriter<Format>& writer) noexcept {
+            if (!isActive() || --m_ticksUntilNextFrame != 0) {
+                return false;
+            }
+            m_ticksUntilNextFrame = m_periodTicks;
+            
+            writer.beginResponse(TELEMETRY_FRAME);
+            writer.append(m_sequence);
+            writer.append(m_fields);
+            if (hasField(TelemetryField::POS)) {
+                writer.append(dispatcher.getPos());
+            }
+            if (hasField(TelemetryField::SPEED)) {
+                writer.append(dispatcher.getSpeed());
+            }
+            if (hasField(TelemetryField::CODER)) {
+                writer.append(dispatcher.getCoder());
+            }
+            if (hasField(TelemetryField::TARGET_SPEED)) {
+                writer.append(dispatcher.getTargetSpeed());
+            }
+            if (hasField(TelemetryField::POS_ID)) {
+                writer.append(dispatcher.getPosID());
+            }
+            
+            // A frame that doesn't fit is lost, the sequence number lets the host know it
+            ++m_sequence;
+            return writer.endResponse();
+        }
+        
+    private:
+        std::uint32_t m_tickPeriodUs;
+        std::uint32_t m_fields = 0;
+        std::uint32_t m_periodTicks = 0;
+        std::uint32_t m_ticksUntilNextFrame = 0;
+        std::uint32_t m_sequence = 0;
+        
+        bool hasField(TelemetryField field) const noexcept {
+            return (m_fields & static_cast<std::uint32_t>(field)) != 0;
+        }
+    };
+} // namespace utcoupe::asserv::serial
+
+#endif // UTCOUPE_ASSERV_SERIAL_TELEMETRY_HPP
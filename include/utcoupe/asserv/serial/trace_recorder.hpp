@@ -0,0 +1,424 @@
+#ifndef UTCOUPE_ASSERV_SERIAL_TRACE_RECORDER_HPP
+#define UTCOUPE_ASSERV_SERIAL_TRACE_RECORDER_HPP
+
+#include "utcoupe/asserv/control/pose.hpp"
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace utcoupe::asserv::serial {
+    /** Kind of a record of a trace, stored in its first byte. */
+    enum class TraceRecordType : std::uint8_t {
+        /** Marks the end of the records of a block. */
+        END = 0,
+        ASCII_FRAME = 1,
+        BINARY_FRAME = 2,
+        STATE = 3
+    };
+    
+    /** The state of the controller recorded every tick, quantized to integers so that it can be delta encoded. */
+    struct TraceState {
+        /** Unit of x and y, in millimeters. */
+        static constexpr float POSITION_UNIT = 0.1f;
+        
+        /** Unit of theta, in radians. */
+        static constexpr float ANGLE_UNIT = 0.0001f;
+        
+        std::int32_t x = 0;
+        std::int32_t y = 0;
+        std::int32_t theta = 0;
+        std::int32_t leftCoder = 0;
+        std::int32_t rightCoder = 0;
+        std::int32_t leftPwm = 0;
+        std::int32_t rightPwm = 0;
+        
+        static TraceState fromPose(const control::Pose& pose, std::int32_t leftCoder, std::int32_t rightCoder, std::int32_t leftPwm, std::int32_t rightPwm) noexcept {
+            return {
+                static_cast<std::int32_t>(std::lround(pose.x / POSITION_UNIT)),
+                static_cast<std::int32_t>(std::lround(pose.y / POSITION_UNIT)),
+                static_cast<std::int32_t>(std::lround(pose.theta / ANGLE_UNIT)),
+                leftCoder, rightCoder, leftPwm, rightPwm
+            };
+        }
+        
+        control::Pose pose() const noexcept {
+            return { static_cast<float>(x) * POSITION_UNIT, static_cast<float>(y) * POSITION_UNIT, static_cast<float>(theta) * ANGLE_UNIT };
+        }
+        
+        bool operator==(const TraceState&) const = default;
+    };
+    
+    /** A record read back from a trace. */
+    struct TraceRecord {
+        TraceRecordType type = TraceRecordType::END;
+        
+        /** Number of states recorded before this record since the start of the recording. */
+        std::uint32_t tick = 0;
+        
+        /** The order character of a BINARY_FRAME. */
+        char chOrder = '\0';
+        
+        /** The whole ASCII_FRAME, or the payload of a BINARY_FRAME. Points into the trace. */
+        std::string_view frame;
+        
+        /** The state of a STATE record. */
+        TraceState state;
+    };
+    
+    /** First bytes of an exported trace, followed by a version byte and the size of the blocks. */
+    inline constexpr std::string_view TRACE_MAGIC = "UTTR";
+    inline constexpr std::uint8_t TRACE_VERSION = 1;
+    inline constexpr std::size_t TRACE_HEADER_SIZE = 7;
+    
+    namespace impl {
+        /** Maximum size of a 32 bits LEB128 varint. */
+        inline constexpr std::size_t MAX_VARINT_SIZE = 5;
+        
+        constexpr std::uint32_t zigzag(std::int32_t value) noexcept {
+            return (static_cast<std::uint32_t>(value) << 1) ^ static_cast<std::uint32_t>(value >> 31);
+        }
+        
+        constexpr std::int32_t unzigzag(std::uint32_t value) noexcept {
+            return static_cast<std::int32_t>(value >> 1) ^ -static_cast<std::int32_t>(value & 1);
+        }
+        
+        /** Writes an unsigned LEB128 varint, returning its end. The buffer must hold MAX_VARINT_SIZE bytes. */
+        constexpr char* writeVarint(char* dst, std::uint32_t value) noexcept {
+            while (value >= 0x80) {
+                *dst++ = static_cast<char>((value & 0x7F) | 0x80);
+                value >>= 7;
+            }
+            *dst++ = static_cast<char>(value);
+            return dst;
+        }
+        
+        /** Reads an unsigned LEB128 varint from [first, last), or returns std::nullopt if it is truncated or too long. */
+        constexpr std::optional<std::uint32_t> readVarint(const char*& first, const char* last) noexcept {
+            std::uint32_t value = 0;
+            for (unsigned shift = 0; shift < 7 * MAX_VARINT_SIZE && first != last; shift += 7) {
+                const auto byte = static_cast<unsigned char>(*first++);
+                value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    return value;
+                }
+            }
+            return std::nullopt;
+        }
+        
+        /** The fields of a TraceState, in their encoding order. */
+        constexpr std::array<std::int32_t TraceState::*, 7> TRACE_STATE_FIELDS{
+            &TraceState::x, &TraceState::y, &TraceState::theta,
+            &TraceState::leftCoder, &TraceState::rightCoder, &TraceState::leftPwm, &TraceState::rightPwm
+        };
+    } // namespace impl
+    
+    /**
+     * Records the received order frames and the state of the controller in a fixed-size ring buffer, so that a match can be replayed afterwards (see simulation::replayTrace).
+     * 
+     * The buffer is split in BlockCount blocks of BlockSize bytes, starting with the tick of their first record. Inside a block, each record stores its tick and, for states, every field as a zigzag varint delta from the previous state: a robot moving smoothly costs a dozen bytes per tick. Records never span two blocks, so once the buffer is full the oldest block is simply overwritten and the remaining ones still decode on their own.
+     * 
+     * Nothing allocates and recording costs a few dozen nanoseconds, so it can run in the control loop during the whole match. The trace is retrieved with exportTo, e.g. to be dumped on the serial link after the match.
+     * 
+     * @tparam BlockSize The size of a block, bounding the size of a single record.
+     * @tparam BlockCount The number of blocks, the recorder keeping the last (BlockCount - 1) * BlockSize bytes at least.
+     */
+    template<std::size_t BlockSize = 256, std::size_t BlockCount = 64>
+    class TraceRecorder {
+        static_assert(BlockSize >= 64 && BlockSize <= UINT16_MAX, "Blocks must hold a whole state and their size must fit in 16 bits");
+        static_assert(BlockCount > 0 && BlockCount <= UINT16_MAX);
+        
+    public:
+        /** Size of the tick stored at the beginning of each block. */
+        static constexpr std::size_t BLOCK_HEADER_SIZE = sizeof(std::uint32_t);
+        
+        /** Size of the largest ASCII frame a block holds, bigger ones being dropped. A binary frame holds one byte less, its order character included. */
+        static constexpr std::size_t MAX_FRAME_SIZE = BlockSize - BLOCK_HEADER_SIZE - 2 * impl::MAX_VARINT_SIZE - 2;
+        
+        /** Records an ASCII order frame, at the current tick. */
+        void recordFrame(std::string_view frame) noexcept {
+            record([frame](char* dst, std::uint32_t tickDelta, const TraceState&) -> char* {
+                dst = writeHeader(dst, TraceRecordType::ASCII_FRAME, tickDelta);
+                return writeBytes(dst, frame);
+            }, frame.size());
+        }
+        
+        /** Records a checked binary order frame, at the current tick. */
+        void recordFrame(const BinaryFrame& frame) noexcept {
+            record([&frame](char* dst, std::uint32_t tickDelta, const TraceState&) -> char* {
+                dst = writeHeader(dst, TraceRecordType::BINARY_FRAME, tickDelta);
+                *dst++ = frame.chOrder;
+                return writeBytes(dst, frame.payload);
+            }, frame.payload.size() + 1);
+        }
+        
+        /** Records the state of the controller, then moves to the next tick. Should be called once per control loop. */
+        void recordState(const TraceState& state) noexcept {
+            record([&state](char* dst, std::uint32_t tickDelta, const TraceState& previous) -> char* {
+                dst = writeHeader(dst, TraceRecordType::STATE, tickDelta);
+                for (auto field : impl::TRACE_STATE_FIELDS) {
+                    dst = impl::writeVarint(dst, impl::zigzag(static_cast<std::int32_t>(static_cast<std::uint32_t>(state.*field) - static_cast<std::uint32_t>(previous.*field))));
+                }
+                return dst;
+            }, impl::MAX_VARINT_SIZE * impl::TRACE_STATE_FIELDS.size());
+            m_previous = state;
+            ++m_tick;
+        }
+        
+        /** Number of states recorded since the creation of the recorder. */
+        std::uint32_t tick() const noexcept {
+            return m_tick;
+        }
+        
+        /** Number of records too big for a block, which have been dropped. */
+        std::size_t droppedRecords() const noexcept {
+            return m_droppedRecords;
+        }
+        
+        /** Size of the trace written by exportTo. */
+        std::size_t exportSize() const noexcept {
+            return TRACE_HEADER_SIZE + m_usedBlocks * BlockSize;
+        }
+        
+        /**
+         * Writes the recorded trace: a header followed by the blocks from the oldest to the newest.
+         * 
+         * @return The size of the trace, or 0 if it doesn't fit in the buffer.
+         */
+        std::size_t exportTo(std::span<char> buffer) const noexcept {
+            if (buffer.size() < exportSize()) {
+                return 0;
+            }
+            char* dst = buffer.data();
+            dst = std::copy(TRACE_MAGIC.begin(), TRACE_MAGIC.end(), dst);
+            *dst++ = static_cast<char>(TRACE_VERSION);
+            impl::storeLittleEndian(dst, static_cast<std::uint16_t>(BlockSize));
+            dst += sizeof(std::uint16_t);
+            for (std::size_t i = 0; i < m_usedBlocks; ++i) {
+                const auto& block = m_blocks[(m_firstBlock + i) % BlockCount];
+                dst = std::copy(block.begin(), block.end(), dst);
+            }
+            return exportSize();
+        }
+        
+        /** Discards the whole trace, the ticks starting back from 0. */
+        void clear() noexcept {
+            m_firstBlock = 0;
+            m_usedBlocks = 0;
+            m_tick = 0;
+            m_droppedRecords = 0;
+        }
+        
+    private:
+        std::array<std::array<char, BlockSize>, BlockCount> m_blocks{};
+        std::size_t m_firstBlock = 0;
+        std::size_t m_usedBlocks = 0;
+        
+        /** Position of the end of the records in the newest block. */
+        std::size_t m_position = 0;
+        
+        std::uint32_t m_tick = 0;
+        
+        /** Tick of the last record of the newest block. */
+        std::uint32_t m_lastTick = 0;
+        
+        /** The last state recorded in the newest block, the next one being encoded as a delta from it. */
+        TraceState m_previous{};
+        
+        std::size_t m_droppedRecords = 0;
+        
+        static char* writeHeader(char* dst, TraceRecordType type, std::uint32_t tickDelta) noexcept {
+            *dst++ = static_cast<char>(type);
+            return impl::writeVarint(dst, tickDelta);
+        }
+        
+        /** Writes bytes preceded by their size. */
+        static char* writeBytes(char* dst, std::string_view bytes) noexcept {
+            dst = impl::writeVarint(dst, static_cast<std::uint32_t>(bytes.size()));
+            return std::copy(bytes.begin(), bytes.end(), dst);
+        }
+        
+        /**
+         * Appends a record to the newest block, or to a new block if it doesn't fit.
+         * 
+         * @param encode Writes the record given its tick delta and the previous state, and returns its end.
+         * @param payloadSize The size of the record besides its type, tick and size varints.
+         */
+        template<class EncoderT>
+        void record(EncoderT&& encode, std::size_t payloadSize) noexcept {
+            // Type, tick delta and size, plus the END marker following the record, see MAX_FRAME_SIZE
+            const std::size_t maxSize = payloadSize + 2 * impl::MAX_VARINT_SIZE + 2;
+            if (payloadSize > BlockSize || maxSize > BlockSize - BLOCK_HEADER_SIZE) {
+                ++m_droppedRecords;
+                return;
+            }
+            if (m_usedBlocks == 0) {
+                openBlock();
+            }
+            
+            if (maxSize > BlockSize - m_position) {
+                // The record may still fit once encoded, which is checked on a copy to fill the blocks up
+                std::array<char, BlockSize> scratch;
+                const auto size = static_cast<std::size_t>(encode(scratch.data(), m_tick - m_lastTick, m_previous) - scratch.data());
+                if (size + 1 <= BlockSize - m_position) {
+                    auto& block = currentBlock();
+                    std::copy_n(scratch.begin(), size, block.begin() + static_cast<std::ptrdiff_t>(m_position));
+                    endRecord(m_position + size);
+                    return;
+                }
+                openBlock();
+            }
+            
+            auto& block = currentBlock();
+            char* end = encode(block.data() + m_position, m_tick - m_lastTick, m_previous);
+            endRecord(static_cast<std::size_t>(end - block.data()));
+        }
+        
+        std::array<char, BlockSize>& currentBlock() noexcept {
+            return m_blocks[(m_firstBlock + m_usedBlocks - 1) % BlockCount];
+        }
+        
+        void endRecord(std::size_t end) noexcept {
+            m_position = end;
+            m_lastTick = m_tick;
+            currentBlock()[m_position] = static_cast<char>(TraceRecordType::END);
+        }
+        
+        void openBlock() noexcept {
+            if (m_usedBlocks < BlockCount) {
+                ++m_usedBlocks;
+            } else {
+                m_firstBlock = (m_firstBlock + 1) % BlockCount;
+            }
+            auto& block = currentBlock();
+            impl::storeLittleEndian(block.data(), m_tick);
+            m_position = BLOCK_HEADER_SIZE;
+            m_lastTick = m_tick;
+            m_previous = {};
+            block[m_position] = static_cast<char>(TraceRecordType::END);
+        }
+    };
+    
+    /**
+     * Reads back the records of a trace exported by a TraceRecorder.
+     */
+    class TraceReader {
+    public:
+        /**
+         * @param trace An exported trace, which must outlive the reader and its records.
+         * @return A reader positioned on the first record, or std::nullopt if the trace header is invalid.
+         */
+        static std::optional<TraceReader> open(std::string_view trace) noexcept {
+            if (trace.size() < TRACE_HEADER_SIZE || !trace.starts_with(TRACE_MAGIC) || static_cast<std::uint8_t>(trace[4]) != TRACE_VERSION) {
+                return std::nullopt;
+            }
+            std::uint16_t blockSize = 0;
+            impl::loadLittleEndian(trace.data() + 5, blockSize);
+            if (blockSize <= sizeof(std::uint32_t) || (trace.size() - TRACE_HEADER_SIZE) % blockSize != 0) {
+                return std::nullopt;
+            }
+            return TraceReader{ trace.substr(TRACE_HEADER_SIZE), blockSize };
+        }
+        
+        /**
+         * Reads the next record.
+         * 
+         * @return The record, or std::nullopt at the end of the trace or if it is corrupted (see corrupted).
+         */
+        std::optional<TraceRecord> next() noexcept {
+            while (!m_corrupted) {
+                if (m_cursor == nullptr || m_cursor == m_blockEnd || static_cast<TraceRecordType>(*m_cursor) == TraceRecordType::END) {
+                    if (!nextBlock()) {
+                        return std::nullopt;
+                    }
+                    continue;
+                }
+                
+                TraceRecord record;
+                if (readRecord(record)) {
+                    return record;
+                }
+                m_corrupted = true;
+            }
+            return std::nullopt;
+        }
+        
+        /** True if the reading stopped on a malformed record. */
+        bool corrupted() const noexcept {
+            return m_corrupted;
+        }
+        
+    private:
+        std::string_view m_blocks;
+        std::size_t m_blockSize;
+        std::size_t m_nextBlock = 0;
+        const char* m_cursor = nullptr;
+        const char* m_blockEnd = nullptr;
+        std::uint32_t m_tick = 0;
+        TraceState m_previous{};
+        bool m_corrupted = false;
+        
+        TraceReader(std::string_view blocks, std::size_t blockSize) noexcept: m_blocks(blocks), m_blockSize(blockSize) {}
+        
+        bool nextBlock() noexcept {
+            if (m_nextBlock * m_blockSize >= m_blocks.size()) {
+                return false;
+            }
+            const char* block = m_blocks.data() + m_nextBlock++ * m_blockSize;
+            impl::loadLittleEndian(block, m_tick);
+            m_cursor = block + sizeof(std::uint32_t);
+            m_blockEnd = block + m_blockSize;
+            m_previous = {};
+            return true;
+        }
+        
+        bool readRecord(TraceRecord& record) noexcept {
+            record.type = static_cast<TraceRecordType>(*m_cursor++);
+            auto tickDelta = impl::readVarint(m_cursor, m_blockEnd);
+            if (!tickDelta) {
+                return false;
+            }
+            m_tick += *tickDelta;
+            record.tick = m_tick;
+            
+            switch (record.type) {
+                case TraceRecordType::BINARY_FRAME:
+                    if (m_cursor == m_blockEnd) {
+                        return false;
+                    }
+                    record.chOrder = *m_cursor++;
+                    [[fallthrough]];
+                case TraceRecordType::ASCII_FRAME: {
+                    auto size = impl::readVarint(m_cursor, m_blockEnd);
+                    if (!size || *size > static_cast<std::size_t>(m_blockEnd - m_cursor)) {
+                        return false;
+                    }
+                    record.frame = std::string_view{ m_cursor, *size };
+                    m_cursor += *size;
+                    return true;
+                }
+                case TraceRecordType::STATE:
+                    for (auto field : impl::TRACE_STATE_FIELDS) {
+                        auto delta = impl::readVarint(m_cursor, m_blockEnd);
+                        if (!delta) {
+                            return false;
+                        }
+                        m_previous.*field = static_cast<std::int32_t>(static_cast<std::uint32_t>(m_previous.*field) + static_cast<std::uint32_t>(impl::unzigzag(*delta)));
+                    }
+                    record.state = m_previous;
+                    return true;
+                case TraceRecordType::END:
+                    break;
+            }
+            return false;
+        }
+    };
+} // namespace utcoupe::asserv::serial
+
+#endif // UTCOUPE_ASSERV_SERIAL_TRACE_RECORDER_HPP
@@ -1,6 +1,8 @@
 #ifndef UTCOUPE_ASSERV_SERIAL_TRAITS_HPP
 #define UTCOUPE_ASSERV_SERIAL_TRAITS_HPP
 
+#include "utcoupe/asserv/fixed_point.hpp"
+
 #include <charconv>
 #include <concepts>
 #include <type_traits>
@@ -16,7 +18,12 @@ namespace utcoupe::asserv::serial {
     /** Indicates wether if the templated type is handled by the parser. */
     template<typename T>
     // TODO Maybe add char as available type
-    concept Deserializable = std::integral<T> || std::floating_point<T>;
+    concept Deserializable = std::integral<T> || std::floating_point<T> || FixedPoint<T>;
+    
+    
+    /** Indicates wether if the templated type can be written as a single value of a response. */
+    template<typename T>
+    concept Serializable = Deserializable<T> && !std::same_as<T, bool>;
 } // namespace utcoupe::asserv::serial
 
 #endif // UTCOUPE_ASSERV_SERIAL_TRAITS_HPP
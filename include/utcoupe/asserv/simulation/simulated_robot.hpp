@@ -0,0 +1,644 @@
+#ifndef UTCOUPE_ASSERV_SIMULATION_SIMULATED_ROBOT_HPP
+#define UTCOUPE_ASSERV_SIMULATION_SIMULATED_ROBOT_HPP
+
+#include "utcoupe/asserv/control/goal_queue.hpp"
+#include "utcoupe/asserv/control/motion_limits.hpp"
+#include "utcoupe/asserv/control/odometry.hpp"
+#include "utcoupe/asserv/control/pid.hpp"
+#include "utcoupe/asserv/control/pose.hpp"
+#include "utcoupe/asserv/control/velocity_profile.hpp"
+#include "utcoupe/asserv/fixed_point.hpp"
+#include "utcoupe/asserv/serial/order_stats.hpp"
+#include "utcoupe/asserv/serial/telemetry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <tuple>
+#include <variant>
+
+namespace utcoupe::asserv::simulation {
+    /** Physical and control parameters of a SimulatedRobot. */
+    struct SimulationConfig {
+        /** Period of the control loop, in seconds. */
+        float period = 0.005f;
+        
+        /** Distance between the wheels, in millimeters. */
+        float wheelBase = 250.f;
+        
+        /** Resolution of the encoders, in millimeters per tick. */
+        float mmPerTick = 0.1f;
+        
+        /** Speed of a wheel at full PWM, in mm/s. */
+        float maxWheelSpeed = 1000.f;
+        
+        /** Time constant of the first-order lag of the motors, in seconds. */
+        float motorTimeConstant = 0.05f;
+        
+        /** The PWM commands are clamped to [-maxPwm, maxPwm]. */
+        int maxPwm = 255;
+        
+        control::MotionLimits limits{};
+        control::ProfileShape profileShape = control::ProfileShape::TRAPEZOIDAL;
+        
+        /** Gains of the wheel speed controllers, from mm/s to PWM. */
+        control::PidGains<float> wheelGains{ 0.3f, 20.f, 0.f };
+        
+        /** Gain correcting the distance lagging behind the profile, in 1/s. */
+        float positionGain = 5.f;
+        
+        /** Gain correcting the heading, in 1/s. */
+        float headingGain = 5.f;
+        
+        /** A goal is reached when the robot ends closer than that to its target, in millimeters. */
+        float distanceTolerance = 2.f;
+        
+        /** A rotation is reached when the robot ends closer than that to its target, in radians. */
+        float angleTolerance = 0.01f;
+        
+        /** Time after the end of the profile after which a goal is considered reached anyway, in seconds. */
+        float settleTimeout = 1.f;
+    };
+    
+    /** The values answered to the orders by a SimulatedRobot. */
+    using SimulationResult = std::variant<
+        // Acknowledgement of the orders without result
+        std::monostate,
+        // Goal identifiers, GET_LAST_ID, WHO_AMI
+        std::int32_t,
+        // GET_SPD, GET_TARGET_SPD, GET_CODER: left and right values
+        std::tuple<std::int32_t, std::int32_t>,
+        // GET_POS: x, y, angle
+        std::tuple<std::int32_t, std::int32_t, float>,
+        // GET_POS_ID: x, y, angle, last reached goal
+        std::tuple<std::int32_t, std::int32_t, float, std::int32_t>,
+        // DIAGNOSTICS, see serial::LatencySummary
+        std::tuple<std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t>
+    >;
+    
+    /**
+     * A differential drive robot implementing every order of the protocol, to test the strategy without any hardware.
+     * 
+     * The simulation runs the same control code as the asserv (GoalQueue, VelocityProfile, DualPid, Odometry) against a model of the robot: motors with a first-order lag and encoders quantized to whole ticks. It only advances when step is called, so it is deterministic and runs as fast as the host can compute it: a 100 s match takes a few milliseconds.
+     * Orders are meant to be run through an OrderParser and createAllOrders, like on the real robot.
+     */
+    class SimulatedRobot {
+    public:
+        using OrderReturnT = SimulationResult;
+        
+        /** Answered to WHO_AMI, so that the host knows it talks to a simulation. */
+        static constexpr std::int32_t WHO_AM_I = 2;
+        
+        explicit SimulatedRobot(const SimulationConfig& config = {}) noexcept:
+            m_config(config),
+            m_limits(config.limits),
+            m_pid({ Real{ config.period }, Real{ static_cast<float>(config.maxPwm) }, Real{ static_cast<float>(config.maxPwm) }, Real{ 0.02f } }),
+            m_odometry({ Real{ config.mmPerTick }, Real{ config.mmPerTick }, Real{ config.wheelBase } }),
+            m_telemetry(static_cast<std::uint32_t>(config.period * 1e6f)),
+            m_motorSmoothing(1.f - std::exp(-config.period / config.motorTimeConstant)) {
+            m_pid.setGains(control::PidTarget::BOTH, toRealGains(config.wheelGains.p, config.wheelGains.i, config.wheelGains.d));
+        }
+        
+        /** Advances the simulation by one period of the control loop. */
+        void step() noexcept {
+            m_command = computeCommand();
+            const auto [linear, angular] = m_command;
+            
+            if (m_halted || m_emergencyStop) {
+                m_targetSpeeds = {};
+                m_pwm = {};
+                m_pid.reset(convertWheels<Real>(m_measuredSpeeds));
+            } else if (m_mode != Mode::PWM) {
+                const float halfBase = m_config.wheelBase * 0.5f;
+                m_targetSpeeds = { linear - angular * halfBase, linear + angular * halfBase };
+                m_pwm = convertWheels<float>(m_pid.tick(convertWheels<Real>(m_targetSpeeds), convertWheels<Real>(m_measuredSpeeds)));
+            }
+            
+            simulateWheels();
+            ++m_steps;
+        }
+        
+        /** Advances the simulation by some time, rounded to whole periods. */
+        void run(float seconds) noexcept {
+            const auto steps = static_cast<std::uint64_t>(std::lround(seconds / m_config.period));
+            for (std::uint64_t i = 0; i < steps; ++i) {
+                step();
+            }
+        }
+        
+        /**
+         * Advances the simulation until all the goals are reached.
+         * 
+         * @param maxSeconds The maximum simulated time to wait for, rounded up to whole periods.
+         * @return False if some goals are still pending after maxSeconds.
+         */
+        bool runUntilIdle(float maxSeconds) noexcept {
+            const auto maxSteps = static_cast<std::uint64_t>(std::ceil(maxSeconds / m_config.period));
+            for (std::uint64_t i = 0; i < maxSteps && !isIdle(); ++i) {
+                step();
+            }
+            return isIdle();
+        }
+        
+        /** True if the robot has no goal to reach, nor any speed or PWM order running. */
+        bool isIdle() const noexcept {
+            return m_mode == Mode::IDLE || (m_mode == Mode::GOALS && m_goals.empty());
+        }
+        
+        /** Simulated time since the creation of the robot, in seconds. */
+        double time() const noexcept {
+            return static_cast<double>(m_steps) * static_cast<double>(m_config.period);
+        }
+        
+        /** The pose estimated by the odometry. */
+        control::Pose pose() const noexcept {
+            return m_odometry.pose();
+        }
+        
+        /** The actual pose of the simulated robot, which the odometry should follow. */
+        control::Pose truePose() const noexcept {
+            return m_truePose;
+        }
+        
+        control::WheelValues<float> pwm() const noexcept {
+            return m_pwm;
+        }
+        
+        /** Total ticks of the encoders, as answered to GET_CODER. */
+        control::WheelValues<std::int32_t> coders() const noexcept {
+            return { m_odometry.leftCoder(), m_odometry.rightCoder() };
+        }
+        
+        serial::TelemetryStreamer& telemetry() noexcept {
+            return m_telemetry;
+        }
+        
+        // State machine orders
+        
+        OrderReturnT cleanGoals() noexcept {
+            m_goals.clear();
+            m_goalStarted = false;
+            return {};
+        }
+        
+        OrderReturnT getLastID() noexcept {
+            return static_cast<std::int32_t>(m_goals.lastReachedId());
+        }
+        
+        /** Stops the motors and drops the goals until START. */
+        OrderReturnT halt() noexcept {
+            m_halted = true;
+            m_mode = Mode::IDLE;
+            return cleanGoals();
+        }
+        
+        OrderReturnT killGoal() noexcept {
+            m_goals.pop();
+            m_goalStarted = false;
+            return {};
+        }
+        
+        OrderReturnT pause() noexcept {
+            m_paused = true;
+            m_goalStarted = false;
+            return {};
+        }
+        
+        OrderReturnT pingPing() noexcept {
+            return {};
+        }
+        
+        OrderReturnT resetID() noexcept {
+            m_goals.resetIds();
+            return {};
+        }
+        
+        /** Resumes the goal paused by PAUSE, replanning it from where the robot stopped. */
+        OrderReturnT resume() noexcept {
+            m_paused = false;
+            return {};
+        }
+        
+        OrderReturnT start() noexcept {
+            m_halted = false;
+            return {};
+        }
+        
+        OrderReturnT whoAmi() noexcept {
+            return WHO_AM_I;
+        }
+        
+        // Configuration orders
+        
+        OrderReturnT setMaxAcc(float acc) noexcept {
+            if (acc > 0.f) {
+                m_limits.maxAcc = acc;
+            }
+            return {};
+        }
+        
+        OrderReturnT setMaxSpeed(float speed) noexcept {
+            if (speed > 0.f) {
+                m_limits.maxSpeed = speed;
+            }
+            return {};
+        }
+        
+        OrderReturnT setAllPID(float p, float i, float d) noexcept {
+            return setPID(control::PidTarget::BOTH, p, i, d);
+        }
+        
+        OrderReturnT setLeftPID(float p, float i, float d) noexcept {
+            return setPID(control::PidTarget::LEFT, p, i, d);
+        }
+        
+        OrderReturnT setRightPID(float p, float i, float d) noexcept {
+            return setPID(control::PidTarget::RIGHT, p, i, d);
+        }
+        
+        // Move orders
+        
+        /** Total ticks of the encoders. */
+        OrderReturnT getCoder() noexcept {
+            return std::tuple{ m_odometry.leftCoder(), m_odometry.rightCoder() };
+        }
+        
+        OrderReturnT getPos() noexcept {
+            const control::Pose current = pose();
+            return std::tuple{ roundToInt(current.x), roundToInt(current.y), current.theta };
+        }
+        
+        OrderReturnT getPosID() noexcept {
+            const control::Pose current = pose();
+            return std::tuple{ roundToInt(current.x), roundToInt(current.y), current.theta, static_cast<std::int32_t>(m_goals.lastReachedId()) };
+        }
+        
+        /** Measured speeds of the wheels, in mm/s. */
+        OrderReturnT getSpeed() noexcept {
+            return std::tuple{ roundToInt(m_measuredSpeeds[0]), roundToInt(m_measuredSpeeds[1]) };
+        }
+        
+        /** Speeds of the wheels requested by the control loop, in mm/s. */
+        OrderReturnT getTargetSpeed() noexcept {
+            return std::tuple{ roundToInt(m_targetSpeeds[0]), roundToInt(m_targetSpeeds[1]) };
+        }
+        
+        /** @return The identifier of the goal, or -1 if the queue is full. */
+        OrderReturnT doGoto(int x, int y, int direction) noexcept {
+            return pushGoal({ control::GoalType::GOTO, static_cast<float>(x), static_cast<float>(y), 0.f, direction });
+        }
+        
+        /** @return The identifier of the goal, or -1 if the queue is full. */
+        OrderReturnT doGotoWithAngle(int x, int y, float angle, int direction) noexcept {
+            return pushGoal({ control::GoalType::GOTO_WITH_ANGLE, static_cast<float>(x), static_cast<float>(y), angle, direction });
+        }
+        
+        OrderReturnT gotoWithAngle(int x, int y, float angle, int direction) noexcept {
+            return doGotoWithAngle(x, y, angle, direction);
+        }
+        
+        /** Drives the motors in open loop until another move order. */
+        OrderReturnT setPWM(int left, int right) noexcept {
+            m_mode = Mode::PWM;
+            m_pwm = {
+                static_cast<float>(std::clamp(left, -m_config.maxPwm, m_config.maxPwm)),
+                static_cast<float>(std::clamp(right, -m_config.maxPwm, m_config.maxPwm))
+            };
+            return {};
+        }
+        
+        /** Rotates by the difference between the angle and the current orientation, without wrapping it. */
+        OrderReturnT doRotation(float angle) noexcept {
+            return pushGoal({ control::GoalType::ROT, 0.f, 0.f, angle, 1 });
+        }
+        
+        /** Rotates to the angle through the shortest way. */
+        OrderReturnT doRotationModulo(float angle) noexcept {
+            return pushGoal({ control::GoalType::ROT_MODULO, 0.f, 0.f, angle, 1 });
+        }
+        
+        /** While enabled, the motors are stopped and the goals are paused. */
+        OrderReturnT setEmergencyStop(int enable) noexcept {
+            m_emergencyStop = enable != 0;
+            m_goalStarted = false;
+            return {};
+        }
+        
+        OrderReturnT setPos(int x, int y, float angle) noexcept {
+            m_odometry.setPose({ static_cast<float>(x), static_cast<float>(y), angle });
+            m_truePose = m_odometry.pose();
+            m_unwrappedTheta = angle;
+            m_goalStarted = false;
+            return {};
+        }
+        
+        /**
+         * Moves at constant speeds for some time, then stops.
+         * 
+         * @param linear The linear speed, in mm/s.
+         * @param angular The angular speed, in mrad/s.
+         * @param duration The duration, in milliseconds.
+         */
+        OrderReturnT setSpeed(int linear, int angular, int duration) noexcept {
+            m_mode = Mode::SPEED;
+            m_speedOrder = { static_cast<float>(linear), static_cast<float>(angular) * 0.001f };
+            m_speedOrderRemaining = static_cast<float>(duration) * 0.001f;
+            return {};
+        }
+        
+        // Telemetry and diagnostics orders
+        
+        /** @return 1 if the subscription is accepted, 0 otherwise. */
+        OrderReturnT setTelemetry(unsigned fields, unsigned periodMs) noexcept {
+            return std::int32_t{ m_telemetry.subscribe(fields, periodMs) ? 1 : 0 };
+        }
+        
+        OrderReturnT getDiagnostics(int chOrder) noexcept {
+            const auto summary = chOrder == 0
+                ? serial::orderStats().total()
+                : serial::orderStats().summary(static_cast<char>(chOrder));
+            return summary.asTuple();
+        }
+        
+    private:
+        enum class Mode : std::uint8_t {
+            IDLE,
+            GOALS,
+            SPEED,
+            PWM
+        };
+        
+        enum class Phase : std::uint8_t {
+            ROTATE,
+            MOVE,
+            FINAL_ROTATE
+        };
+        
+        /** Heading error above which the robot turns on the spot before moving, in radians. */
+        static constexpr float ROTATE_THRESHOLD = 0.1f;
+        
+        /** Distance to the target under which the heading isn't corrected anymore, in millimeters. */
+        static constexpr float HEADING_LOCK_DISTANCE = 20.f;
+        
+        SimulationConfig m_config;
+        control::MotionLimits m_limits;
+        // The control code computes in Real, like on the robot, and the model of the robot in float
+        control::DualPid<> m_pid;
+        control::Odometry<> m_odometry;
+        control::GoalQueue<> m_goals;
+        serial::TelemetryStreamer m_telemetry;
+        float m_motorSmoothing;
+        
+        std::uint64_t m_steps = 0;
+        Mode m_mode = Mode::IDLE;
+        bool m_halted = false;
+        bool m_paused = false;
+        bool m_emergencyStop = false;
+        
+        // Model of the robot
+        control::Pose m_truePose{};
+        control::WheelValues<float> m_wheelSpeeds{};
+        control::WheelValues<double> m_wheelPositions{};
+        control::WheelValues<std::int64_t> m_encoderTicks{};
+        
+        // Control loop
+        control::WheelValues<float> m_pwm{};
+        control::WheelValues<float> m_targetSpeeds{};
+        control::WheelValues<float> m_measuredSpeeds{};
+        float m_unwrappedTheta = 0.f;
+        
+        /** Linear and angular speeds requested on the last period. */
+        std::tuple<float, float> m_command{};
+        std::tuple<float, float> m_speedOrder{};
+        float m_speedOrderRemaining = 0.f;
+        
+        // Goal being executed
+        bool m_goalStarted = false;
+        Phase m_phase = Phase::MOVE;
+        float m_phaseTime = 0.f;
+        control::VelocityProfile m_profile;
+        float m_phaseStartX = 0.f;
+        float m_phaseStartY = 0.f;
+        float m_phaseStartAngle = 0.f;
+        float m_moveDirection = 1.f;
+        float m_exitSpeed = 0.f;
+        
+        static std::int32_t roundToInt(float value) noexcept {
+            return static_cast<std::int32_t>(std::lround(value));
+        }
+        
+        static float wrapAngle(float angle) noexcept {
+            return std::remainder(angle, 2.f * std::numbers::pi_v<float>);
+        }
+        
+        /** The linear speed requested on the last period, which unlike the measured one isn't disturbed by the encoder quantization. */
+        float linearSpeed() const noexcept {
+            return std::get<0>(m_command);
+        }
+        
+        control::MotionLimits angularLimits() const noexcept {
+            const float toAngular = 2.f / m_config.wheelBase;
+            return { m_limits.maxSpeed * toAngular, m_limits.maxAcc * toAngular, m_limits.maxJerk * toAngular, 0.f };
+        }
+        
+        OrderReturnT setPID(control::PidTarget target, float p, float i, float d) noexcept {
+            return std::int32_t{ m_pid.setGains(target, toRealGains(p, i, d)) ? 1 : 0 };
+        }
+        
+        static control::PidGains<Real> toRealGains(float p, float i, float d) noexcept {
+            return { Real{ p }, Real{ i }, Real{ d } };
+        }
+        
+        /** Converts the values of both wheels between the float of the model and the Real of the control code. */
+        template<class ToT, class FromT>
+        static control::WheelValues<ToT> convertWheels(const control::WheelValues<FromT>& values) noexcept {
+            return { static_cast<ToT>(values[0]), static_cast<ToT>(values[1]) };
+        }
+        
+        OrderReturnT pushGoal(const control::Goal& goal) noexcept {
+            auto id = m_goals.push(goal);
+            if (!id) {
+                return std::int32_t{ -1 };
+            }
+            if (m_mode != Mode::GOALS) {
+                m_mode = Mode::GOALS;
+                m_goalStarted = false;
+            }
+            return static_cast<std::int32_t>(*id);
+        }
+        
+        /** Linear and angular speeds requested for this period, in mm/s and rad/s. */
+        std::tuple<float, float> computeCommand() noexcept {
+            switch (m_mode) {
+                case Mode::GOALS:
+                    if (m_paused || m_emergencyStop || m_halted) {
+                        return { 0.f, 0.f };
+                    }
+                    return followGoals();
+                case Mode::SPEED:
+                    m_speedOrderRemaining -= m_config.period;
+                    if (m_speedOrderRemaining <= 0.f) {
+                        m_mode = Mode::IDLE;
+                    }
+                    return m_speedOrder;
+                case Mode::IDLE:
+                case Mode::PWM:
+                    break;
+            }
+            return { 0.f, 0.f };
+        }
+        
+        std::tuple<float, float> followGoals() noexcept {
+            const control::PlannedGoal* planned = m_goals.front();
+            if (planned == nullptr) {
+                return { 0.f, 0.f };
+            }
+            if (!m_goalStarted) {
+                startGoal(*planned);
+            }
+            
+            m_phaseTime += m_config.period;
+            const control::ProfileState reference = m_profile.at(m_phaseTime);
+            const bool profileDone = m_phaseTime >= m_profile.duration();
+            const control::Pose current = pose();
+            
+            if (m_phase == Phase::MOVE) {
+                const float dirX = planned->goal.x - m_phaseStartX;
+                const float dirY = planned->goal.y - m_phaseStartY;
+                const float length = std::hypot(dirX, dirY);
+                const float traveled = length > 0.f
+                    ? ((current.x - m_phaseStartX) * dirX + (current.y - m_phaseStartY) * dirY) / length
+                    : 0.f;
+                const float remaining = std::hypot(planned->goal.x - current.x, planned->goal.y - current.y);
+                
+                const bool reached = m_exitSpeed > 0.f || remaining < m_config.distanceTolerance;
+                if (profileDone && (reached || m_phaseTime > m_profile.duration() + m_config.settleTimeout)) {
+                    if (planned->goal.type == control::GoalType::GOTO_WITH_ANGLE) {
+                        startRotation(wrapAngle(planned->goal.angle - current.theta), Phase::FINAL_ROTATE);
+                        return { 0.f, 0.f };
+                    }
+                    completeGoal();
+                    return { m_moveDirection * m_exitSpeed, 0.f };
+                }
+                
+                float angular = 0.f;
+                if (remaining > HEADING_LOCK_DISTANCE) {
+                    float heading = std::atan2(planned->goal.y - current.y, planned->goal.x - current.x);
+                    if (m_moveDirection < 0.f) {
+                        heading += std::numbers::pi_v<float>;
+                    }
+                    angular = m_config.headingGain * wrapAngle(heading - current.theta);
+                }
+                const float linear = reference.speed + m_config.positionGain * (reference.position - traveled);
+                return { m_moveDirection * linear, angular };
+            }
+            
+            const float angleError = m_phaseStartAngle + reference.position - m_unwrappedTheta;
+            if (profileDone && (std::abs(angleError) < m_config.angleTolerance || m_phaseTime > m_profile.duration() + m_config.settleTimeout)) {
+                if (m_phase == Phase::ROTATE) {
+                    startMove(*planned);
+                    return { 0.f, 0.f };
+                }
+                completeGoal();
+                return { 0.f, 0.f };
+            }
+            return { 0.f, reference.speed + m_config.positionGain * angleError };
+        }
+        
+        /** Plans the goal at the front of the queue from the current state, the goals being planned in place. */
+        void startGoal(const control::PlannedGoal& planned) noexcept {
+            m_goalStarted = true;
+            const control::Pose current = pose();
+            m_goals.plan(current, std::abs(linearSpeed()), m_limits);
+            
+            switch (planned.goal.type) {
+                case control::GoalType::ROT:
+                    startRotation(planned.goal.angle - m_unwrappedTheta, Phase::FINAL_ROTATE);
+                    return;
+                case control::GoalType::ROT_MODULO:
+                    startRotation(wrapAngle(planned.goal.angle - current.theta), Phase::FINAL_ROTATE);
+                    return;
+                case control::GoalType::GOTO:
+                case control::GoalType::GOTO_WITH_ANGLE:
+                    break;
+            }
+            
+            const float dx = planned.goal.x - current.x;
+            const float dy = planned.goal.y - current.y;
+            const float bearing = std::atan2(dy, dx);
+            float headingError = wrapAngle(bearing - current.theta);
+            m_moveDirection = planned.goal.direction < 0 ? -1.f : 1.f;
+            if (planned.goal.direction == 0) {
+                m_moveDirection = std::abs(headingError) > std::numbers::pi_v<float> / 2.f ? -1.f : 1.f;
+            }
+            if (m_moveDirection < 0.f) {
+                headingError = wrapAngle(headingError + std::numbers::pi_v<float>);
+            }
+            
+            const bool moving = std::abs(linearSpeed()) > 1.f;
+            if (std::hypot(dx, dy) > m_config.distanceTolerance && std::abs(headingError) > ROTATE_THRESHOLD && !moving) {
+                startRotation(headingError, Phase::ROTATE);
+            } else {
+                startMove(planned);
+            }
+        }
+        
+        void startRotation(float angle, Phase phase) noexcept {
+            m_phase = phase;
+            m_phaseTime = 0.f;
+            m_phaseStartAngle = m_unwrappedTheta;
+            m_profile = control::VelocityProfile::plan(angle, 0.f, 0.f, angularLimits(), m_config.profileShape);
+        }
+        
+        void startMove(const control::PlannedGoal& planned) noexcept {
+            const control::Pose current = pose();
+            m_phase = Phase::MOVE;
+            m_phaseTime = 0.f;
+            m_phaseStartX = current.x;
+            m_phaseStartY = current.y;
+            m_exitSpeed = planned.exitSpeed;
+            const float distance = std::hypot(planned.goal.x - current.x, planned.goal.y - current.y);
+            m_profile = control::VelocityProfile::plan(distance, std::abs(linearSpeed()), m_exitSpeed, m_limits, m_config.profileShape);
+            m_exitSpeed = m_profile.exitSpeed();
+        }
+        
+        void completeGoal() noexcept {
+            m_goals.pop();
+            m_goalStarted = false;
+        }
+        
+        /** Applies the PWM to the motor model, then samples the encoders and updates the odometry. */
+        void simulateWheels() noexcept {
+            control::EncoderSample sample;
+            for (std::size_t w = 0; w < control::WHEEL_COUNT; ++w) {
+                const float commandedSpeed = m_pwm[w] / static_cast<float>(m_config.maxPwm) * m_config.maxWheelSpeed;
+                m_wheelSpeeds[w] += (commandedSpeed - m_wheelSpeeds[w]) * m_motorSmoothing;
+                m_wheelPositions[w] += static_cast<double>(m_wheelSpeeds[w]) * static_cast<double>(m_config.period);
+            }
+            
+            // The true pose follows the exact wheel displacements, the odometry only sees whole ticks
+            const float left = m_wheelSpeeds[0] * m_config.period;
+            const float right = m_wheelSpeeds[1] * m_config.period;
+            const float midTheta = m_truePose.theta + (right - left) / (2.f * m_config.wheelBase);
+            m_truePose.x += (left + right) * 0.5f * std::cos(midTheta);
+            m_truePose.y += (left + right) * 0.5f * std::sin(midTheta);
+            m_truePose.theta = wrapAngle(m_truePose.theta + (right - left) / m_config.wheelBase);
+            
+            control::WheelValues<std::int64_t> ticks;
+            for (std::size_t w = 0; w < control::WHEEL_COUNT; ++w) {
+                ticks[w] = static_cast<std::int64_t>(std::floor(m_wheelPositions[w] / static_cast<double>(m_config.mmPerTick)));
+                m_measuredSpeeds[w] = static_cast<float>(ticks[w] - m_encoderTicks[w]) * m_config.mmPerTick / m_config.period;
+            }
+            sample.left = static_cast<std::int32_t>(ticks[0] - m_encoderTicks[0]);
+            sample.right = static_cast<std::int32_t>(ticks[1] - m_encoderTicks[1]);
+            m_encoderTicks = ticks;
+            
+            const float previousTheta = m_odometry.pose().theta;
+            m_odometry.update(sample);
+            m_unwrappedTheta += wrapAngle(m_odometry.pose().theta - previousTheta);
+        }
+    };
+} // namespace utcoupe::asserv::simulation
+
+#endif // UTCOUPE_ASSERV_SIMULATION_SIMULATED_ROBOT_HPP
@@ -0,0 +1,140 @@
+#ifndef UTCOUPE_ASSERV_SIMULATION_TRACE_REPLAY_HPP
+#define UTCOUPE_ASSERV_SIMULATION_TRACE_REPLAY_HPP
+
+#include "utcoupe/asserv/serial/order_batch.hpp"
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/serial/trace_recorder.hpp"
+#include "utcoupe/asserv/simulation/simulated_robot.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <optional>
+#include <string_view>
+
+namespace utcoupe::asserv::simulation {
+    /** Maximum differences between a trace and its replay before they are considered diverging. */
+    struct ReplayTolerance {
+        /** In millimeters. */
+        float position = 5.f;
+        
+        /** In radians. */
+        float angle = 0.05f;
+    };
+    
+    /** The outcome of replayTrace. */
+    struct ReplayReport {
+        /** False if the trace couldn't be read entirely, the report then covers the records before the corruption. */
+        bool valid = true;
+        
+        std::uint32_t framesRun = 0;
+        
+        /** Frames which were rejected by the parser, as unknown or malformed orders. */
+        std::uint32_t framesRejected = 0;
+        
+        std::uint32_t statesCompared = 0;
+        
+        float maxPositionError = 0.f;
+        float maxAngleError = 0.f;
+        
+        /** The first tick whose replayed state is out of tolerance, if any. */
+        std::optional<std::uint32_t> firstDivergence;
+        
+        bool diverged() const noexcept {
+            return !valid || firstDivergence.has_value();
+        }
+    };
+    
+    /** The state of a simulated robot, as it is recorded by a serial::TraceRecorder. */
+    inline serial::TraceState traceState(const SimulatedRobot& robot) noexcept {
+        const auto coders = robot.coders();
+        const auto pwm = robot.pwm();
+        return serial::TraceState::fromPose(robot.pose(), coders[0], coders[1], static_cast<std::int32_t>(pwm[0]), static_cast<std::int32_t>(pwm[1]));
+    }
+    
+    /**
+     * Replays a trace recorded on the robot through the order parser and a SimulatedRobot, and compares the simulated states to the recorded ones.
+     * 
+     * A trace cut by the ring buffer starts the simulation from its first recorded state, the robot being at rest and without goals: it diverges if the robot was moving or had pending goals at that time. Each frame is run once the simulation reaches its tick, batch frames through an OrderBatch like on the robot, and each recorded state is compared to the simulated one after the same number of ticks.
+     * 
+     * @param trace A trace exported by serial::TraceRecorder::exportTo.
+     * @param config The simulated robot, which should match the recorded one.
+     * @param tolerance The differences above which the replay diverges.
+     */
+    inline ReplayReport replayTrace(std::string_view trace, const SimulationConfig& config = {}, const ReplayTolerance& tolerance = {}) noexcept {
+        static constexpr auto allOrders = serial::makeOrderTable(serial::createAllOrders<SimulatedRobot>());
+        
+        ReplayReport report;
+        auto reader = serial::TraceReader::open(trace);
+        if (!reader) {
+            report.valid = false;
+            return report;
+        }
+        
+        SimulatedRobot robot{ config };
+        serial::OrderParser parser{ robot };
+        serial::OrderBatch batch{ allOrders };
+        std::optional<std::uint32_t> ticks;
+        auto runFrame = [&parser, &batch](const auto& frame) {
+            if (serial::isBatchFrame(frame)) {
+                return batch.decode(frame) && batch.run(parser) > 0;
+            }
+            return parser.parseAndRunOrder(allOrders, frame).has_value();
+        };
+        auto stepUntil = [&robot, &ticks](std::uint32_t tick) {
+            for (; *ticks < tick; ++*ticks) {
+                robot.step();
+            }
+        };
+        
+        while (auto record = reader->next()) {
+            if (!ticks) {
+                ticks = record->tick;
+            }
+            
+            switch (record->type) {
+                case serial::TraceRecordType::ASCII_FRAME:
+                case serial::TraceRecordType::BINARY_FRAME: {
+                    stepUntil(record->tick);
+                    const bool run = record->type == serial::TraceRecordType::ASCII_FRAME
+                        ? runFrame(record->frame)
+                        : runFrame(serial::BinaryFrame{ record->chOrder, record->frame });
+                    ++(run ? report.framesRun : report.framesRejected);
+                    break;
+                }
+                case serial::TraceRecordType::STATE: {
+                    const control::Pose recorded = record->state.pose();
+                    if (report.statesCompared == 0 && record->tick > 0) {
+                        // The state is recorded after the tick, the simulation resumes at the next one
+                        robot.setPos(static_cast<int>(std::lround(recorded.x)), static_cast<int>(std::lround(recorded.y)), recorded.theta);
+                        ticks = record->tick + 1;
+                        ++report.statesCompared;
+                        break;
+                    }
+                    
+                    stepUntil(record->tick + 1);
+                    const control::Pose simulated = robot.pose();
+                    const float positionError = std::hypot(simulated.x - recorded.x, simulated.y - recorded.y);
+                    const float angleError = std::abs(std::remainder(simulated.theta - recorded.theta, 2.f * std::numbers::pi_v<float>));
+                    report.maxPositionError = std::max(report.maxPositionError, positionError);
+                    report.maxAngleError = std::max(report.maxAngleError, angleError);
+                    if (!report.firstDivergence && (positionError > tolerance.position || angleError > tolerance.angle)) {
+                        report.firstDivergence = record->tick;
+                    }
+                    ++report.statesCompared;
+                    break;
+                }
+                case serial::TraceRecordType::END:
+                    break;
+            }
+        }
+        
+        report.valid = !reader->corrupted();
+        return report;
+    }
+} // namespace utcoupe::asserv::simulation
+
+#endif // UTCOUPE_ASSERV_SIMULATION_TRACE_REPLAY_HPP
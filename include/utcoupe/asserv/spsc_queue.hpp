@@ -0,0 +1,96 @@
+#ifndef UTCOUPE_ASSERV_SPSC_QUEUE_HPP
+#define UTCOUPE_ASSERV_SPSC_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace utcoupe::asserv {
+    /** Size of a cache line, used to keep the producer and consumer indices apart. */
+    inline constexpr std::size_t CACHE_LINE_SIZE = 64;
+    
+    /**
+     * A bounded, wait-free queue with a single producer and a single consumer.
+     * 
+     * The producer (e.g. a serial interrupt) only calls push, and the consumer (e.g. the control loop) only calls pop; both can run concurrently without any lock. Items are stored inline, the queue never allocates.
+     * 
+     * @tparam T The type of the items, which must be default-constructible.
+     * @tparam Capacity The maximum number of items, which must be a power of two.
+     */
+    template<class T, std::size_t Capacity>
+    class SpscQueue {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "The capacity must be a power of two.");
+        static_assert(std::atomic<std::size_t>::is_always_lock_free, "The queue indices must be lock-free.");
+        
+    public:
+        /**
+         * Adds an item at the end of the queue. Must only be called by the producer.
+         * 
+         * @param item The item to add.
+         * @return False if the queue is full, in which case the item isn't added.
+         */
+        bool push(T item) noexcept {
+            const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_head.load(std::memory_order_acquire) >= Capacity) {
+                return false;
+            }
+            m_items[tail & (Capacity - 1)] = std::move(item);
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+        
+        /**
+         * Removes the first item of the queue. Must only be called by the consumer.
+         * 
+         * @return The removed item, or std::nullopt if the queue is empty.
+         */
+        std::optional<T> pop() noexcept {
+            const std::size_t head = m_head.load(std::memory_order_relaxed);
+            if (head == m_tail.load(std::memory_order_acquire)) {
+                return std::nullopt;
+            }
+            std::optional<T> item{ std::move(m_items[head & (Capacity - 1)]) };
+            m_head.store(head + 1, std::memory_order_release);
+            return item;
+        }
+        
+        /**
+         * Gives the first item of the queue without removing it. Must only be called by the consumer.
+         * 
+         * @return A pointer to the first item, valid until the next pop, or nullptr if the queue is empty.
+         */
+        const T* front() const noexcept {
+            const std::size_t head = m_head.load(std::memory_order_relaxed);
+            if (head == m_tail.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+            return &m_items[head & (Capacity - 1)];
+        }
+        
+        /** Number of items in the queue. Only exact when called from the producer or the consumer while the other one is idle. */
+        std::size_t size() const noexcept {
+            return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+        }
+        
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+        
+        static constexpr std::size_t capacity() noexcept {
+            return Capacity;
+        }
+        
+    private:
+        std::array<T, Capacity> m_items{};
+        
+        /** Index of the next item to pop, only written by the consumer. */
+        alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_head{ 0 };
+        
+        /** Index of the next item to push, only written by the producer. */
+        alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_tail{ 0 };
+    };
+} // namespace utcoupe::asserv
+
+#endif // UTCOUPE_ASSERV_SPSC_QUEUE_HPP
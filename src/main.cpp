@@ -1,6 +1,305 @@
-#include <iostream>
+#include "utcoupe/asserv/control/control_loop.hpp"
+#include "utcoupe/asserv/serial/emergency_filter.hpp"
+#include "utcoupe/asserv/serial/order_batch.hpp"
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/parse_decimal.hpp"
+#include "utcoupe/asserv/serial/parse_error.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/serial/response_writer.hpp"
+#include "utcoupe/asserv/serial/stream_decoder.hpp"
+#include "utcoupe/asserv/serial/trace_recorder.hpp"
+#include "utcoupe/asserv/simulation/simulated_robot.hpp"
+#include "utcoupe/asserv/simulation/trace_replay.hpp"
+#include "utcoupe/asserv/tasks_dispatcher_like.concept.hpp"
 
-int main(int argc, char **argv) {
-    std::cout << "Hello, world!" << std::endl;
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+    using namespace utcoupe::asserv;
+    using Clock = std::chrono::steady_clock;
+    using Robot = simulation::SimulatedRobot;
+    
+    static_assert(TasksDispatcherLike<Robot>);
+    
+    constexpr auto allOrders = serial::makeOrderTable(serial::createAllOrders<Robot>());
+    
+    /** Size of the longest ASCII frame accepted, terminator excluded: a batch of about 16 orders. */
+    constexpr std::size_t FRAME_BUFFER_SIZE = 512;
+    
+    /** Records the run, with blocks holding the longest frame accepted so that no frame run is missing from the trace. */
+    using TraceRecorder = serial::TraceRecorder<FRAME_BUFFER_SIZE + 16>;
+    static_assert(TraceRecorder::MAX_FRAME_SIZE >= FRAME_BUFFER_SIZE);
+    
+    /** Bytes handled per tick at most, the rest waiting in the link for the next ticks, so that a host flooding it can't delay the control. */
+    constexpr std::size_t MAX_RECEIVED_PER_TICK = 2 * FRAME_BUFFER_SIZE;
+    
+    volatile std::sig_atomic_t g_stopRequested = 0;
+    
+    extern "C" void requestStop(int) {
+        g_stopRequested = 1;
+    }
+    
+    struct Options {
+        std::chrono::microseconds tick{ 5000 };
+        
+        /** Duration of the run in seconds, 0 to run until interrupted. */
+        float duration = 0.f;
+        
+        bool pty = false;
+        
+        /** The device the orders are read from and answered to, stdin and stdout if empty. */
+        const char* link = nullptr;
+        
+        /** The file the trace of the run is written to on exit, for tools/trace_replay, none if empty. */
+        const char* trace = nullptr;
+    };
+    
+    void printUsage(const char* program) {
+        std::fprintf(stderr, "usage: %s [--tick-us=<period>] [--duration=<s>] [--pty | --link=<device>] [--trace=<file>]\n", program);
+    }
+    
+    bool parseOption(std::string_view arg, std::string_view name, float& value) {
+        if (!arg.starts_with(name)) {
+            return false;
+        }
+        arg.remove_prefix(name.size());
+        return serial::impl::from_chars_fp(arg.data(), arg.data() + arg.size(), value) == arg.data() + arg.size();
+    }
+    
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view arg = argv[i];
+            float tickUs = 0.f;
+            if (parseOption(arg, "--tick-us=", tickUs)) {
+                if (tickUs < 1.f) {
+                    return false;
+                }
+                options.tick = std::chrono::microseconds{ static_cast<std::int64_t>(tickUs) };
+            } else if (parseOption(arg, "--duration=", options.duration)) {
+                if (options.duration < 0.f) {
+                    return false;
+                }
+            } else if (arg == "--pty") {
+                options.pty = true;
+            } else if (arg.starts_with("--link=")) {
+                options.link = argv[i] + std::string_view{ "--link=" }.size();
+            } else if (arg.starts_with("--trace=")) {
+                options.trace = argv[i] + std::string_view{ "--trace=" }.size();
+            } else {
+                return false;
+            }
+        }
+        return !(options.pty && options.link != nullptr);
+    }
+    
+    bool setNonBlocking(int fd) {
+        const int flags = fcntl(fd, F_GETFL);
+        return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+    
+    /**
+     * Opens a pseudo terminal whose slave side the host connects to, like to the serial port of the robot.
+     * 
+     * @return The master side, or -1 on error.
+     */
+    int openPty() {
+        const int fd = posix_openpt(O_RDWR | O_NOCTTY);
+        if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) {
+            return -1;
+        }
+        termios attributes{};
+        if (tcgetattr(fd, &attributes) == 0) {
+            cfmakeraw(&attributes);
+            tcsetattr(fd, TCSANOW, &attributes);
+        }
+        std::fprintf(stderr, "link: %s\n", ptsname(fd));
+        return fd;
+    }
+    
+    /** A serial link on file descriptors, never blocking the control loop. */
+    class Link {
+    public:
+        Link(int in, int out) noexcept: m_in(in), m_out(out) {}
+        
+        /** Reads up to maxSize of the bytes received since the last call, empty if there are none. */
+        std::string_view receive(std::size_t maxSize) noexcept {
+            const ssize_t size = read(m_in, m_buffer.data(), std::min(maxSize, m_buffer.size()));
+            return size > 0 ? std::string_view{ m_buffer.data(), static_cast<std::size_t>(size) } : std::string_view{};
+        }
+        
+        /** Sends the responses written so far. What the link can't take right away is dropped, rather than delaying the loop. */
+        void flush(serial::ResponseWriter<>& writer) noexcept {
+            const std::string_view data = writer.data();
+            if (!data.empty() && write(m_out, data.data(), data.size()) < 0 && errno != EAGAIN) {
+                ++m_writeErrors;
+            }
+            writer.clear();
+        }
+        
+        std::size_t writeErrors() const noexcept {
+            return m_writeErrors;
+        }
+        
+    private:
+        int m_in;
+        int m_out;
+        std::array<char, 256> m_buffer{};
+        std::size_t m_writeErrors = 0;
+    };
+    
+    /** Writes a response with the given function, sending the pending ones first if the buffer is full. */
+    template<class WriteT>
+    void respond(Link& link, serial::ResponseWriter<>& writer, WriteT&& writeResponse) {
+        if (!writeResponse(writer)) {
+            link.flush(writer);
+            writeResponse(writer);
+        }
+    }
+    
+    /** Sleeps until an absolute time of the monotonic clock, or until a signal is received. */
+    void sleepUntil(Clock::time_point deadline) {
+        const auto sinceEpoch = deadline.time_since_epoch();
+        const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(sinceEpoch);
+        timespec wakeUp{};
+        wakeUp.tv_sec = seconds.count();
+        wakeUp.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch - seconds).count();
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeUp, nullptr);
+    }
+    
+    /** Writes the trace recorded during the run, in the format read by tools/trace_replay. */
+    bool writeTrace(const char* path, const TraceRecorder& recorder) {
+        std::vector<char> trace(recorder.exportSize());
+        const std::size_t size = recorder.exportTo(trace);
+        std::FILE* file = std::fopen(path, "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        const bool written = std::fwrite(trace.data(), 1, size, file) == size;
+        return std::fclose(file) == 0 && written;
+    }
+    
+    void printStats(const control::LoopStats& stats, const serial::StreamDecoder<Robot, decltype(allOrders), FRAME_BUFFER_SIZE>& decoder, const Link& link, const TraceRecorder& recorder) {
+        auto us = [](std::chrono::nanoseconds duration) { return static_cast<double>(duration.count()) / 1e3; };
+        std::fprintf(stderr, "ticks:          %llu\n", static_cast<unsigned long long>(stats.ticks));
+        std::fprintf(stderr, "overruns:       %llu (%llu ticks missed)\n", static_cast<unsigned long long>(stats.overruns), static_cast<unsigned long long>(stats.missedTicks));
+        std::fprintf(stderr, "jitter:         min %.1f us, mean %.1f us, max %.1f us\n", us(stats.minJitter), us(stats.meanJitter()), us(stats.maxJitter));
+        std::fprintf(stderr, "max tick:       %.1f us\n", us(stats.maxDuration));
+        std::fprintf(stderr, "bad orders:     %u\n", serial::parseErrors().total());
+        std::fprintf(stderr, "frames dropped: %zu\n", decoder.droppedFrames());
+        std::fprintf(stderr, "write errors:   %zu\n", link.writeErrors());
+        std::fprintf(stderr, "trace dropped:  %zu records\n", recorder.droppedRecords());
+    }
+} // namespace
+
+/**
+ * Runs the asserv on Linux: the control loop of the simulated robot at a fixed rate, driven by the orders of a serial link.
+ * 
+ * The link is stdin and stdout by default, e.g. to pipe orders in, a pseudo terminal the host connects to with --pty, or any device with --link, e.g. a USB serial adapter. Each tick reads a bounded number of bytes from the link and applies the emergency stops detected in every chunk before running its orders, a batch frame being run as a whole and acknowledged once, then steps the robot and streams the telemetry. Timing statistics are printed on exit, after --duration seconds or on SIGINT or SIGTERM.
+ * 
+ * The received frames and the state of the robot after each tick are recorded by a TraceRecorder, whose trace is written on exit with --trace to be replayed by tools/trace_replay.
+ */
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    int in = STDIN_FILENO;
+    int out = STDOUT_FILENO;
+    if (options.pty) {
+        in = out = openPty();
+    } else if (options.link != nullptr) {
+        in = out = open(options.link, O_RDWR | O_NOCTTY);
+    }
+    if (in < 0 || !setNonBlocking(in) || !setNonBlocking(out)) {
+        std::fprintf(stderr, "cannot open the link\n");
+        return 1;
+    }
+    Link link{ in, out };
+    
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+    
+    simulation::SimulationConfig config;
+    config.period = std::chrono::duration<float>(options.tick).count();
+    Robot robot{ config };
+    
+    serial::OrderParser parser{ robot };
+    serial::StreamDecoder<Robot, decltype(allOrders), FRAME_BUFFER_SIZE> decoder{ parser, allOrders };
+    serial::OrderBatch batch{ allOrders };
+    serial::EmergencyFilter emergencyFilter;
+    TraceRecorder recorder;
+    std::array<char, 512> responses{};
+    serial::ResponseWriter writer{ responses };
+    
+    const auto start = Clock::now();
+    const auto end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(options.duration));
+    control::FixedRateLoop<Clock> loop{ options.tick, start };
+    
+    while (g_stopRequested == 0 && (options.duration == 0.f || loop.deadline() < end)) {
+        sleepUntil(loop.deadline());
+        if (g_stopRequested != 0) {
+            break;
+        }
+        loop.beginTick(Clock::now());
+        
+        for (std::size_t budget = MAX_RECEIVED_PER_TICK; budget > 0;) {
+            const std::string_view chunk = link.receive(budget);
+            if (chunk.empty()) {
+                break;
+            }
+            budget -= chunk.size();
+            
+            // Applied before the orders of the chunk are run, so that a stop never waits behind them
+            emergencyFilter.feed(chunk);
+            emergencyFilter.apply(robot);
+            decoder.feedFrames(chunk, [&](std::string_view frame) {
+                recorder.recordFrame(frame);
+                if (serial::isBatchFrame(frame)) {
+                    const std::size_t runOrders = batch.decode(frame) ? batch.run(parser) : 0;
+                    respond(link, writer, [&](serial::ResponseWriter<>& responseWriter) {
+                        // A batch is acknowledged once, with the number of orders run
+                        return runOrders > 0 ? responseWriter.write(serial::BATCH_FRAME, runOrders) : responseWriter.writeError(serial::BATCH_FRAME, batch.lastError());
+                    });
+                    return;
+                }
+                
+                const auto result = parser.parseAndRunOrder(allOrders, frame);
+                respond(link, writer, [&](serial::ResponseWriter<>& responseWriter) {
+                    // A rejected order is answered with its error, for the host to send it again
+                    return result ? responseWriter.write(frame.front(), *result) : responseWriter.writeError(frame.front(), parser.lastError());
+                });
+            });
+        }
+        
+        robot.step();
+        recorder.recordState(simulation::traceState(robot));
+        robot.telemetry().tick(robot, writer);
+        link.flush(writer);
+        
+        loop.endTick(Clock::now());
+    }
+    
+    printStats(loop.stats(), decoder, link, recorder);
+    if (options.trace != nullptr && !writeTrace(options.trace, recorder)) {
+        std::fprintf(stderr, "cannot write the trace to %s\n", options.trace);
+        return 1;
+    }
     return 0;
 }
@@ -0,0 +1,79 @@
+#include <boost/ut.hpp>
+
+#include "utcoupe/asserv/control/control_loop.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <ratio>
+
+using namespace std::chrono_literals;
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+namespace {
+    /** A clock which only moves when told to, to check the schedule without sleeping. */
+    struct FakeClock {
+        using rep = std::int64_t;
+        using period = std::nano;
+        using duration = std::chrono::nanoseconds;
+        using time_point = std::chrono::time_point<FakeClock>;
+        static constexpr bool is_steady = true;
+    };
+    
+    constexpr FakeClock::time_point at(std::chrono::nanoseconds time) {
+        return FakeClock::time_point{ time };
+    }
+} // namespace
+
+suite controlLoop = [] {
+    tag ("control") / tag ("control-loop") /
+    feature ("control::FixedRateLoop") = [] {
+        scenario ("Schedule") = [] {
+            given ("Ticks run on time, with some jitter") = [] {
+                control::FixedRateLoop<FakeClock> loop{ 5ms, at(0ms) };
+                
+                then ("Deadlines should only depend on the start and the period") = [&] {
+                    expect (loop.deadline() == at(5ms));
+                    loop.beginTick(at(5ms + 30us));
+                    expect (loop.endTick(at(6ms)));
+                    expect (loop.deadline() == at(10ms));
+                    
+                    loop.beginTick(at(10ms + 10us));
+                    expect (loop.endTick(at(11ms)));
+                    expect (loop.deadline() == at(15ms));
+                };
+                
+                then ("The jitter and the duration of the ticks should be measured") = [&] {
+                    const control::LoopStats& stats = loop.stats();
+                    expect (stats.ticks == 2_ul);
+                    expect (stats.overruns == 0_ul);
+                    expect (stats.minJitter == 10us);
+                    expect (stats.maxJitter == 30us);
+                    expect (stats.meanJitter() == 20us);
+                    expect (stats.maxDuration == 990us);
+                };
+            };
+            
+            given ("A tick overrunning the next deadlines") = [] {
+                control::FixedRateLoop<FakeClock> loop{ 5ms, at(0ms) };
+                loop.beginTick(at(5ms));
+                
+                then ("The missed ticks should be skipped, keeping the phase") = [&] {
+                    expect (!loop.endTick(at(17ms)));
+                    expect (loop.deadline() == at(20ms));
+                    expect (loop.stats().overruns == 1_ul);
+                    expect (loop.stats().missedTicks == 2_ul);
+                    expect (loop.stats().maxDuration == 12ms);
+                };
+                
+                then ("A tick ending right on the next deadline shouldn't overrun") = [&] {
+                    loop.beginTick(at(20ms));
+                    expect (loop.endTick(at(25ms)));
+                    expect (loop.deadline() == at(25ms));
+                    expect (loop.stats().overruns == 1_ul);
+                };
+            };
+        };
+    };
+};
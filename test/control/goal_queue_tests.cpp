@@ -0,0 +1,110 @@
+#include <boost/ut.hpp>
+
+#include "utcoupe/asserv/control/goal_queue.hpp"
+
+#include <cmath>
+
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+suite goalQueue = [] {
+    tag ("control") / tag ("goal-queue") /
+    feature ("control::GoalQueue") = [] {
+        constexpr control::MotionLimits limits{ .maxSpeed = 500.f, .maxAcc = 1000.f, .junctionDeviation = 5.f };
+        
+        scenario ("Queue management") = [&] {
+            given ("A queue of 2 goals") = [&] {
+                control::GoalQueue<2, 2> queue;
+                
+                then ("Goals should get increasing identifiers until it is full") = [&] {
+                    expect (*queue.push({ .x = 100.f }) == 0_u);
+                    expect (*queue.push({ .x = 200.f }) == 1_u);
+                    expect (!queue.push({ .x = 300.f }));
+                    
+                    queue.pop();
+                    expect (queue.lastReachedId() == 0_u);
+                    expect (queue.front()->goal.x == 200._f);
+                    expect (*queue.push({ .x = 300.f }) == 2_u);
+                    
+                    queue.clear();
+                    expect (queue.empty());
+                    expect (queue.front() == nullptr);
+                };
+            };
+        };
+        
+        scenario ("Speed planning") = [&] {
+            given ("Collinear waypoints") = [&] {
+                control::GoalQueue<8, 4> queue;
+                queue.push({ .x = 1000.f });
+                queue.push({ .x = 2000.f });
+                queue.push({ .x = 3000.f });
+                queue.plan({}, 0.f, limits);
+                
+                then ("The robot should only stop at the last one") = [&] {
+                    expect (queue[0].entrySpeed == 0._f);
+                    expect (queue[0].exitSpeed == 500._f);
+                    expect (queue[1].exitSpeed == 500._f);
+                    expect (queue[2].entrySpeed == 500._f);
+                    expect (queue[2].exitSpeed == 0._f);
+                };
+            };
+            
+            given ("Waypoints at right angles") = [&] {
+                control::GoalQueue<8, 4> queue;
+                queue.push({ .x = 1000.f });
+                queue.push({ .x = 1000.f, .y = 1000.f });
+                queue.plan({}, 0.f, limits);
+                
+                then ("The corner should be taken at the speed allowed by the junction deviation") = [&] {
+                    const float sinHalf = std::sqrt(0.5f);
+                    const float expected = std::sqrt(limits.maxAcc * limits.junctionDeviation * sinHalf / (1.f - sinHalf));
+                    expect (std::abs(queue[0].exitSpeed - expected) < 0.01_f);
+                    expect (queue[1].entrySpeed == queue[0].exitSpeed);
+                };
+            };
+            
+            given ("Short moves") = [&] {
+                control::GoalQueue<8, 4> queue;
+                queue.push({ .x = 10.f });
+                queue.push({ .x = 20.f });
+                queue.plan({}, 0.f, limits);
+                
+                then ("Speeds should respect the maximum acceleration") = [&] {
+                    expect (std::abs(queue[0].exitSpeed - std::sqrt(2.f * limits.maxAcc * 10.f)) < 0.01_f);
+                    expect (queue[1].exitSpeed == 0._f);
+                };
+            };
+            
+            given ("A rotation or a reversal between two moves") = [&] {
+                control::GoalQueue<8, 4> queue;
+                queue.push({ .x = 1000.f });
+                queue.push({ .type = control::GoalType::ROT, .angle = 1.f });
+                queue.push({ .x = 2000.f });
+                queue.push({ .x = 1000.f, .direction = -1 });
+                queue.plan({}, 0.f, limits);
+                
+                then ("The robot should stop before them") = [&] {
+                    expect (queue[0].exitSpeed == 0._f);
+                    expect (queue[1].entrySpeed == 0._f);
+                    expect (queue[2].entrySpeed == 0._f);
+                    expect (queue[2].exitSpeed == 0._f);
+                };
+            };
+            
+            given ("More goals than the look-ahead window") = [&] {
+                control::GoalQueue<8, 2> queue;
+                queue.push({ .x = 1000.f });
+                queue.push({ .x = 2000.f });
+                queue.push({ .x = 3000.f });
+                queue.plan({}, 0.f, limits);
+                
+                then ("The last planned goal should end at rest") = [&] {
+                    expect (queue[0].exitSpeed > 0._f);
+                    expect (queue[1].exitSpeed == 0._f);
+                };
+            };
+        };
+    };
+};
@@ -0,0 +1,116 @@
+#include <boost/ut.hpp>
+
+#include "utcoupe/asserv/control/odometry.hpp"
+#include "utcoupe/asserv/fixed_point.hpp"
+
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+suite odometry = [] {
+    tag ("control") / tag ("odometry") /
+    feature ("control::Odometry") = [] {
+        constexpr control::OdometryConfig<float> config{ .leftMmPerTick = 0.1f, .rightMmPerTick = 0.1f, .wheelBase = 250.f };
+        
+        scenario ("Integration") = [&] {
+            given ("Both wheels moving forward by the same amount") = [&] {
+                control::Odometry<float> odo{ config };
+                odo.setPose({ 100.f, 200.f, std::numbers::pi_v<float> / 2.f });
+                for (int i = 0; i < 100; ++i) {
+                    odo.update({ 10, 10 });
+                }
+                
+                then ("The robot should move straight along its heading") = [&] {
+                    expect (std::abs(odo.pose().x - 100.f) < 0.001_f);
+                    expect (std::abs(odo.pose().y - 300.f) < 0.001_f);
+                    expect (std::abs(odo.pose().theta - std::numbers::pi_v<float> / 2.f) < 0.00001_f);
+                    expect (odo.leftCoder() == 1000_i);
+                    expect (odo.rightCoder() == 1000_i);
+                };
+            };
+            
+            given ("Wheels moving at different speeds") = [&] {
+                control::Odometry<float> odo{ config };
+                // 0.1 mm and 0.3 mm per sample: a 250 mm radius circle, 0.0008 rad per sample
+                const int samples = 2000;
+                for (int i = 0; i < samples; ++i) {
+                    odo.update({ 1, 3 });
+                }
+                
+                then ("The robot should follow the exact circle") = [&] {
+                    const float angle = 0.0008f * samples;
+                    expect (std::abs(odo.pose().x - 250.f * std::sin(angle)) < 0.01_f);
+                    expect (std::abs(odo.pose().y - 250.f * (1.f - std::cos(angle))) < 0.01_f);
+                    expect (std::abs(odo.pose().theta - angle) < 0.0001_f);
+                };
+            };
+            
+            given ("A large sample, e.g. after a late control loop") = [&] {
+                control::Odometry<float> odo{ config };
+                odo.update({ -1000, 1000 });
+                
+                then ("It should still be integrated as an arc") = [&] {
+                    expect (std::abs(odo.pose().theta - 0.8f) < 0.00001_f);
+                    expect (std::abs(odo.pose().x) < 0.001_f);
+                    expect (std::abs(odo.pose().y) < 0.001_f);
+                };
+            };
+            
+            given ("A full turn on the spot") = [&] {
+                control::Odometry<float> odo{ config };
+                // 785.4 mm per wheel for a 250 mm wheel base
+                for (int i = 0; i < 7854; ++i) {
+                    odo.update({ -1, 1 });
+                }
+                
+                then ("The orientation should wrap around") = [&] {
+                    expect (std::abs(odo.pose().theta) < 0.001_f);
+                };
+            };
+        };
+        
+        scenario ("Batching") = [&] {
+            given ("Samples received late") = [&] {
+                std::vector<control::EncoderSample> samples;
+                for (int i = 0; i < 50; ++i) {
+                    samples.push_back({ 10 + i % 7, 12 - i % 5 });
+                }
+                
+                control::Odometry<float> batched{ config };
+                batched.update(samples);
+                control::Odometry<float> oneByOne{ config };
+                for (const auto& sample : samples) {
+                    oneByOne.update(sample);
+                }
+                
+                then ("Integrating them at once should give the same pose") = [&] {
+                    expect (batched.pose().x == oneByOne.pose().x);
+                    expect (batched.pose().y == oneByOne.pose().y);
+                    expect (batched.pose().theta == oneByOne.pose().theta);
+                };
+            };
+        };
+        
+        scenario ("Fixed-point numbers") = [] {
+            given ("An odometry computing in Q16.16") = [] {
+                control::Odometry<Q16_16> odo{ { .leftMmPerTick = Q16_16{ 0.125f }, .rightMmPerTick = Q16_16{ 0.125f }, .wheelBase = Q16_16{ 250 } } };
+                for (int i = 0; i < 1000; ++i) {
+                    odo.update({ 8, 12 });
+                }
+                
+                then ("It should stay close to the exact arc") = [&] {
+                    // 1 mm and 1.5 mm per sample: a 625 mm radius circle, 0.002 rad per sample
+                    const float angle = 2.f;
+                    expect (std::abs(odo.pose().theta - angle) < 0.01_f);
+                    expect (std::abs(odo.pose().x - 625.f * std::sin(angle)) < 2._f);
+                    expect (std::abs(odo.pose().y - 625.f * (1.f - std::cos(angle))) < 2._f);
+                };
+            };
+        };
+    };
+};
@@ -0,0 +1,169 @@
+#include <boost/ut.hpp>
+
+#include "utcoupe/asserv/control/pid.hpp"
+#include "utcoupe/asserv/fixed_point.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+suite dualPid = [] {
+    tag ("control") / tag ("pid") /
+    feature ("control::DualPid") = [] {
+        constexpr control::PidConfig<float> config{
+            .period = 0.01f, .outputLimit = 100.f, .integralLimit = 50.f, .derivativeTimeConstant = 0.f
+        };
+        
+        scenario ("Gains") = [&] {
+            given ("Gains requested for one wheel") = [&] {
+                control::DualPid<float> pid{ config };
+                expect (pid.setGains(control::PidTarget::LEFT, { .p = 2.f }));
+                
+                then ("They should only be applied on the next tick, to that wheel") = [&] {
+                    expect (pid.gains(control::Wheel::LEFT).p == 0._f);
+                    
+                    const auto outputs = pid.tick({ 10.f, 10.f }, { 0.f, 0.f });
+                    expect (outputs[0] == 20._f);
+                    expect (outputs[1] == 0._f);
+                    expect (pid.gains(control::Wheel::LEFT).p == 2._f);
+                };
+                
+                then ("Changes should be rejected when too many are pending") = [&] {
+                    for (int i = 0; i < 4; ++i) {
+                        expect (pid.setGains(control::PidTarget::BOTH, { .p = 1.f }));
+                    }
+                    expect (!pid.setGains(control::PidTarget::BOTH, { .p = 1.f }));
+                    pid.tick({}, {});
+                    expect (pid.setGains(control::PidTarget::BOTH, { .p = 1.f }));
+                };
+            };
+            
+            given ("Gains changed from another thread while ticking") = [&] {
+                control::DualPid<float> pid{ config };
+                std::atomic<bool> done = false;
+                
+                std::thread orders([&pid, &done] {
+                    for (int i = 1; i <= 1000; ++i) {
+                        const auto gain = static_cast<float>(i);
+                        while (!pid.setGains(control::PidTarget::BOTH, { .p = gain, .d = gain })) {
+                            std::this_thread::yield();
+                        }
+                    }
+                    done = true;
+                });
+                
+                bool consistent = true;
+                while (!done || pid.gains(control::Wheel::LEFT).p != 1000.f) {
+                    pid.tick({}, {});
+                    for (auto wheel : { control::Wheel::LEFT, control::Wheel::RIGHT }) {
+                        const auto gains = pid.gains(wheel);
+                        consistent = consistent && std::abs(gains.p - gains.d) < 0.001f;
+                    }
+                    std::this_thread::yield();
+                }
+                orders.join();
+                
+                then ("Each tick should see the gains of a single order") = [&] {
+                    expect (consistent);
+                };
+            };
+        };
+        
+        scenario ("Integral term") = [&] {
+            given ("A constant error with an integral gain") = [&] {
+                control::DualPid<float> pid{ config };
+                pid.setGains(control::PidTarget::BOTH, { .i = 10.f });
+                
+                then ("The output should grow until the integral limit") = [&] {
+                    expect (std::abs(pid.tick({ 10.f, 10.f }, {})[0] - 1.f) < 0.001_f);
+                    expect (std::abs(pid.tick({ 10.f, 10.f }, {})[0] - 2.f) < 0.001_f);
+                    for (int i = 0; i < 100; ++i) {
+                        pid.tick({ 10.f, 10.f }, {});
+                    }
+                    expect (pid.tick({ 10.f, 10.f }, {})[0] == 50._f);
+                };
+            };
+            
+            given ("A saturated output") = [&] {
+                control::DualPid<float> pid{ { .period = 0.01f, .outputLimit = 10.f, .integralLimit = 50.f, .derivativeTimeConstant = 0.f } };
+                pid.setGains(control::PidTarget::BOTH, { .p = 1.f, .i = 10.f });
+                for (int i = 0; i < 100; ++i) {
+                    pid.tick({ 8.f, 8.f }, {});
+                }
+                
+                then ("The integral shouldn't wind up, so the output reverses as soon as the error does") = [&] {
+                    expect (pid.tick({ 8.f, 8.f }, {})[0] == 10._f);
+                    expect (pid.tick({}, { 1.f, 1.f })[0] < 2._f);
+                };
+            };
+            
+            given ("An output saturated by the proportional term alone") = [&] {
+                control::DualPid<float> pid{ { .period = 0.005f, .outputLimit = 255.f, .integralLimit = 100.f, .derivativeTimeConstant = 0.f } };
+                pid.setGains(control::PidTarget::BOTH, { .p = 1.f, .i = 10.f });
+                for (int i = 0; i < 100; ++i) {
+                    pid.tick({ 1000.f, -1000.f }, {});
+                }
+                
+                then ("The integral should keep its sign and stay within its limit") = [&] {
+                    const auto saturated = pid.tick({ 1000.f, -1000.f }, {});
+                    expect (saturated[0] == 255._f);
+                    expect (saturated[1] == -255._f);
+                    
+                    // Only the integration of this tick adds to the proportional term
+                    const auto outputs = pid.tick({ 200.f, -200.f }, {});
+                    expect (outputs[0] >= 200._f && outputs[0] <= 210._f);
+                    expect (outputs[1] <= -200._f && outputs[1] >= -210._f);
+                };
+            };
+        };
+        
+        scenario ("Derivative term") = [&] {
+            given ("A filtered derivative") = [&] {
+                control::DualPid<float> pid{ { .period = 0.01f, .outputLimit = 1000.f, .integralLimit = 50.f, .derivativeTimeConstant = 0.03f } };
+                pid.setGains(control::PidTarget::BOTH, { .d = 1.f });
+                
+                then ("A step of the setpoint shouldn't kick the output") = [&] {
+                    expect (pid.tick({ 100.f, 100.f }, {})[0] == 0._f);
+                };
+                
+                then ("A step of the measure should be smoothed") = [&] {
+                    const float first = pid.tick({}, { 1.f, 1.f })[0];
+                    const float second = pid.tick({}, { 1.f, 1.f })[0];
+                    expect (std::abs(first + 25.f) < 0.01_f);
+                    expect (second < 0._f && second > first);
+                };
+            };
+        };
+        
+        scenario ("Fixed-point numbers") = [] {
+            given ("A controller computing in Q16.16") = [] {
+                control::DualPid<Q16_16> pid{ {} };
+                pid.setGains(control::PidTarget::BOTH, { .p = Q16_16{ 2 }, .i = Q16_16{ 1 } });
+                
+                then ("It should compute the same outputs as with float") = [&] {
+                    const auto outputs = pid.tick({ Q16_16{ 10 }, Q16_16{ -10 } }, {});
+                    expect (std::abs(static_cast<float>(outputs[0]) - 20.05f) < 0.001_f);
+                    expect (std::abs(static_cast<float>(outputs[1]) + 20.05f) < 0.001_f);
+                };
+            };
+            
+            given ("An integral gain smaller than the resolution of Q16.16 once multiplied by the period") = [] {
+                control::DualPid<Q16_16> pid{ { .period = Q16_16{ 0.005f }, .derivativeTimeConstant = Q16_16{ 0 } } };
+                pid.setGains(control::PidTarget::BOTH, { .i = Q16_16{ 0.001f } });
+                
+                then ("The integral term should still accumulate the error") = [&] {
+                    Q16_16 output{ 0 };
+                    for (int i = 0; i < 200; ++i) {
+                        output = pid.tick({ Q16_16{ 100 }, Q16_16{ 100 } }, {})[0];
+                    }
+                    // 200 ticks * 0.001 * 100 * 0.005s
+                    expect (std::abs(static_cast<float>(output) - 0.1f) < 0.005_f);
+                };
+            };
+        };
+    };
+};
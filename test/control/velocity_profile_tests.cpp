@@ -0,0 +1,151 @@
+#include <boost/ut.hpp>
+
+#include "utcoupe/asserv/control/velocity_profile.hpp"
+
+#include <cmath>
+
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+namespace {
+    /** Samples a profile every millisecond, checking the limits are honored and the setpoints are continuous. */
+    bool honorsLimits(const control::VelocityProfile& profile, const control::MotionLimits& limits) {
+        constexpr float tick = 0.001f;
+        control::ProfileState previous = profile.at(0.f);
+        for (float time = tick; time <= profile.duration() + tick; time += tick) {
+            const control::ProfileState state = profile.at(time);
+            if (std::abs(state.speed) > limits.maxSpeed + 0.01f || std::abs(state.acceleration) > limits.maxAcc + 0.01f) {
+                return false;
+            }
+            if (std::abs(state.speed - previous.speed) > limits.maxAcc * tick + 0.01f) {
+                return false;
+            }
+            if (std::abs(state.position - previous.position) > limits.maxSpeed * tick + 0.01f) {
+                return false;
+            }
+            previous = state;
+        }
+        return true;
+    }
+} // namespace
+
+suite velocityProfile = [] {
+    tag ("control") / tag ("velocity-profile") /
+    feature ("control::VelocityProfile") = [] {
+        constexpr control::MotionLimits limits{ .maxSpeed = 500.f, .maxAcc = 1000.f, .maxJerk = 10000.f };
+        
+        scenario ("Trapezoidal profile") = [&] {
+            given ("A long move from rest to rest") = [&] {
+                const auto profile = control::VelocityProfile::plan(1000.f, 0.f, 0.f, limits);
+                
+                then ("It should accelerate, cruise at the maximum speed and decelerate") = [&] {
+                    expect (profile.phaseCount() == 3_ul);
+                    expect (std::abs(profile.duration() - 2.5f) < 0.0001_f);
+                    expect (std::abs(profile.at(0.25f).speed - 250.f) < 0.01_f);
+                    expect (profile.at(0.25f).acceleration == 1000._f);
+                    expect (std::abs(profile.at(1.f).speed - 500.f) < 0.01_f);
+                    expect (profile.at(1.f).acceleration == 0._f);
+                    expect (std::abs(profile.at(2.25f).speed - 250.f) < 0.01_f);
+                    expect (profile.at(2.25f).acceleration == -1000._f);
+                    expect (profile.at(profile.duration()).position == 1000._f);
+                    expect (profile.at(profile.duration()).speed == 0._f);
+                    expect (honorsLimits(profile, limits));
+                };
+            };
+            
+            given ("A move too short to reach the maximum speed") = [&] {
+                const auto profile = control::VelocityProfile::plan(100.f, 0.f, 0.f, limits);
+                
+                then ("It should be triangular") = [&] {
+                    expect (std::abs(profile.duration() - 0.632456f) < 0.001_f);
+                    expect (std::abs(profile.at(profile.duration() / 2.f).speed - 316.2278f) < 0.1_f);
+                    expect (std::abs(profile.at(profile.duration() / 2.f).position - 50.f) < 0.01_f);
+                    expect (honorsLimits(profile, limits));
+                };
+            };
+            
+            given ("A move chained between two waypoints") = [&] {
+                const auto profile = control::VelocityProfile::plan(500.f, 300.f, 200.f, limits);
+                
+                then ("It should start and end at the planned speeds") = [&] {
+                    expect (profile.at(0.f).speed == 300._f);
+                    expect (profile.exitSpeed() == 200._f);
+                    expect (std::abs(profile.at(profile.duration() - 1e-4f).speed - 200.f) < 0.5_f);
+                    expect (honorsLimits(profile, limits));
+                };
+            };
+            
+            given ("A move backward") = [&] {
+                const auto profile = control::VelocityProfile::plan(-1000.f, 0.f, 0.f, limits);
+                
+                then ("It should be mirrored") = [&] {
+                    expect (std::abs(profile.at(1.f).speed + 500.f) < 0.01_f);
+                    expect (profile.at(0.25f).acceleration == -1000._f);
+                    expect (profile.distance() == -1000._f);
+                    expect (profile.at(profile.duration() + 1.f).position == -1000._f);
+                };
+            };
+            
+            given ("An exit speed unreachable within the distance") = [&] {
+                const auto profile = control::VelocityProfile::plan(10.f, 0.f, 500.f, limits);
+                
+                then ("It should end at the highest reachable speed") = [&] {
+                    expect (std::abs(profile.exitSpeed() - std::sqrt(2.f * 1000.f * 10.f)) < 0.1_f);
+                    expect (profile.at(profile.duration()).position == 10._f);
+                };
+            };
+            
+            given ("Null limits") = [&] {
+                const auto profile = control::VelocityProfile::plan(1000.f, 0.f, 0.f, { .maxSpeed = 0.f });
+                
+                then ("It should not move") = [&] {
+                    expect (profile.duration() == 0._f);
+                    expect (profile.at(1.f).position == 0._f);
+                };
+            };
+        };
+        
+        scenario ("S-curve profile") = [&] {
+            given ("A long move from rest to rest") = [&] {
+                const auto profile = control::VelocityProfile::plan(1000.f, 0.f, 0.f, limits, control::ProfileShape::S_CURVE);
+                
+                then ("The acceleration should ramp at the maximum jerk") = [&] {
+                    expect (profile.phaseCount() == 7_ul);
+                    expect (std::abs(profile.duration() - 2.6f) < 0.0001_f);
+                    expect (std::abs(profile.at(0.05f).acceleration - 500.f) < 0.01_f);
+                    expect (std::abs(profile.at(0.3f).acceleration - 1000.f) < 0.01_f);
+                    expect (std::abs(profile.at(1.3f).speed - 500.f) < 0.01_f);
+                    expect (std::abs(profile.at(profile.duration() / 2.f).position - 500.f) < 0.01_f);
+                    expect (profile.at(profile.duration()).position == 1000._f);
+                    expect (honorsLimits(profile, limits));
+                };
+                
+                then ("It should be slower than the trapezoidal one") = [&] {
+                    expect (profile.duration() > control::VelocityProfile::plan(1000.f, 0.f, 0.f, limits).duration());
+                };
+            };
+            
+            given ("A speed change too small to reach the maximum acceleration") = [&] {
+                const auto profile = control::VelocityProfile::plan(1000.f, 450.f, 400.f, limits, control::ProfileShape::S_CURVE);
+                
+                then ("The acceleration should ramp up and down without plateau") = [&] {
+                    expect (std::abs(profile.at(0.f).speed - 450.f) < 0.01_f);
+                    expect (profile.exitSpeed() == 400._f);
+                    expect (std::abs(profile.at(profile.duration() - 1e-4f).speed - 400.f) < 0.5_f);
+                    expect (honorsLimits(profile, limits));
+                };
+            };
+            
+            given ("A short move") = [&] {
+                const auto profile = control::VelocityProfile::plan(20.f, 0.f, 0.f, limits, control::ProfileShape::S_CURVE);
+                
+                then ("It should still reach the target smoothly") = [&] {
+                    expect (profile.at(profile.duration()).position == 20._f);
+                    expect (std::abs(profile.at(profile.duration() / 2.f).position - 10.f) < 0.01_f);
+                    expect (honorsLimits(profile, limits));
+                };
+            };
+        };
+    };
+};
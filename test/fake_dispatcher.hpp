@@ -0,0 +1,76 @@
+#ifndef UTCOUPE_ASSERV_TEST_FAKE_DISPATCHER_HPP
+#define UTCOUPE_ASSERV_TEST_FAKE_DISPATCHER_HPP
+
+#include "utcoupe/asserv/serial/protocol.hpp"
+
+namespace utcoupe::asserv::test {
+    /**
+     * Executor implementing every order of the protocol, returning the character of the last executed order.
+     * 
+     * It doesn't move anything, it is meant to drive the serial layer without any hardware.
+     */
+    struct FakeDispatcher {
+        using OrderReturnT = int;
+        
+        /** The character of the last executed order, or '\0' if none was executed. */
+        char lastOrder = '\0';
+        
+        /** Sum of all integer arguments received by the last executed order. */
+        int lastIntSum = 0;
+        
+        /** Sum of all floating-point arguments received by the last executed order. */
+        float lastFloatSum = 0.f;
+        
+        int cleanGoals() { return record(serial::OrderTypes::CLEAN_GOALS); }
+        int getLastID() { return record(serial::OrderTypes::GET_LAST_ID); }
+        int halt() { return record(serial::OrderTypes::HALT); }
+        int killGoal() { return record(serial::OrderTypes::KILL_GOAL); }
+        int pause() { return record(serial::OrderTypes::PAUSE); }
+        int pingPing() { return record(serial::OrderTypes::PING_PING); }
+        int resetID() { return record(serial::OrderTypes::RESET_ID); }
+        int resume() { return record(serial::OrderTypes::RESUME); }
+        int start() { return record(serial::OrderTypes::START); }
+        int whoAmi() { return record(serial::OrderTypes::WHO_AMI); }
+        
+        int setMaxAcc(float acc) { return record(serial::OrderTypes::ACC_MAX, 0, acc); }
+        int setAllPID(float p, float i, float d) { return record(serial::OrderTypes::PID_ALL, 0, p + i + d); }
+        int setLeftPID(float p, float i, float d) { return record(serial::OrderTypes::PID_LEFT, 0, p + i + d); }
+        int setRightPID(float p, float i, float d) { return record(serial::OrderTypes::PID_RIGHT, 0, p + i + d); }
+        int setMaxSpeed(float speed) { return record(serial::OrderTypes::SPD_MAX, 0, speed); }
+        
+        int getCoder() { return record(serial::OrderTypes::GET_CODER); }
+        int getPos() { return record(serial::OrderTypes::GET_POS); }
+        int getPosID() { return record(serial::OrderTypes::GET_POS_ID); }
+        int getSpeed() { return record(serial::OrderTypes::GET_SPD); }
+        int getTargetSpeed() { return record(serial::OrderTypes::GET_TARGET_SPD); }
+        int doGoto(int x, int y, int direction) { return record(serial::OrderTypes::GOTO, sum(x, y, direction)); }
+        int doGotoWithAngle(int x, int y, float angle, int direction) { return record(serial::OrderTypes::GOTO_WITH_ANGLE, sum(x, y, direction), angle); }
+        int setPWM(int left, int right) { return record(serial::OrderTypes::PWM, sum(left, right)); }
+        int doRotation(float angle) { return record(serial::OrderTypes::ROT, 0, angle); }
+        int doRotationModulo(float angle) { return record(serial::OrderTypes::ROT_MODULO, 0, angle); }
+        int setEmergencyStop(int enable) { return record(serial::OrderTypes::SET_EMERGENCY_STOP, enable); }
+        int setPos(int x, int y, float angle) { return record(serial::OrderTypes::SET_POS, sum(x, y), angle); }
+        int setSpeed(int linear, int angular, int duration) { return record(serial::OrderTypes::SPD, sum(linear, angular, duration)); }
+        
+        int setTelemetry(unsigned fields, unsigned periodMs) { return record(serial::OrderTypes::TELEMETRY, static_cast<int>(fields + periodMs)); }
+        int getDiagnostics(int chOrder) { return record(serial::OrderTypes::DIAGNOSTICS, chOrder); }
+        
+        int gotoWithAngle(int x, int y, float angle, int direction) { return doGotoWithAngle(x, y, angle, direction); }
+        
+    private:
+        /** Sums integer arguments with wrap around, so that arbitrary values, e.g. from the fuzz target, never overflow. */
+        template<class... IntsT>
+        static int sum(IntsT... values) {
+            return static_cast<int>((0U + ... + static_cast<unsigned>(values)));
+        }
+        
+        int record(serial::OrderTypes order, int intSum = 0, float floatSum = 0.f) {
+            lastOrder = static_cast<char>(order);
+            lastIntSum = intSum;
+            lastFloatSum = floatSum;
+            return lastOrder;
+        }
+    };
+} // namespace utcoupe::asserv::test
+
+#endif // UTCOUPE_ASSERV_TEST_FAKE_DISPATCHER_HPP
@@ -0,0 +1,130 @@
+#include <boost/ut.hpp>
+
+#include "utcoupe/asserv/fixed_point.hpp"
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/order.hpp"
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/parse_parameters.hpp"
+#include "utcoupe/asserv/serial/response_writer.hpp"
+
+#include <array>
+#include <string_view>
+
+using namespace std::string_view_literals;
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+namespace {
+    struct FixedTester {
+        using OrderReturnT = Q16_16;
+        
+        Q16_16 scale(Q16_16 gain, int value) { return gain * Q16_16{ value }; }
+    };
+    
+    std::optional<Q16_16> parseFixed(std::string_view str) {
+        auto values = serial::parseParameters<Q16_16>(str.data(), str.data() + str.size());
+        if (!values) {
+            return std::nullopt;
+        }
+        return std::get<0>(*values);
+    }
+    
+    std::string_view writeFixed(std::span<char> buffer, Q16_16 value) {
+        const auto [end, ec] = toChars(buffer.data(), buffer.data() + buffer.size(), value);
+        return ec == std::errc{} ? std::string_view{ buffer.data(), end } : std::string_view{};
+    }
+} // namespace
+
+suite fixedPoint = [] {
+    tag ("control") / tag ("fixed-point") /
+    feature ("Q16_16") = [] {
+        scenario ("Arithmetic") = [] {
+            given ("Values built from integers and floats") = [] {
+                constexpr Q16_16 half{ 0.5f };
+                constexpr Q16_16 three{ 3 };
+                
+                then ("Operations should be rounded like on reals") = [&] {
+                    expect (constant<half.raw() == 32768>);
+                    expect ((half + three).raw() == 229376_i);
+                    expect ((half - three).raw() == -163840_i);
+                    expect ((half * three).raw() == 98304_i);
+                    expect ((three / Q16_16{ 2 }).raw() == 98304_i);
+                    expect ((Q16_16{ 1 } / three).raw() == 21845_i);
+                    expect ((Q16_16{ -1 } / three).raw() == -21845_i);
+                    expect (static_cast<float>(-half) == -0.5_f);
+                    expect (static_cast<int>(Q16_16{ -2.75f }) == -2_i);
+                    expect (abs(Q16_16{ -2.75f }) == Q16_16{ 2.75f });
+                    expect (half < three);
+                };
+                
+                then ("Overflows should saturate") = [&] {
+                    expect (Q16_16{ 30000 } + Q16_16{ 30000 } == Q16_16::max());
+                    expect (Q16_16{ -300 } * Q16_16{ 300 } == Q16_16::lowest());
+                    expect (three / Q16_16{} == Q16_16::max());
+                    expect (Q16_16{ 1e9f } == Q16_16::max());
+                    expect (Q16_16{ 100000 } == Q16_16::max());
+                };
+            };
+        };
+        
+        scenario ("Text conversions") = [] {
+            given ("Decimal strings of the protocol") = [] {
+                then ("They should be parsed to the nearest value") = [] {
+                    expect (parseFixed("1.5;"sv)->raw() == 98304_i);
+                    expect (parseFixed("-0.035;"sv)->raw() == -2294_i);
+                    expect (parseFixed("250;"sv)->raw() == 16384000_i);
+                    expect (parseFixed("12.5e-1;"sv)->raw() == 81920_i);
+                    expect (parseFixed("0.000001;"sv)->raw() == 0_i);
+                    expect (parseFixed("3.14159265358979323846264;"sv)->raw() == 205887_i);
+                    expect (parseFixed("-32768;"sv) == Q16_16::lowest());
+                };
+                
+                then ("Values out of range or not numbers should be rejected") = [] {
+                    expect (!parseFixed("32768;"sv));
+                    expect (!parseFixed("-32768.1;"sv));
+                    expect (!parseFixed("1e10;"sv));
+                    expect (!parseFixed("abc;"sv));
+                };
+            };
+            
+            given ("Fixed values") = [] {
+                std::array<char, 16> buffer{};
+                
+                then ("They should be written with the shortest exact fractional part") = [&] {
+                    expect (writeFixed(buffer, Q16_16{ 1.5f }) == "1.5"sv);
+                    expect (writeFixed(buffer, *parseFixed("-0.035;"sv)) == "-0.035"sv);
+                    expect (writeFixed(buffer, Q16_16{ 12 }) == "12"sv);
+                    expect (writeFixed(buffer, Q16_16::lowest()) == "-32768"sv);
+                    expect (writeFixed(buffer, Q16_16::fromRaw(-1)) == "-0.00002"sv);
+                    expect (writeFixed(std::span{ buffer }.first(3), Q16_16{ 1.25f }).empty());
+                };
+            };
+        };
+        
+        scenario ("Order parameters") = [] {
+            given ("An order taking a fixed-point parameter") = [] {
+                FixedTester tester;
+                serial::OrderParser parser{ tester };
+                constexpr auto table = serial::makeOrderTable(std::tuple{ serial::createOrder('s', &FixedTester::scale) });
+                
+                then ("It should be run from ASCII and binary frames") = [&] {
+                    expect (parser.parseAndRunOrder(table, "s;1.5;4;"sv) == Q16_16{ 6 });
+                    
+                    std::array<char, 16> frame{};
+                    const std::size_t size = serial::encodeBinaryFrame(frame, 's', Q16_16{ 0.25f }, 8);
+                    expect (size == serial::binaryFrameSize(8) >> fatal);
+                    expect (parser.parseAndRunBinaryOrder(table, std::string_view{ frame.data(), size }) == Q16_16{ 2 });
+                };
+                
+                then ("Its result should be written back") = [&] {
+                    std::array<char, 32> buffer{};
+                    serial::ResponseWriter writer{ buffer };
+                    writer.write('s', Q16_16{ -2.5f });
+                    expect (writer.data() == "s;-2.5;\n"sv);
+                };
+            };
+        };
+    };
+};
@@ -0,0 +1,74 @@
+#ifndef UTCOUPE_ASSERV_TEST_LINE_NOISE_HPP
+#define UTCOUPE_ASSERV_TEST_LINE_NOISE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace utcoupe::asserv::test {
+    /**
+     * Generates the kind of input a noisy serial cable delivers: random bytes, and valid frames with flipped, lost or repeated bytes.
+     * 
+     * It is deterministic (xorshift64), so that any failing input can be reproduced from its seed.
+     */
+    class LineNoise {
+    public:
+        explicit LineNoise(std::uint64_t seed) noexcept: m_state(seed == 0 ? 1 : seed) {}
+        
+        std::uint64_t next() noexcept {
+            m_state ^= m_state << 13;
+            m_state ^= m_state >> 7;
+            m_state ^= m_state << 17;
+            return m_state;
+        }
+        
+        /** A value in [0, bound). */
+        std::size_t below(std::size_t bound) noexcept {
+            return next() % bound;
+        }
+        
+        /** Uniformly random bytes, separators and terminators included. */
+        std::string randomBytes(std::size_t size) {
+            std::string bytes(size, '\0');
+            for (char& byte : bytes) {
+                byte = static_cast<char>(next());
+            }
+            return bytes;
+        }
+        
+        /**
+         * Damages a stream of frames.
+         * 
+         * @param frames The valid stream.
+         * @param perMille The probability for each byte to be damaged, in thousandths.
+         * @return The stream where each damaged byte has been flipped by one bit, dropped or repeated.
+         */
+        std::string corrupt(std::string_view frames, std::size_t perMille) {
+            std::string corrupted;
+            corrupted.reserve(frames.size() + frames.size() / 8);
+            for (const char byte : frames) {
+                if (below(1000) >= perMille) {
+                    corrupted += byte;
+                    continue;
+                }
+                switch (below(3)) {
+                    case 0:
+                        corrupted += static_cast<char>(byte ^ (1 << below(8)));
+                        break;
+                    case 1:
+                        break;
+                    default:
+                        corrupted.append(2, byte);
+                        break;
+                }
+            }
+            return corrupted;
+        }
+        
+    private:
+        std::uint64_t m_state;
+    };
+} // namespace utcoupe::asserv::test
+
+#endif // UTCOUPE_ASSERV_TEST_LINE_NOISE_HPP
@@ -0,0 +1,158 @@
+#include <boost/ut.hpp>
+
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/order.hpp"
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/stream_decoder.hpp"
+
+#include <array>
+#include <cmath>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std::string_view_literals;
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+namespace {
+    struct Tester {
+        using OrderReturnT = int;
+        
+        constexpr int run(int x, int y) { return x + y; }
+        constexpr int runMixed(std::int16_t x, float y) { return x + static_cast<int>(std::floor(y)); }
+        constexpr int compute() { return 42; }
+    };
+    
+    constexpr auto allOrders = serial::makeOrderTable(std::tuple{
+        serial::createOrder('a', &Tester::run),
+        serial::createOrder('b', &Tester::runMixed),
+        serial::createOrder('c', &Tester::compute),
+    });
+}
+
+suite binaryCodec = [] {
+    tag ("serial") / tag ("binary-codec") /
+    feature ("serial::encodeBinaryFrame") = [] {
+        scenario ("Frame layout") = [] {
+            given ("Known bytes") = [] {
+                then ("The CRC should match CRC-16/CCITT-FALSE") = [] {
+                    expect (constant<serial::crc16("123456789"sv) == 0x29B1>);
+                };
+            };
+            
+            given ("An order with mixed parameter types") = [] {
+                std::array<char, 32> buffer{};
+                auto size = serial::encodeBinaryFrame(buffer, 'b', std::int16_t{ -3 }, 2.5f);
+                
+                then ("Fields should be stored in little-endian after the header") = [&] {
+                    expect (size == serial::binaryFrameSize(6) >> fatal);
+                    expect (buffer[0] == serial::BINARY_FRAME_START);
+                    expect (buffer[1] == 'b');
+                    expect (static_cast<int>(buffer[2]) == 6_i);
+                    expect (static_cast<int>(static_cast<unsigned char>(buffer[3])) == 253_i);
+                    expect (static_cast<int>(static_cast<unsigned char>(buffer[4])) == 255_i);
+                };
+                
+                then ("It should be checked and decoded back") = [&] {
+                    auto frame = serial::checkBinaryFrame({ buffer.data(), size });
+                    expect (frame.has_value() >> fatal);
+                    expect (frame->chOrder == 'b');
+                    
+                    std::tuple<std::int16_t, float> values;
+                    expect (serial::decodeBinaryParameters(frame->payload, values) >> fatal);
+                    expect (std::get<0>(values) == -3);
+                    expect (std::get<1>(values) == 2.5_f);
+                };
+            };
+            
+            given ("A buffer too small for the frame") = [] {
+                std::array<char, 6> buffer{};
+                
+                then ("Nothing should be written") = [&] {
+                    expect (serial::encodeBinaryFrame(buffer, 'a', 1, 2) == 0_ul);
+                };
+            };
+        };
+        
+        scenario ("Corrupted frames") = [] {
+            std::array<char, 32> buffer{};
+            auto size = serial::encodeBinaryOrder(buffer, std::get<0>(allOrders.orders), { 4, 5 });
+            
+            given ("A frame with a flipped bit") = [&] {
+                std::string frame{ buffer.data(), size };
+                frame[4] ^= 0x10;
+                
+                then ("It should be rejected") = [&] {
+                    expect (!serial::checkBinaryFrame(frame));
+                };
+            };
+            
+            given ("A truncated frame") = [&] {
+                then ("It should be rejected") = [&] {
+                    expect (!serial::checkBinaryFrame({ buffer.data(), size - 1 }));
+                    expect (!serial::checkBinaryFrame({ buffer.data(), 2 }));
+                };
+            };
+        };
+    };
+    
+    tag ("serial") / tag ("binary-codec") /
+    feature ("Binary orders") = [] {
+        Tester tester;
+        serial::OrderParser parser{tester};
+        
+        scenario ("Order execution") = [&] {
+            given ("Binary frames of known orders") = [&] {
+                std::array<char, 32> buffer{};
+                
+                then ("They should be executed with their parameters") = [&] {
+                    auto size = serial::encodeBinaryOrder(buffer, std::get<0>(allOrders.orders), { 4, 5 });
+                    expect (*parser.parseAndRunBinaryOrder(allOrders, { buffer.data(), size }) == 9_i);
+                    
+                    size = serial::encodeBinaryOrder(buffer, std::get<2>(allOrders.orders), {});
+                    expect (*parser.parseAndRunBinaryOrder(allOrders, { buffer.data(), size }) == 42_i);
+                };
+                
+                then ("A payload not matching the order parameters should be rejected") = [&] {
+                    auto size = serial::encodeBinaryFrame(buffer, 'a', 4);
+                    expect (!parser.parseAndRunBinaryOrder(allOrders, { buffer.data(), size }));
+                };
+            };
+        };
+        
+        scenario ("Binary stream decoding") = [&] {
+            given ("Frames split in chunks and surrounded by line noise") = [&] {
+                serial::StreamDecoder<Tester, decltype(allOrders), 32, serial::FrameFormat::BINARY> decoder{parser, allOrders};
+                std::vector<std::optional<int>> results;
+                auto onResult = [&results](auto result) { results.push_back(result); };
+                
+                std::array<char, 32> buffer{};
+                std::string stream = "noise";
+                auto size = serial::encodeBinaryOrder(buffer, std::get<0>(allOrders.orders), { 1, 2 });
+                stream.append(buffer.data(), size);
+                std::string corrupted{ buffer.data(), size };
+                corrupted[5] ^= 0x01;
+                stream += corrupted;
+                size = serial::encodeBinaryOrder(buffer, std::get<1>(allOrders.orders), { std::int16_t{ 10 }, 0.5f });
+                stream.append(buffer.data(), size);
+                
+                then ("Only the valid frames should be run") = [&] {
+                    std::string_view streamView = stream;
+                    while (!streamView.empty()) {
+                        decoder.feed(streamView.substr(0, 3), onResult);
+                        streamView.remove_prefix(std::min<std::size_t>(3, streamView.size()));
+                    }
+                    expect ((results.size() == 2_ul) >> fatal);
+                    expect (*results[0] == 3_i);
+                    expect (*results[1] == 10_i);
+                    expect (decoder.droppedFrames() == 1_ul);
+                    expect (decoder.pendingSize() == 0_ul);
+                };
+            };
+        };
+    };
+};
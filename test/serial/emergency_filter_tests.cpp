@@ -0,0 +1,202 @@
+#include <boost/ut.hpp>
+
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/emergency_filter.hpp"
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_queue.hpp"
+#include "utcoupe/asserv/serial/order_stats.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/serial/stream_decoder.hpp"
+#include "utcoupe/asserv/simulation/simulated_robot.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+using namespace std::string_view_literals;
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+namespace {
+    constexpr auto allOrders = serial::makeOrderTable(serial::createAllOrders<simulation::SimulatedRobot>());
+    
+    /**
+     * Feeds a stream byte by byte, as a serial interrupt would.
+     * 
+     * @return The position of the byte on which the first stop has been requested, or the size of the stream if none was.
+     */
+    template<class FilterT>
+    std::size_t detectionPosition(FilterT& filter, std::string_view stream) {
+        for (std::size_t i = 0; i < stream.size(); ++i) {
+            filter.feed(stream.substr(i, 1));
+            if (filter.pending()) {
+                return i;
+            }
+        }
+        return stream.size();
+    }
+    
+    template<class... ArgsT>
+    std::string binaryFrame(char chOrder, ArgsT... values) {
+        std::array<char, 32> buffer{};
+        return std::string{ buffer.data(), serial::encodeBinaryFrame(buffer, chOrder, values...) };
+    }
+}
+
+suite emergencyFilter = [] {
+    tag ("serial") / tag ("emergency-filter") /
+    feature ("serial::EmergencyFilter") = [] {
+        scenario ("ASCII frames") = [] {
+            given ("A HALT in the middle of the stream") = [] {
+                serial::EmergencyFilter filter;
+                constexpr auto stream = "d;100;200;1;\nd;300;H;\nH;\r\nS;\n"sv;
+                
+                then ("The stop should be requested on the terminator of its frame") = [&] {
+                    expect (detectionPosition(filter, stream) == stream.find("H;\r\n") + 3);
+                    expect (filter.detectedFrames() == 1_ul);
+                };
+            };
+            
+            given ("Emergency stop frames") = [] {
+                then ("Only enabling ones should request a stop") = [] {
+                    serial::EmergencyFilter filter;
+                    expect (filter.feed("A;0;\nA;;\nA;1\nAH;\nzH;\nH;1;\n"sv) == 0_ul);
+                    expect (!filter.pending());
+                    expect (filter.feed("A;1;\nA;-3;\n"sv) == 2_ul);
+                    expect (filter.pending());
+                };
+                
+                then ("A frame longer than any emergency one should be skipped") = [] {
+                    serial::EmergencyFilter filter;
+                    expect (filter.feed("A;1000000000000000000000;\n"sv) == 0_ul);
+                    expect (filter.feed("H;\n"sv) == 1_ul);
+                };
+            };
+            
+            given ("A stop released in the same chunk") = [] {
+                then ("A SET_EMERGENCY_STOP 0 should cancel the pending emergency stop") = [] {
+                    serial::EmergencyFilter filter;
+                    expect (filter.feed("A;1;\nA;0;\n"sv) == 1_ul);
+                    expect (!filter.pending());
+                };
+                
+                then ("A START should only cancel a HALT received before it") = [] {
+                    serial::EmergencyFilter filter;
+                    expect (filter.feed("H;\nS;\n"sv) == 1_ul);
+                    expect (!filter.pending());
+                    expect (filter.feed("S;\nH;\n"sv) == 1_ul);
+                    expect (filter.pending());
+                };
+            };
+        };
+        
+        scenario ("Binary frames") = [] {
+            given ("Emergency frames among other frames") = [] {
+                serial::EmergencyFilter<serial::FrameFormat::BINARY> filter;
+                const std::string halt = binaryFrame('H');
+                
+                then ("They should be recognized even right after a start byte inside a payload") = [&] {
+                    const std::string stream = binaryFrame('d', 100, 0xA5, 1) + "\xA5" + halt;
+                    expect (detectionPosition(filter, stream) == stream.size() - 1);
+                };
+                
+                then ("Only enabling emergency stops should request a stop") = [&] {
+                    expect (filter.feed(binaryFrame('A', 0)) == 0_ul);
+                    expect (filter.feed(binaryFrame('A', 1)) == 1_ul);
+                };
+                
+                then ("Releasing frames should cancel the pending stops") = [&] {
+                    expect (filter.feed(binaryFrame('A', 0) + binaryFrame('H') + binaryFrame('S')) == 1_ul);
+                    expect (!filter.pending());
+                };
+                
+                then ("Corrupted frames shouldn't request a stop") = [&] {
+                    std::string corrupted = halt;
+                    corrupted.back() = static_cast<char>(corrupted.back() ^ 1);
+                    expect (filter.feed(corrupted) == 0_ul);
+                    expect (filter.feed(binaryFrame('H', 0)) == 0_ul);
+                };
+            };
+        };
+        
+        scenario ("Worst-case latency") = [] {
+            given ("A moving robot whose order queue is full") = [] {
+                simulation::SimulatedRobot robot;
+                serial::OrderParser parser{robot};
+                serial::OrderQueue<decltype(allOrders), 4> queue{allOrders};
+                serial::StreamDecoder decoder{parser, allOrders};
+                serial::EmergencyFilter filter;
+                
+                parser.parseAndRunOrder(allOrders, "d;2000;0;1;"sv);
+                robot.run(0.5f);
+                
+                // The serial interrupt: every byte goes through the filter first, then through the decoder
+                auto receive = [&](std::string_view chunk) {
+                    filter.feed(chunk);
+                    decoder.feedFrames(chunk, [&queue](const auto& frame) { queue.push(frame); });
+                };
+                receive("d;100;0;1;\nd;200;0;1;\nd;300;0;1;\nd;400;0;1;\nd;500;0;1;\nH;\nd;6"sv);
+                
+                then ("The HALT shouldn't fit in the queue") = [&] {
+                    expect (queue.size() == 4_ul);
+                    expect (queue.overflowedOrders() == 2_ul);
+                    expect (std::abs(robot.pwm()[0]) > 0._f);
+                };
+                
+                then ("The robot should be stopped by the next control cycle") = [&] {
+                    const auto halts = serial::orderStats().summary('H').count;
+                    
+                    // The control cycle: pending stops are applied before anything else
+                    expect (filter.apply(robot));
+                    robot.step();
+                    
+                    expect (robot.pwm()[0] == 0._f);
+                    expect (robot.pwm()[1] == 0._f);
+                    expect (!filter.pending());
+                    expect (!filter.apply(robot));
+                    expect (serial::orderStats().summary('H').count == halts + 1);
+                };
+            };
+        };
+        
+        scenario ("Orders run by the receiving context") = [] {
+            simulation::SimulatedRobot robot;
+            serial::OrderParser parser{robot};
+            serial::StreamDecoder decoder{parser, allOrders};
+            serial::EmergencyFilter filter;
+            
+            // The callbacks run as soon as their frame is received, before the control cycle applies the stops
+            auto receive = [&](std::string_view chunk) {
+                filter.feed(chunk);
+                decoder.feed(chunk);
+            };
+            
+            given ("A new path uploaded right after a HALT") = [&] {
+                receive("H;\ng;\nd;500;0;1;\nS;\n"sv);
+                
+                then ("The stale HALT shouldn't wipe the path") = [&] {
+                    expect (!filter.apply(robot));
+                    robot.step();
+                    expect (!robot.isIdle());
+                    robot.run(0.2f);
+                    expect (std::abs(robot.pwm()[0]) > 0._f);
+                };
+            };
+            
+            given ("An emergency stop released in the same chunk") = [&] {
+                receive("A;1;\nA;0;\n"sv);
+                
+                then ("It shouldn't be engaged again") = [&] {
+                    expect (!filter.apply(robot));
+                    robot.step();
+                    expect (std::abs(robot.pwm()[0]) > 0._f);
+                };
+            };
+        };
+    };
+};
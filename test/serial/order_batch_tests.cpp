@@ -0,0 +1,159 @@
+#include <boost/ut.hpp>
+
+#include "fake_dispatcher.hpp"
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/order_batch.hpp"
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/parse_error.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/serial/stream_decoder.hpp"
+
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std::string_view_literals;
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+namespace {
+    constexpr auto allOrders = serial::makeOrderTable(serial::createAllOrders<test::FakeDispatcher>());
+}
+
+suite orderBatch = [] {
+    tag ("serial") / tag ("order-batch") /
+    feature ("serial::OrderBatch") = [] {
+        test::FakeDispatcher dispatcher;
+        serial::OrderParser parser{dispatcher};
+        
+        scenario ("ASCII batches") = [&] {
+            given ("A path uploaded as a single frame") = [&] {
+                serial::OrderBatch batch{allOrders};
+                
+                then ("Every order should be run in the batch order") = [&] {
+                    expect (serial::isBatchFrame("B;g;|d;100;200;1;|S;"sv));
+                    expect (batch.decode("B;g;|d;100;200;1;|d;300;200;1;|S;"sv));
+                    expect (batch.size() == 4_ul);
+                    expect (dispatcher.lastOrder == '\0');
+                    
+                    std::vector<char> runOrders;
+                    auto onResult = [&runOrders](std::optional<int> result) { runOrders.push_back(static_cast<char>(*result)); };
+                    expect (batch.run(parser, onResult) == 4_ul);
+                    expect (runOrders == std::vector{ 'g', 'd', 'd', 'S' });
+                    expect (batch.size() == 0_ul);
+                };
+            };
+            
+            given ("A batch holding a malformed order") = [&] {
+                serial::OrderBatch batch{allOrders};
+                dispatcher.lastOrder = '\0';
+                
+                then ("None of its orders should be run") = [&] {
+                    const auto failures = serial::orderStats().summary('B').failures;
+                    expect (!batch.decode("B;g;|d;100;abc;1;|S;"sv));
+                    expect (batch.lastError() == serial::ParseError::BAD_NUMBER);
+                    expect (!batch.decode("B;g;|x;|S;"sv));
+                    expect (batch.lastError() == serial::ParseError::MISSING_ARG);
+                    expect (!batch.decode("B;g;||S;"sv));
+                    expect (batch.lastError() == serial::ParseError::MISSING_ARG);
+                    expect (!batch.decode("B;"sv));
+                    expect (!batch.decode("g;"sv));
+                    expect (batch.lastError() == serial::ParseError::UNKNOWN_ORDER);
+                    expect (batch.size() == 0_ul);
+                    expect (batch.run(parser) == 0_ul);
+                    expect (dispatcher.lastOrder == '\0');
+                    expect (serial::orderStats().summary('B').failures == failures + 5u);
+                };
+            };
+            
+            given ("More orders than the batch capacity") = [&] {
+                serial::OrderBatch<decltype(allOrders), 2> batch{allOrders};
+                
+                then ("The whole batch should be rejected") = [&] {
+                    expect (batch.decode("B;g;|S;"sv));
+                    expect (batch.lastError() == serial::ParseError::NONE);
+                    expect (!batch.decode("B;g;|S;|S;"sv));
+                    expect (batch.lastError() == serial::ParseError::OUT_OF_RANGE);
+                    expect (batch.size() == 0_ul);
+                };
+            };
+            
+            given ("A batch built by the host") = [&] {
+                std::array<char, 64> buffer{};
+                serial::BatchWriter writer{buffer};
+                writer.append('g');
+                writer.append('d', 100, 200, 1);
+                writer.append('c', 300, 400, 1.5f, 1);
+                writer.append('S');
+                
+                then ("It should be received through the stream decoder") = [&] {
+                    const auto frame = writer.finish();
+                    expect (frame == "B;g;|d;100;200;1;|c;300;400;1.5;1;|S;"sv);
+                    
+                    serial::OrderBatch batch{allOrders};
+                    serial::StreamDecoder decoder{parser, allOrders};
+                    const std::string stream = std::string{ frame } + "\n";
+                    decoder.feedFrames(stream, [&batch](std::string_view received) { expect (batch.decode(received)); });
+                    expect (batch.run(parser) == 4_ul);
+                    expect (dispatcher.lastOrder == 'S');
+                };
+            };
+        };
+        
+        scenario ("Binary batches") = [&] {
+            given ("A batch built by the host") = [&] {
+                std::array<char, 64> buffer{};
+                serial::BatchWriter<serial::FrameFormat::BINARY> writer{buffer};
+                writer.append('g');
+                writer.append('d', 100, 200, 1);
+                writer.append('l', 1.5f);
+                const auto frame = writer.finish();
+                
+                then ("It should be a single checked frame") = [&] {
+                    expect (frame.size() == serial::binaryFrameSize(2 + 2 + 12 + 2 + 4));
+                    auto checked = serial::checkBinaryFrame(frame);
+                    expect (checked.has_value() && serial::isBatchFrame(*checked));
+                };
+                
+                then ("Its orders should be run in order") = [&] {
+                    serial::OrderBatch batch{allOrders};
+                    expect (batch.decode(*serial::checkBinaryFrame(frame)));
+                    expect (batch.run(parser) == 3_ul);
+                    expect (dispatcher.lastOrder == 'l');
+                    expect (dispatcher.lastFloatSum == 1.5_f);
+                };
+            };
+            
+            given ("A batch holding an order with a wrong payload") = [&] {
+                std::array<char, 64> buffer{};
+                serial::BatchWriter<serial::FrameFormat::BINARY> writer{buffer};
+                writer.append('g');
+                writer.append('d', 100, 200);
+                
+                then ("None of its orders should be run") = [&] {
+                    dispatcher.lastOrder = '\0';
+                    serial::OrderBatch batch{allOrders};
+                    expect (!batch.decode(*serial::checkBinaryFrame(writer.finish())));
+                    expect (!batch.decode(serial::BinaryFrame{ 'B', "g\x05"sv }));
+                    expect (batch.run(parser) == 0_ul);
+                    expect (dispatcher.lastOrder == '\0');
+                };
+            };
+            
+            given ("A batch exceeding the buffer") = [&] {
+                std::array<char, 16> buffer{};
+                serial::BatchWriter<serial::FrameFormat::BINARY> writer{buffer};
+                
+                then ("It shouldn't be finished") = [&] {
+                    expect (writer.append('g'));
+                    expect (!writer.append('d', 100, 200, 1));
+                    expect (writer.finish().empty());
+                };
+            };
+        };
+    };
+};
@@ -0,0 +1,82 @@
+#include <boost/ut.hpp>
+
+#include "fake_dispatcher.hpp"
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/order_client.hpp"
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/serial/stream_decoder.hpp"
+
+#include <array>
+#include <string_view>
+#include <vector>
+
+using namespace std::string_view_literals;
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+namespace {
+    constexpr auto allOrders = serial::makeOrderTable(serial::createAllOrders<test::FakeDispatcher>());
+}
+
+suite orderClient = [] {
+    tag ("serial") / tag ("order-client") /
+    feature ("serial::OrderClient") = [] {
+        test::FakeDispatcher dispatcher;
+        serial::OrderParser parser{dispatcher};
+        
+        scenario ("ASCII orders") = [&] {
+            given ("A path written by the host") = [&] {
+                std::array<char, 64> buffer{};
+                serial::OrderClient<allOrders> client{buffer};
+                
+                then ("It should be formatted with the parameter types of the table") = [&] {
+                    expect (client.send<serial::OrderTypes::CLEAN_GOALS>());
+                    expect (client.send<serial::OrderTypes::GOTO_WITH_ANGLE>({ 300, 400, 1.5f, 1 }));
+                    expect (client.send<serial::OrderTypes::START>());
+                    expect (client.data() == "g;\nc;300;400;1.5;1;\nS;\n"sv);
+                };
+                
+                then ("It should be run by the asserv") = [&] {
+                    serial::StreamDecoder decoder{parser, allOrders};
+                    std::vector<int> results;
+                    expect (decoder.feed(client.data(), [&results](auto result) { results.push_back(*result); }) == 3_ul);
+                    expect (results == std::vector{ int{ 'g' }, int{ 'c' }, int{ 'S' } });
+                    expect (dispatcher.lastOrder == 'S');
+                };
+            };
+            
+            given ("A buffer too small for the order") = [&] {
+                std::array<char, 8> buffer{};
+                serial::OrderClient<allOrders> client{buffer};
+                
+                then ("Nothing should be written") = [&] {
+                    expect (client.send<serial::OrderTypes::HALT>());
+                    expect (!client.send<serial::OrderTypes::GOTO>({ 1000, 2000, 1 }));
+                    expect (client.data() == "H;\n"sv);
+                    client.clear();
+                    expect (client.data().empty());
+                };
+            };
+        };
+        
+        scenario ("Binary orders") = [&] {
+            given ("An order written by the host") = [&] {
+                std::array<char, 64> buffer{};
+                serial::OrderClient<allOrders, serial::FrameFormat::BINARY> client{buffer};
+                expect (client.send<serial::OrderTypes::PID_ALL>({ 1.f, 2.f, 3.f }));
+                
+                then ("It should be a checked frame run by the asserv") = [&] {
+                    expect (client.data().size() == serial::binaryFrameSize(12));
+                    const auto frame = serial::checkBinaryFrame(client.data());
+                    expect (frame.has_value() >> fatal);
+                    expect (parser.parseAndRunOrder(allOrders, *frame).has_value());
+                    expect (dispatcher.lastOrder == 'u');
+                    expect (dispatcher.lastFloatSum == 6._f);
+                };
+            };
+        };
+    };
+};
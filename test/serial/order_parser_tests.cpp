@@ -2,6 +2,7 @@
 
 #include "utcoupe/asserv/serial/order.hpp"
 #include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
 
 #include <cmath>
 #include <string_view>
@@ -56,6 +57,36 @@ suite orderParser = [] {
             };
         };
         
+        scenario("Dispatch table") = [&] {
+            constexpr auto allOrders = serial::makeOrderTable(std::tuple{
+                serial::createOrder('a', &Tester::run1),
+                serial::createOrder('b', &Tester::run2),
+                serial::createOrder('c', &Tester::compute1),
+                serial::createOrder('d', &Tester::compute2),
+            });
+            
+            given ("A table built from the orders") = [&] {
+                then ("Each character should point to its order") = [&] {
+                    expect (constant<allOrders.indexOf('a') == 0>);
+                    expect (constant<allOrders.indexOf('d') == 3>);
+                    expect (constant<allOrders.indexOf('x') == serial::impl::NO_ORDER>);
+                };
+                
+                then ("Orders should be executable through it") = [&] {
+                    expect (*parser.parseAndRunOrder(allOrders, "a;5;"sv) == 5_i);
+                    expect (*parser.parseAndRunOrder(allOrders, "d;"sv) == 43_i);
+                    expect (!parser.parseAndRunOrder(allOrders, "x;"sv));
+                };
+            };
+            
+            given ("An empty message") = [&] {
+                then ("It shouldn't be executable") = [&] {
+                    expect (!parser.parseAndRunOrder(allOrders, ""sv));
+                    expect (!parser.parseAndRunOrder(std::tuple{ serial::createOrder('a', &Tester::run1) }, ""sv));
+                };
+            };
+        };
+        
         scenario("Argument parsing") = [&] {
             auto allOrders = std::tuple{
                 serial::createOrder('a', &Tester::run1),
@@ -101,6 +132,23 @@ suite orderParser = [] {
                     expect(!result);
                 } | ordersStr;
             };
+            
+            given ("A truncated frame, e.g. cut by line noise") = [&] {
+                auto ordersStr = std::array{
+                    "c"sv,
+                    "d"sv,
+                    "c;4"sv,
+                    "c;4;5"sv,
+                    "d;3.4"sv,
+                };
+                
+                then ("It should be rejected without reading past its end") = [&] (std::string_view orderStr) {
+                    // Copied to a buffer of its exact size, so that a sanitizer catches any read past the end
+                    const std::vector<char> buffer(orderStr.begin(), orderStr.end());
+                    const std::string_view frame{ buffer.data(), buffer.size() };
+                    expect(!parser.parseAndRunOrder(allOrders, frame));
+                } | ordersStr;
+            };
         };
     };
 };
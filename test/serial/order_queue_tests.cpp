@@ -0,0 +1,69 @@
+#include <boost/ut.hpp>
+
+#include "fake_dispatcher.hpp"
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_queue.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/serial/stream_decoder.hpp"
+
+#include <optional>
+#include <string_view>
+#include <vector>
+
+using namespace std::string_view_literals;
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+namespace {
+    constexpr auto allOrders = serial::makeOrderTable(serial::createAllOrders<test::FakeDispatcher>());
+}
+
+suite orderQueue = [] {
+    tag ("serial") / tag ("order-queue") /
+    feature ("serial::OrderQueue") = [] {
+        test::FakeDispatcher dispatcher;
+        serial::OrderParser parser{dispatcher};
+        
+        scenario ("Deferred execution") = [&] {
+            given ("Orders received from the stream") = [&] {
+                serial::OrderQueue<decltype(allOrders), 4> queue{allOrders};
+                serial::StreamDecoder decoder{parser, allOrders};
+                decoder.feedFrames("d;100;200;1;\nx;\nl;1.5;\n"sv, [&queue](const auto& frame) { queue.push(frame); });
+                
+                then ("They should be decoded but not run yet") = [&] {
+                    expect (queue.size() == 2_ul);
+                    expect (queue.rejectedOrders() == 1_ul);
+                    expect (dispatcher.lastOrder == '\0');
+                };
+                
+                then ("They should be run in order by the consumer") = [&] {
+                    std::vector<std::optional<int>> results;
+                    auto onResult = [&results](auto result) { results.push_back(result); };
+                    
+                    expect (queue.runPending(parser, onResult, 1) == 1_ul);
+                    expect (dispatcher.lastOrder == 'd');
+                    expect (dispatcher.lastIntSum == 301_i);
+                    
+                    expect (queue.runPending(parser, onResult) == 1_ul);
+                    expect (dispatcher.lastOrder == 'l');
+                    expect (dispatcher.lastFloatSum == 1.5_f);
+                    expect (results.size() == 2_ul);
+                    expect (queue.size() == 0_ul);
+                };
+            };
+            
+            given ("More orders than the queue capacity") = [&] {
+                serial::OrderQueue<decltype(allOrders), 2> queue{allOrders};
+                
+                then ("The extra ones should be counted as lost") = [&] {
+                    expect (queue.push("S;"sv));
+                    expect (queue.push("H;"sv));
+                    expect (!queue.push("q;"sv));
+                    expect (queue.overflowedOrders() == 1_ul);
+                };
+            };
+        };
+    };
+};
@@ -0,0 +1,142 @@
+#include <boost/ut.hpp>
+
+#include "fake_dispatcher.hpp"
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_router.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/serial/response_writer.hpp"
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace std::string_view_literals;
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+namespace {
+    constexpr auto allOrders = serial::makeOrderTable(serial::createAllOrders<test::FakeDispatcher>());
+    
+    constexpr std::size_t MAIN_LINK = 0;
+    constexpr std::size_t DEBUG_LINK = 1;
+    
+    using Router = serial::OrderRouter<decltype(allOrders), 2, 8>;
+}
+
+suite orderRouter = [] {
+    tag ("serial") / tag ("order-router") /
+    feature ("serial::OrderRouter") = [] {
+        test::FakeDispatcher dispatcher;
+        serial::OrderParser parser{dispatcher};
+        
+        std::vector<std::pair<std::size_t, char>> runOrders;
+        auto onResult = [&runOrders](std::size_t link, char chOrder, std::optional<int> result) {
+            expect (result.has_value() && *result == chOrder);
+            runOrders.emplace_back(link, chOrder);
+        };
+        
+        scenario ("Link priorities") = [&] {
+            given ("Orders received on a debug link and on the main link") = [&] {
+                Router router{allOrders, { 2, 1 }};
+                runOrders.clear();
+                expect (router.push(DEBUG_LINK, "z;"sv));
+                expect (router.push(MAIN_LINK, "d;100;200;1;"sv));
+                expect (router.push(MAIN_LINK, "S;"sv));
+                expect (!router.push(DEBUG_LINK, "d;abc;"sv));
+                
+                then ("The main link should be served first") = [&] {
+                    expect (router.size(MAIN_LINK) == 2_ul);
+                    expect (router.rejectedOrders(DEBUG_LINK) == 1_ul);
+                    expect (router.runPending(parser, onResult) == 3_ul);
+                    expect (runOrders == std::vector<std::pair<std::size_t, char>>{ { MAIN_LINK, 'd' }, { MAIN_LINK, 'S' }, { DEBUG_LINK, 'z' } });
+                };
+            };
+            
+            given ("Links of equal priority") = [&] {
+                Router router{allOrders};
+                runOrders.clear();
+                router.push(DEBUG_LINK, "z;"sv);
+                router.push(MAIN_LINK, "w;"sv);
+                
+                then ("They should be served in their index order") = [&] {
+                    router.runPending(parser, onResult);
+                    expect (runOrders == std::vector<std::pair<std::size_t, char>>{ { MAIN_LINK, 'w' }, { DEBUG_LINK, 'z' } });
+                };
+            };
+            
+            given ("A binary link") = [&] {
+                Router router{allOrders};
+                runOrders.clear();
+                std::array<char, 32> buffer{};
+                const std::size_t size = serial::encodeBinaryFrame(buffer, 'k', 10, 20);
+                
+                then ("Its checked frames should be routed as well") = [&] {
+                    expect (router.push(DEBUG_LINK, *serial::checkBinaryFrame(std::string_view{ buffer.data(), size })));
+                    expect (router.runPending(parser, onResult) == 1_ul);
+                    expect (dispatcher.lastIntSum == 30_i);
+                };
+            };
+        };
+        
+        scenario ("Urgent orders") = [&] {
+            given ("An emergency stop under load") = [&] {
+                Router router{allOrders, { 1, 0 }};
+                runOrders.clear();
+                for (int i = 0; i < 8; ++i) {
+                    expect (router.push(MAIN_LINK, "d;100;200;1;"sv));
+                }
+                expect (!router.push(MAIN_LINK, "d;100;200;1;"sv));
+                expect (router.push(DEBUG_LINK, "A;1;"sv));
+                
+                then ("It should be run first, outside of the order budget") = [&] {
+                    expect (router.overflowedOrders(MAIN_LINK) == 1_ul);
+                    expect (router.runPending(parser, onResult, 1) == 2_ul);
+                    expect (runOrders == std::vector<std::pair<std::size_t, char>>{ { DEBUG_LINK, 'A' }, { MAIN_LINK, 'd' } });
+                    expect (router.size(MAIN_LINK) == 7_ul);
+                    expect (router.preemptedOrders() == 0_ul);
+                };
+            };
+            
+            given ("A HALT received after some moves") = [&] {
+                Router router{allOrders};
+                runOrders.clear();
+                router.push(MAIN_LINK, "d;100;200;1;"sv);
+                router.push(DEBUG_LINK, "e;1.5;"sv);
+                router.push(DEBUG_LINK, "H;"sv);
+                router.push(MAIN_LINK, "d;300;200;1;"sv);
+                
+                then ("The moves received before it should be discarded") = [&] {
+                    expect (router.runPending(parser, onResult) == 2_ul);
+                    expect (runOrders == std::vector<std::pair<std::size_t, char>>{ { DEBUG_LINK, 'H' }, { MAIN_LINK, 'd' } });
+                    expect (dispatcher.lastIntSum == 501_i);
+                    expect (router.preemptedOrders() == 2_ul);
+                };
+            };
+        };
+        
+        scenario ("Reply routing") = [&] {
+            given ("Queries received on both links") = [&] {
+                Router router{allOrders};
+                router.push(MAIN_LINK, "t;"sv);
+                router.push(DEBUG_LINK, "w;"sv);
+                
+                std::array<std::array<char, 32>, 2> buffers{};
+                std::array writers{ serial::ResponseWriter{ buffers[MAIN_LINK] }, serial::ResponseWriter{ buffers[DEBUG_LINK] } };
+                
+                then ("Each answer should go to the link of its order") = [&] {
+                    router.runPending(parser, [&writers](std::size_t link, char chOrder, std::optional<int> result) {
+                        writers[link].write(chOrder, *result);
+                    });
+                    expect (writers[MAIN_LINK].data() == "t;116;\n"sv);
+                    expect (writers[DEBUG_LINK].data() == "w;119;\n"sv);
+                };
+            };
+        };
+    };
+};
@@ -0,0 +1,96 @@
+#include <boost/ut.hpp>
+
+#include "utcoupe/asserv/serial/order.hpp"
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_stats.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/serial/response_writer.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+
+using namespace std::string_view_literals;
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+namespace {
+    struct DiagnosedExecutor {
+        using OrderReturnT = std::tuple<std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t>;
+        
+        OrderReturnT move(int x, int y) {
+            static_cast<void>(x + y);
+            return {};
+        }
+        
+        OrderReturnT getDiagnostics(int chOrder) {
+            const auto summary = chOrder == 0
+                ? serial::orderStats().total()
+                : serial::orderStats().summary(static_cast<char>(chOrder));
+            return summary.asTuple();
+        }
+    };
+} // namespace
+
+suite orderStats = [] {
+    tag ("serial") / tag ("order-stats") /
+    feature ("serial::OrderStats") = [] {
+        DiagnosedExecutor executor;
+        serial::OrderParser parser{ executor };
+        constexpr auto table = serial::makeOrderTable(std::tuple{
+            serial::createOrder('d', &DiagnosedExecutor::move),
+            serial::createOrder(serial::OrderTypes::DIAGNOSTICS, &DiagnosedExecutor::getDiagnostics),
+        });
+        
+        scenario ("Recording") = [&] {
+            given ("Orders run, malformed or unknown") = [&] {
+                serial::orderStats().reset();
+                parser.parseAndRunOrder(table, "d;1;2;"sv);
+                parser.parseAndRunOrder(table, "d;3;4;"sv);
+                parser.parseAndRunOrder(table, "d;3;"sv);
+                parser.parseAndRunOrder(table, "Z;"sv);
+                
+                then ("Each order type should have its own counters") = [&] {
+                    const auto moves = serial::orderStats().summary('d');
+                    expect (moves.count == 2_u);
+                    expect (moves.failures == 1_u);
+                    expect (moves.minTicks <= moves.meanTicks && moves.meanTicks <= moves.maxTicks);
+                    expect (serial::orderStats().summary('Z').failures == 1_u);
+                    expect (serial::orderStats().summary('D').count == 0_u);
+                };
+                
+                then ("The histogram should hold every run") = [&] {
+                    std::uint32_t histogramCount = 0;
+                    for (std::size_t bucket = 0; bucket < serial::LATENCY_BUCKETS; ++bucket) {
+                        histogramCount += serial::orderStats().histogram(bucket);
+                    }
+                    expect (histogramCount == 2_u);
+                    expect (serial::orderStats().total().failures == 2_u);
+                };
+            };
+        };
+        
+        scenario ("Diagnostics order") = [&] {
+            given ("Stats recorded for some orders") = [&] {
+                serial::orderStats().reset();
+                parser.parseAndRunOrder(table, "d;1;2;"sv);
+                parser.parseAndRunOrder(table, "d;1;"sv);
+                
+                then ("They should be queried through the DIAGNOSTICS order") = [&] {
+                    auto result = parser.parseAndRunOrder(table, "D;100;"sv);
+                    expect ((result.has_value()) >> fatal);
+                    expect (std::get<0>(*result) == 1_u);
+                    expect (std::get<1>(*result) == 1_u);
+                    
+                    std::array<char, 64> buffer{};
+                    serial::ResponseWriter writer{ buffer };
+                    writer.write('D', *parser.parseAndRunOrder(table, "D;0;"sv));
+                    expect (writer.data().starts_with("D;2;1;"sv)) << writer.data();
+                };
+            };
+        };
+    };
+};
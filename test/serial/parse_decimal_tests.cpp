@@ -0,0 +1,83 @@
+#include <boost/ut.hpp>
+
+#include "utcoupe/asserv/serial/parse_decimal.hpp"
+
+#include <array>
+#include <charconv>
+#include <string_view>
+
+using namespace std::string_view_literals;
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+suite parseDecimal = [] {
+    tag ("serial") / tag ("parse-decimal") /
+    feature ("serial::impl::from_chars_fp") = [] {
+        scenario ("Protocol values") = [] {
+            given ("Short decimal values") = [] {
+                auto valuesStr = std::array{
+                    "0"sv, "1"sv, "-1"sv, "1.4"sv, "0.8"sv, "3.14159"sv, "-0.035"sv, "1200.5"sv,
+                    "0.0001"sv, "000012.50"sv, ".5"sv, "5."sv, "2.5e3"sv, "-7.25E-2"sv, "16777217"sv,
+                };
+                
+                then ("They should be parsed exactly as std::from_chars does") = [] (std::string_view valueStr) {
+                    float value = 0.f;
+                    auto end = serial::impl::from_chars_fp(valueStr.data(), valueStr.data() + valueStr.size(), value);
+                    expect ((end.has_value() && *end == valueStr.data() + valueStr.size()) >> fatal) << valueStr;
+                    
+                    float expected = 0.f;
+                    std::from_chars(valueStr.data(), valueStr.data() + valueStr.size(), expected);
+                    expect (value == expected) << valueStr;
+                } | valuesStr;
+                
+                then ("Double values should be parsed exactly as std::from_chars does") = [] (std::string_view valueStr) {
+                    double value = 0.;
+                    serial::impl::from_chars_fp(valueStr.data(), valueStr.data() + valueStr.size(), value);
+                    
+                    double expected = 0.;
+                    std::from_chars(valueStr.data(), valueStr.data() + valueStr.size(), expected);
+                    expect (value == expected) << valueStr;
+                } | valuesStr;
+            };
+            
+            given ("Values followed by separators") = [] {
+                then ("Parsing should stop on the first char that isn't part of the value") = [] {
+                    float value = 0.f;
+                    std::string_view str = "1.5;2e;3"sv;
+                    auto end = serial::impl::from_chars_fp(str.data(), str.data() + str.size(), value);
+                    expect ((end.has_value() && **end == ';') >> fatal);
+                    expect (value == 1.5_f);
+                    
+                    end = serial::impl::from_chars_fp(*end + 1, str.data() + str.size(), value);
+                    expect ((end.has_value() && **end == 'e') >> fatal);
+                    expect (value == 2._f);
+                };
+            };
+        };
+        
+        scenario ("Bounds") = [] {
+            given ("A range ending in the middle of a number") = [] {
+                std::string_view str = "12.345"sv;
+                
+                then ("Nothing after the range should be read") = [&] {
+                    float value = 0.f;
+                    auto end = serial::impl::from_chars_fp(str.data(), str.data() + 4, value);
+                    expect ((end.has_value() && *end == str.data() + 4) >> fatal);
+                    expect (value == 12.3_f);
+                };
+            };
+            
+            given ("Strings that aren't numbers") = [] {
+                auto valuesStr = std::array{ ""sv, "-"sv, "."sv, "-.e5"sv, ";1"sv, "+1"sv, "1e99"sv };
+                
+                then ("They should be rejected and leave the value untouched") = [] (std::string_view valueStr) {
+                    float value = 42.f;
+                    auto end = serial::impl::from_chars_fp(valueStr.data(), valueStr.data() + valueStr.size(), value);
+                    expect (!end) << valueStr;
+                    expect (value == 42._f) << valueStr;
+                } | valuesStr;
+            };
+        };
+    };
+};
@@ -0,0 +1,157 @@
+#include <boost/ut.hpp>
+
+#include "fake_dispatcher.hpp"
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/decoded_order.hpp"
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/parse_error.hpp"
+#include "utcoupe/asserv/serial/parse_parameters.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/serial/response_writer.hpp"
+
+#include <array>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+using namespace std::string_view_literals;
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+namespace {
+    constexpr auto allOrders = serial::makeOrderTable(serial::createAllOrders<test::FakeDispatcher>());
+    
+    template<class... ArgsT>
+    serial::ParseError parseErrorOf(std::string_view str) {
+        return serial::parseParameters<ArgsT...>(str.data(), str.data() + str.size()).error();
+    }
+} // namespace
+
+suite parseError = [] {
+    tag ("serial") / tag ("parse-error") /
+    feature ("serial::ParseError") = [] {
+        scenario ("Parameter parsing") = [] {
+            given ("Parameters correctly formed") = [] {
+                then ("They should be parsed without error") = [] {
+                    constexpr std::string_view str = "12;-3.5;";
+                    auto values = serial::parseParameters<int, float>(str.data(), str.data() + str.size());
+                    expect (values.has_value() >> fatal);
+                    expect (std::get<0>(*values) == 12_i);
+                    expect (std::get<1>(*values) == -3.5_f);
+                    expect (values.error() == serial::ParseError::NONE);
+                };
+            };
+            
+            given ("Malformed parameters") = [] {
+                auto cases = std::array{
+                    std::pair{ ""sv, serial::ParseError::MISSING_ARG },
+                    std::pair{ "12;"sv, serial::ParseError::MISSING_ARG },
+                    std::pair{ "12;3"sv, serial::ParseError::MISSING_ARG },
+                    std::pair{ "12;abc;"sv, serial::ParseError::BAD_NUMBER },
+                    std::pair{ "12;;"sv, serial::ParseError::BAD_NUMBER },
+                    std::pair{ "12a;3;"sv, serial::ParseError::BAD_NUMBER },
+                    std::pair{ "12 3;"sv, serial::ParseError::BAD_NUMBER },
+                    std::pair{ "12;3;4;"sv, serial::ParseError::TRAILING_DATA },
+                    std::pair{ "12;3;;"sv, serial::ParseError::TRAILING_DATA },
+                    std::pair{ "2147483648;3;"sv, serial::ParseError::OUT_OF_RANGE },
+                    std::pair{ "12;1e40;"sv, serial::ParseError::OUT_OF_RANGE },
+                };
+                
+                then ("Each one should be rejected with its reason") = [] (auto parseCase) {
+                    expect (parseErrorOf<int, float>(parseCase.first) == parseCase.second);
+                } | cases;
+            };
+            
+            given ("Fixed-point parameters out of range") = [] {
+                then ("They should be told apart from other values") = [] {
+                    expect (parseErrorOf<Q16_16>("32768;"sv) == serial::ParseError::OUT_OF_RANGE);
+                    expect (parseErrorOf<Q16_16>("-x;"sv) == serial::ParseError::BAD_NUMBER);
+                };
+            };
+        };
+        
+        scenario ("Order parsing") = [] {
+            test::FakeDispatcher dispatcher;
+            serial::OrderParser parser{dispatcher};
+            
+            given ("Frames rejected for various reasons") = [&] {
+                serial::parseErrors().reset();
+                
+                then ("The parser should tell why, and count each reason") = [&] {
+                    expect (!parser.parseAndRunOrder(allOrders, "Z;1;"sv));
+                    expect (parser.lastError() == serial::ParseError::UNKNOWN_ORDER);
+                    expect (!parser.parseAndRunOrder(allOrders, "d1;2;3;"sv));
+                    expect (parser.lastError() == serial::ParseError::UNKNOWN_ORDER);
+                    expect (!parser.parseAndRunOrder(allOrders, "d;1;2;"sv));
+                    expect (parser.lastError() == serial::ParseError::MISSING_ARG);
+                    expect (!parser.parseAndRunOrder(allOrders, "d;1;2;3;4;"sv));
+                    expect (parser.lastError() == serial::ParseError::TRAILING_DATA);
+                    expect (!parser.parseAndRunOrder(allOrders, "g;1;"sv));
+                    expect (parser.lastError() == serial::ParseError::TRAILING_DATA);
+                    
+                    expect (dispatcher.lastOrder == '\0');
+                    expect (serial::parseErrors().count(serial::ParseError::UNKNOWN_ORDER) == 2_u);
+                    expect (serial::parseErrors().count(serial::ParseError::MISSING_ARG) == 1_u);
+                    expect (serial::parseErrors().count(serial::ParseError::TRAILING_DATA) == 2_u);
+                    expect (serial::parseErrors().total() == 5_u);
+                };
+                
+                then ("A run order should clear the last error") = [&] {
+                    expect (parser.parseAndRunOrder(allOrders, "d;1;2;3;"sv).has_value());
+                    expect (parser.lastError() == serial::ParseError::NONE);
+                    expect (serial::parseErrors().count(serial::ParseError::NONE) == 0_u);
+                };
+            };
+            
+            given ("Binary frames whose payload doesn't match the order") = [&] {
+                std::array<char, 32> buffer{};
+                
+                then ("Missing and trailing bytes should be told apart") = [&] {
+                    const std::size_t shortSize = serial::encodeBinaryFrame(buffer, 'd', 1, 2);
+                    expect (!parser.parseAndRunBinaryOrder(allOrders, std::string_view{ buffer.data(), shortSize }));
+                    expect (parser.lastError() == serial::ParseError::MISSING_ARG);
+                    
+                    const std::size_t longSize = serial::encodeBinaryFrame(buffer, 'd', 1, 2, 3, 4);
+                    expect (!parser.parseAndRunBinaryOrder(allOrders, std::string_view{ buffer.data(), longSize }));
+                    expect (parser.lastError() == serial::ParseError::TRAILING_DATA);
+                    
+                    buffer[4] ^= 1;
+                    expect (!parser.parseAndRunBinaryOrder(allOrders, std::string_view{ buffer.data(), longSize }));
+                    expect (parser.lastError() == serial::ParseError::BAD_CHECKSUM);
+                };
+            };
+            
+            given ("An order decoded ahead of its run") = [] {
+                then ("The decoding should tell why it failed") = [] {
+                    expect (serial::decodeOrder(allOrders, "d;1;x;3;"sv).error() == serial::ParseError::BAD_NUMBER);
+                    expect (serial::decodeOrder(allOrders, ""sv).error() == serial::ParseError::UNKNOWN_ORDER);
+                    expect (serial::decodeOrder(allOrders, "g;"sv).has_value());
+                };
+            };
+        };
+        
+        scenario ("Error responses") = [] {
+            given ("A rejected order") = [] {
+                then ("The host should be told which order to send again, and why") = [] {
+                    std::array<char, 32> buffer{};
+                    serial::ResponseWriter writer{buffer};
+                    expect (writer.writeError('d', serial::ParseError::MISSING_ARG) >> fatal);
+                    expect (writer.data() == "!;100;2;\n"sv);
+                };
+                
+                then ("Binary responses should carry the same values") = [] {
+                    std::array<char, 32> buffer{};
+                    serial::ResponseWriter<serial::FrameFormat::BINARY> writer{buffer};
+                    expect (writer.writeError('\xA5', serial::ParseError::BAD_NUMBER) >> fatal);
+                    
+                    auto frame = serial::checkBinaryFrame(writer.data());
+                    expect (frame.has_value() >> fatal);
+                    expect (frame->chOrder == serial::PARSE_ERROR_RESPONSE);
+                    expect (frame->payload == "\xA5\x03"sv);
+                };
+            };
+        };
+    };
+};
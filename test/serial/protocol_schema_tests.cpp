@@ -0,0 +1,114 @@
+#include <boost/ut.hpp>
+
+#include "fake_dispatcher.hpp"
+#include "utcoupe/asserv/fixed_point.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/serial/protocol_schema.hpp"
+#include "utcoupe/asserv/simulation/simulated_robot.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <variant>
+
+using namespace std::string_view_literals;
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+namespace {
+    constexpr auto fakeOrders = serial::makeOrderTable(serial::createAllOrders<test::FakeDispatcher>());
+    constexpr auto fakeSchema = serial::makeProtocolSchema(fakeOrders);
+    
+    constexpr auto robotOrders = serial::makeOrderTable(serial::createAllOrders<simulation::SimulatedRobot>());
+    constexpr auto robotSchema = serial::makeProtocolSchema(robotOrders);
+    
+    constexpr const serial::OrderSchema& schemaOf(const auto& schema, serial::OrderTypes type) {
+        return *std::find_if(schema.begin(), schema.end(), [type](const auto& order) { return order.chOrder == static_cast<char>(type); });
+    }
+    
+    // The schema is fully built at compile time
+    static_assert(schemaOf(fakeSchema, serial::OrderTypes::GOTO).name == "GOTO");
+    static_assert(schemaOf(fakeSchema, serial::OrderTypes::GOTO).args.elements.size() == 3);
+    static_assert(schemaOf(fakeSchema, serial::OrderTypes::GOTO).binaryPayloadSize == 12);
+}
+
+suite protocolSchema = [] {
+    tag ("serial") / tag ("protocol-schema") /
+    feature ("serial::makeProtocolSchema") = [] {
+        scenario ("Order descriptions") = [] {
+            given ("The schema of every order of the protocol") = [] {
+                then ("Each one should be named after its order type") = [] {
+                    expect (fakeSchema.size() == std::tuple_size_v<decltype(fakeOrders.orders)>);
+                    for (const auto& order : fakeSchema) {
+                        expect (!order.name.empty()) << order.chOrder;
+                        expect (serial::orderName(static_cast<serial::OrderTypes>(order.chOrder)) == order.name);
+                    }
+                };
+                
+                then ("Each one should describe its callback") = [] {
+                    const auto& gotoWithAngle = schemaOf(fakeSchema, serial::OrderTypes::GOTO_WITH_ANGLE);
+                    expect (gotoWithAngle.args.kind == serial::ValueKind::TUPLE);
+                    expect ((gotoWithAngle.args.elements.size() == 4_ul) >> fatal);
+                    expect (gotoWithAngle.args.elements[0].kind == serial::ValueKind::SIGNED);
+                    expect (gotoWithAngle.args.elements[0].bits == 32_u);
+                    expect (gotoWithAngle.args.elements[2].kind == serial::ValueKind::FLOAT);
+                    expect (gotoWithAngle.result.kind == serial::ValueKind::SIGNED);
+                    
+                    const auto& telemetry = schemaOf(fakeSchema, serial::OrderTypes::TELEMETRY);
+                    expect (telemetry.args.elements[0].kind == serial::ValueKind::UNSIGNED);
+                    expect (schemaOf(fakeSchema, serial::OrderTypes::START).args.elements.empty());
+                };
+            };
+            
+            given ("Orders answering with several possible values") = [] {
+                then ("Their result should list every alternative") = [] {
+                    const auto& result = schemaOf(robotSchema, serial::OrderTypes::GET_POS).result;
+                    expect (result.kind == serial::ValueKind::VARIANT);
+                    expect (result.elements.size() == std::variant_size_v<simulation::SimulationResult>);
+                    expect (result.elements[0].kind == serial::ValueKind::NONE);
+                    expect (result.elements[3].kind == serial::ValueKind::TUPLE);
+                    expect (result.elements[3].elements[2].kind == serial::ValueKind::FLOAT);
+                };
+            };
+            
+            given ("Fixed-point values") = [] {
+                then ("Their format should be described") = [] {
+                    const auto& fixed = serial::typeSchemaOf<Q16_16>;
+                    expect (fixed.kind == serial::ValueKind::FIXED);
+                    expect (fixed.bits == 32_u);
+                    expect (fixed.fractionalBits == 16_u);
+                };
+            };
+        };
+        
+        scenario ("JSON export") = [] {
+            given ("The schema of the protocol") = [] {
+                std::string json;
+                serial::writeSchemaJson(robotSchema, [&json](std::string_view part) { json += part; });
+                
+                then ("Each order should be written on its own line") = [&] {
+                    expect (json.starts_with("{\n  \"valueSeparator\": \";\",\n  \"frameTerminator\": \"\\n\",\n  \"binaryFrameStart\": 165,"sv));
+                    expect (json.find("{\"char\": \"d\", \"name\": \"GOTO\", \"args\": [\"int32\", \"int32\", \"int32\"], \"result\": {\"oneOf\": [null, \"int32\", ") != std::string::npos);
+                    expect (json.find("{\"char\": \"T\", \"name\": \"TELEMETRY\", \"args\": [\"uint32\", \"uint32\"], ") != std::string::npos);
+                    expect (json.find("\"binaryPayloadSize\": 12}") != std::string::npos);
+                    expect (json.ends_with("\n  ]\n}\n"sv));
+                };
+            };
+            
+            given ("Fixed-point and void types") = [] {
+                std::string json;
+                auto write = [&json](std::string_view part) { json += part; };
+                serial::impl::writeJsonType(write, serial::typeSchemaOf<std::tuple<Q16_16, bool, std::uint8_t>>);
+                serial::impl::writeJsonType(write, serial::typeSchemaOf<void>);
+                
+                then ("They should be named") = [&] {
+                    expect (json == "[\"q16.16\", \"bool\", \"uint8\"]null"sv);
+                };
+            };
+        };
+    };
+};
@@ -0,0 +1,58 @@
+#include <boost/ut.hpp>
+
+#include "fake_dispatcher.hpp"
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+
+#include <string_view>
+#include <vector>
+
+using namespace std::string_view_literals;
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+suite protocol = [] {
+    tag ("serial") / tag ("protocol") /
+    feature ("serial::createAllOrders") = [] {
+        test::FakeDispatcher dispatcher;
+        serial::OrderParser parser{dispatcher};
+        constexpr auto allOrders = serial::makeOrderTable(serial::createAllOrders<test::FakeDispatcher>());
+        
+        scenario ("Order dispatch") = [&] {
+            given ("Every order of the protocol correctly formed") = [&] {
+                std::vector<std::string_view> ordersStr {
+                    "l;1.5;"sv, "u;1;2;3;"sv, "p;1;2;3;"sv, "i;1;2;3;"sv, "x;2.5;"sv,
+                    "j;"sv, "n;"sv, "o;"sv, "y;"sv, "v;"sv, "d;1;2;1;"sv, "c;1;2;0.5;1;"sv,
+                    "k;10;20;"sv, "e;1.5;"sv, "a;1.5;"sv, "A;1;"sv, "m;1;2;0.5;"sv, "b;1;2;3;"sv,
+                    "g;"sv, "t;"sv, "H;"sv, "f;"sv, "q;"sv, "z;"sv, "s;"sv, "r;"sv, "S;"sv, "w;"sv, "T;3;20;"sv, "D;100;"sv,
+                };
+                
+                then ("Each one should run its own callback") = [&] (std::string_view orderStr) {
+                    auto result = parser.parseAndRunOrder(allOrders, orderStr);
+                    expect (result.has_value() >> fatal) << orderStr;
+                    expect (*result == orderStr.front()) << orderStr;
+                    expect (dispatcher.lastOrder == orderStr.front()) << orderStr;
+                } | ordersStr;
+            };
+            
+            given ("A character that isn't part of the protocol") = [&] {
+                then ("It shouldn't be executable") = [&] {
+                    expect (!parser.parseAndRunOrder(allOrders, "Z;"sv));
+                    expect (!parser.parseAndRunOrder(allOrders, "\xff;"sv));
+                    expect (!parser.parseAndRunOrder(allOrders, ""sv));
+                };
+            };
+        };
+        
+        scenario ("Order characters") = [] {
+            given ("The orders of the protocol") = [] {
+                then ("All of them should have a distinct character") = [] {
+                    expect (constant<serial::hasUniqueOrderChars(serial::createAllOrders<test::FakeDispatcher>())>);
+                    expect (constant<std::tuple_size_v<decltype(serial::createAllOrders<test::FakeDispatcher>())> == 30>);
+                };
+            };
+        };
+    };
+};
@@ -0,0 +1,132 @@
+#include <boost/ut.hpp>
+
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/response_writer.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+#include <variant>
+
+using namespace std::string_view_literals;
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+suite responseWriter = [] {
+    tag ("serial") / tag ("response-writer") /
+    feature ("serial::ResponseWriter") = [] {
+        scenario ("ASCII responses") = [] {
+            given ("Results of various types") = [] {
+                std::array<char, 64> buffer{};
+                serial::ResponseWriter writer{buffer};
+                
+                then ("They should be formatted like orders") = [&] {
+                    expect (writer.write('t', 12) >> fatal);
+                    expect (writer.data() == "t;12;\n"sv);
+                    
+                    writer.clear();
+                    expect (writer.write('n', std::tuple{ 1200, -340, 1.5f }) >> fatal);
+                    expect (writer.data() == "n;1200;-340;1.5;\n"sv);
+                    
+                    writer.clear();
+                    expect (writer.write('S', std::monostate{}) >> fatal);
+                    expect (writer.data() == "S;\n"sv);
+                };
+                
+                then ("Variants should write their active alternative") = [&] {
+                    writer.clear();
+                    std::variant<std::monostate, int, std::tuple<int, int>> value = std::tuple{ 3, 4 };
+                    expect (writer.write('j', value) >> fatal);
+                    expect (writer.data() == "j;3;4;\n"sv);
+                };
+            };
+            
+            given ("Several responses") = [] {
+                std::array<char, 16> buffer{};
+                serial::ResponseWriter writer{buffer};
+                
+                then ("They should be appended until the buffer is full") = [&] {
+                    expect (writer.write('t', 1) >> fatal);
+                    expect (writer.write('t', 2) >> fatal);
+                    expect (!writer.write('t', 123456789));
+                    expect (writer.data() == "t;1;\nt;2;\n"sv);
+                    expect (writer.available() == 6_ul);
+                };
+            };
+            
+            given ("Values only known at runtime") = [] {
+                std::array<char, 16> buffer{};
+                serial::ResponseWriter writer{buffer};
+                
+                then ("They should be appended to the same response") = [&] {
+                    writer.beginResponse('T');
+                    for (int value = 1; value <= 3; ++value) {
+                        writer.append(value);
+                    }
+                    expect (writer.endResponse() >> fatal);
+                    expect (writer.data() == "T;1;2;3;\n"sv);
+                };
+                
+                then ("A response overflowing the buffer should be discarded as a whole") = [&] {
+                    writer.beginResponse('T');
+                    writer.append(std::tuple{ 123456, 789 });
+                    expect (!writer.endResponse());
+                    expect (writer.data() == "T;1;2;3;\n"sv);
+                };
+            };
+        };
+        
+        scenario ("Binary responses") = [] {
+            given ("A tuple result") = [] {
+                std::array<char, 32> buffer{};
+                serial::ResponseWriter<serial::FrameFormat::BINARY> writer{buffer};
+                
+                then ("It should be encoded as a binary frame") = [&] {
+                    expect (writer.write('n', std::tuple{ 1200, -340, 1.5f }) >> fatal);
+                    expect ((writer.data().size() == serial::binaryFrameSize(12)) >> fatal);
+                    
+                    auto frame = serial::checkBinaryFrame(writer.data());
+                    expect (frame.has_value() >> fatal);
+                    expect (frame->chOrder == 'n');
+                    
+                    std::tuple<int, int, float> values;
+                    expect (serial::decodeBinaryParameters(frame->payload, values) >> fatal);
+                    expect (std::get<0>(values) == 1200_i);
+                    expect (std::get<1>(values) == -340_i);
+                    expect (std::get<2>(values) == 1.5_f);
+                };
+                
+                then ("Nothing should be written if it doesn't fit") = [&] {
+                    writer.clear();
+                    std::array<char, 8> smallBuffer{};
+                    serial::ResponseWriter<serial::FrameFormat::BINARY> smallWriter{smallBuffer};
+                    expect (!smallWriter.write('n', std::tuple{ 1200, -340, 1.5f }));
+                    expect (smallWriter.data().empty());
+                };
+            };
+            
+            given ("Values only known at runtime") = [] {
+                std::array<char, 32> buffer{};
+                serial::ResponseWriter<serial::FrameFormat::BINARY> writer{buffer};
+                
+                then ("The payload size and the CRC should be set when the response ends") = [&] {
+                    writer.beginResponse('T');
+                    writer.append(std::uint8_t{ 7 });
+                    writer.append(-2);
+                    expect (writer.endResponse() >> fatal);
+                    
+                    auto frame = serial::checkBinaryFrame(writer.data());
+                    expect (frame.has_value() >> fatal);
+                    expect (frame->chOrder == 'T');
+                    
+                    std::tuple<std::uint8_t, int> values;
+                    expect (serial::decodeBinaryParameters(frame->payload, values) >> fatal);
+                    expect (int{ std::get<0>(values) } == 7_i);
+                    expect (std::get<1>(values) == -2_i);
+                };
+            };
+        };
+    };
+};
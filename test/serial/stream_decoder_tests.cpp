@@ -0,0 +1,147 @@
+#include <boost/ut.hpp>
+
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/order.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/stream_decoder.hpp"
+
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std::string_view_literals;
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+namespace {
+    struct Tester {
+        using OrderReturnT = int;
+        
+        constexpr int run(int x, int y) { return x + y; }
+        constexpr int compute() { return 42; }
+    };
+    
+    constexpr auto allOrders = serial::makeOrderTable(std::tuple{
+        serial::createOrder('a', &Tester::run),
+        serial::createOrder('c', &Tester::compute),
+    });
+}
+
+suite streamDecoder = [] {
+    tag ("serial") / tag ("stream-decoder") /
+    feature ("serial::StreamDecoder") = [] {
+        Tester tester;
+        serial::OrderParser parser{tester};
+        
+        scenario ("Frame reassembly") = [&] {
+            given ("Several frames received in a single chunk") = [&] {
+                serial::StreamDecoder<Tester, decltype(allOrders), 16> decoder{parser, allOrders};
+                std::vector<std::optional<int>> results;
+                
+                then ("They should all be run, in order") = [&] {
+                    auto frames = decoder.feed("a;1;2;\nc;\r\na;3;4;\n"sv, [&results](auto result) { results.push_back(result); });
+                    expect (frames == 3_ul);
+                    expect ((results.size() == 3_ul) >> fatal);
+                    expect (*results[0] == 3_i);
+                    expect (*results[1] == 42_i);
+                    expect (*results[2] == 7_i);
+                    expect (decoder.pendingSize() == 0_ul);
+                };
+            };
+            
+            given ("A frame split across several chunks") = [&] {
+                serial::StreamDecoder<Tester, decltype(allOrders), 16> decoder{parser, allOrders};
+                std::vector<std::optional<int>> results;
+                auto onResult = [&results](auto result) { results.push_back(result); };
+                
+                then ("It should only be run once its terminator is received") = [&] {
+                    expect (decoder.feed("a;1"sv, onResult) == 0_ul);
+                    expect (decoder.feed(";2"sv, onResult) == 0_ul);
+                    expect (decoder.pendingSize() == 5_ul);
+                    expect (results.empty());
+                    expect (decoder.feed(";\nc;"sv, onResult) == 1_ul);
+                    expect ((results.size() == 1_ul) >> fatal);
+                    expect (*results[0] == 3_i);
+                    expect (decoder.pendingSize() == 2_ul);
+                };
+            };
+        };
+        
+        scenario ("Corrupted stream") = [&] {
+            given ("A frame longer than the buffer") = [&] {
+                serial::StreamDecoder<Tester, decltype(allOrders), 8> decoder{parser, allOrders};
+                std::vector<std::optional<int>> results;
+                auto onResult = [&results](auto result) { results.push_back(result); };
+                
+                then ("It should be dropped without affecting the next frames") = [&] {
+                    decoder.feed("a;1000;"sv, onResult);
+                    decoder.feed("2000;"sv, onResult);
+                    decoder.feed("3000;\na;1;"sv, onResult);
+                    decoder.feed("1;\n"sv, onResult);
+                    expect (decoder.droppedFrames() == 1_ul);
+                    expect ((results.size() == 1_ul) >> fatal);
+                    expect (*results[0] == 2_i);
+                };
+            };
+            
+            given ("An unknown or malformed frame") = [&] {
+                serial::StreamDecoder decoder{parser, allOrders};
+                std::vector<std::optional<int>> results;
+                
+                then ("Its result should be empty") = [&] {
+                    decoder.feed("x;\na;1;\n\n"sv, [&results](auto result) { results.push_back(result); });
+                    expect ((results.size() == 2_ul) >> fatal);
+                    expect (!results[0]);
+                    expect (!results[1]);
+                };
+            };
+        };
+        
+        scenario ("Binary resynchronization") = [&] {
+            given ("A corrupted frame holding a shorter frame header") = [&] {
+                serial::StreamDecoder<Tester, decltype(allOrders), 64, serial::FrameFormat::BINARY> decoder{parser, allOrders};
+                std::vector<std::optional<int>> results;
+                auto onResult = [&results](auto result) { results.push_back(result); };
+                
+                // The resynchronization keeps more bytes than the frame announced by the inner header
+                std::string stream{ "\xA5x\x0A\xA5y\x00ppppppp\xCC\xCC"sv };
+                stream.append(200, 'z');
+                
+                then ("It should be dropped without writing past the buffer") = [&] {
+                    decoder.feed(stream, onResult);
+                    expect (results.empty());
+                    expect (decoder.droppedFrames() == 2_ul);
+                    expect (decoder.pendingSize() == 0_ul);
+                    
+                    std::array<char, 16> buffer{};
+                    const auto size = serial::encodeBinaryOrder(buffer, std::get<0>(allOrders.orders), { 1, 2 });
+                    decoder.feed({ buffer.data(), size }, onResult);
+                    expect ((results.size() == 1_ul) >> fatal);
+                    expect (*results[0] == 3_i);
+                };
+            };
+            
+            given ("A corrupted frame holding a whole valid frame") = [&] {
+                serial::StreamDecoder<Tester, decltype(allOrders), 64, serial::FrameFormat::BINARY> decoder{parser, allOrders};
+                std::vector<std::optional<int>> results;
+                
+                std::array<char, 16> buffer{};
+                const auto size = serial::encodeBinaryOrder(buffer, std::get<1>(allOrders.orders), {});
+                std::string stream = "\xA5x\x05";
+                stream.append(buffer.data(), size);
+                stream += "zz";
+                
+                then ("The valid frame should be run without waiting for the next chunk") = [&] {
+                    decoder.feed(stream, [&results](auto result) { results.push_back(result); });
+                    expect ((results.size() == 1_ul) >> fatal);
+                    expect (*results[0] == 42_i);
+                    expect (decoder.droppedFrames() == 1_ul);
+                    expect (decoder.pendingSize() == 0_ul);
+                };
+            };
+        };
+    };
+};
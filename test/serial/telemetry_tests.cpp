@@ -0,0 +1,85 @@
+#include <boost/ut.hpp>
+
+#include "fake_dispatcher.hpp"
+#include "utcoupe/asserv/serial/response_writer.hpp"
+#include "utcoupe/asserv/serial/telemetry.hpp"
+
+#include <array>
+#include <string_view>
+
+using namespace std::string_view_literals;
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+suite telemetry = [] {
+    tag ("serial") / tag ("telemetry") /
+    feature ("serial::TelemetryStreamer") = [] {
+        test::FakeDispatcher dispatcher;
+        
+        scenario ("Periodic frames") = [&] {
+            given ("A subscription to the position and speed every 10ms with a 5ms control loop") = [&] {
+                serial::TelemetryStreamer streamer{5000};
+                expect (streamer.subscribe(serial::TelemetryField::POS | serial::TelemetryField::SPEED, 10) >> fatal);
+                
+                std::array<char, 64> buffer{};
+                serial::ResponseWriter writer{buffer};
+                
+                then ("A single frame holding both fields should be written every two ticks") = [&] {
+                    expect (streamer.periodTicks() == 2_u);
+                    expect (!streamer.tick(dispatcher, writer));
+                    expect (writer.data().empty());
+                    
+                    expect (streamer.tick(dispatcher, writer));
+                    expect (writer.data() == "T;0;3;110;121;\n"sv);
+                    
+                    writer.clear();
+                    expect (!streamer.tick(dispatcher, writer));
+                    expect (streamer.tick(dispatcher, writer));
+                    expect (writer.data() == "T;1;3;110;121;\n"sv);
+                };
+            };
+            
+            given ("A subscription with a period shorter than the control loop") = [&] {
+                serial::TelemetryStreamer streamer{5000};
+                expect (streamer.subscribe(static_cast<std::uint32_t>(serial::TelemetryField::CODER), 1) >> fatal);
+                
+                then ("A frame should be written every tick") = [&] {
+                    expect (streamer.periodTicks() == 1_u);
+                };
+            };
+            
+            given ("A control loop period of 0") = [&] {
+                serial::TelemetryStreamer streamer{0};
+                
+                then ("It should be taken as 1us") = [&] {
+                    expect (streamer.subscribe(static_cast<std::uint32_t>(serial::TelemetryField::CODER), 1) >> fatal);
+                    expect (streamer.periodTicks() == 1000_u);
+                };
+            };
+        };
+        
+        scenario ("Subscription changes") = [&] {
+            serial::TelemetryStreamer streamer{5000};
+            std::array<char, 64> buffer{};
+            serial::ResponseWriter writer{buffer};
+            
+            given ("An unknown field") = [&] {
+                then ("The subscription should be rejected") = [&] {
+                    expect (!streamer.subscribe(1U << 20, 10));
+                    expect (!streamer.isActive());
+                };
+            };
+            
+            given ("A null period") = [&] {
+                expect (streamer.subscribe(serial::ALL_TELEMETRY_FIELDS, 0) >> fatal);
+                
+                then ("Nothing should be streamed") = [&] {
+                    expect (!streamer.isActive());
+                    expect (!streamer.tick(dispatcher, writer));
+                    expect (writer.data().empty());
+                };
+            };
+        };
+    };
+};
@@ -0,0 +1,165 @@
+#include <boost/ut.hpp>
+
+#include "utcoupe/asserv/serial/binary_codec.hpp"
+#include "utcoupe/asserv/serial/trace_recorder.hpp"
+
+#include <array>
+#include <string_view>
+#include <vector>
+
+using namespace std::string_view_literals;
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+namespace {
+    /** A robot moving forward by 1 mm and 10 ticks per wheel every tick. */
+    serial::TraceState movingState(std::int32_t tick) {
+        return { tick * 10, 500, -15708, tick * 10, tick * 10, 120, -118 };
+    }
+    
+    template<class RecorderT>
+    std::vector<char> exportTrace(const RecorderT& recorder) {
+        std::vector<char> trace(recorder.exportSize());
+        recorder.exportTo(trace);
+        return trace;
+    }
+}
+
+suite traceRecorder = [] {
+    tag ("serial") / tag ("trace") /
+    feature ("serial::TraceRecorder") = [] {
+        scenario ("Recording") = [] {
+            given ("Frames and states recorded over a few ticks") = [] {
+                serial::TraceRecorder<> recorder;
+                recorder.recordFrame("d;1000;0;1;"sv);
+                recorder.recordState(movingState(0));
+                recorder.recordState(movingState(1));
+                recorder.recordFrame(serial::BinaryFrame{ 'A', "\x01\x00\x00\x00"sv });
+                recorder.recordState(movingState(2));
+                
+                const auto trace = exportTrace(recorder);
+                auto reader = serial::TraceReader::open({ trace.data(), trace.size() });
+                
+                then ("They should be read back in order, with their ticks") = [&] {
+                    expect ((reader.has_value()) >> fatal);
+                    
+                    auto record = reader->next();
+                    expect ((record.has_value() && record->type == serial::TraceRecordType::ASCII_FRAME) >> fatal);
+                    expect (record->tick == 0_u);
+                    expect (record->frame == "d;1000;0;1;"sv);
+                    
+                    for (std::int32_t tick = 0; tick < 2; ++tick) {
+                        record = reader->next();
+                        expect ((record.has_value() && record->type == serial::TraceRecordType::STATE) >> fatal);
+                        expect (record->tick == static_cast<std::uint32_t>(tick));
+                        expect (record->state == movingState(tick));
+                    }
+                    
+                    record = reader->next();
+                    expect ((record.has_value() && record->type == serial::TraceRecordType::BINARY_FRAME) >> fatal);
+                    expect (record->tick == 2_u);
+                    expect (record->chOrder == 'A');
+                    expect (record->frame == "\x01\x00\x00\x00"sv);
+                    
+                    record = reader->next();
+                    expect ((record.has_value() && record->state == movingState(2)) >> fatal);
+                    expect (!reader->next());
+                    expect (!reader->corrupted());
+                };
+            };
+            
+            given ("States of a robot moving smoothly") = [] {
+                serial::TraceRecorder<256, 8> recorder;
+                for (std::int32_t tick = 0; tick < 100; ++tick) {
+                    recorder.recordState(movingState(tick));
+                }
+                
+                then ("Each one should only take a few bytes") = [&] {
+                    // Type, tick delta and one byte per field, instead of 28 bytes for the raw state
+                    expect (recorder.exportSize() <= serial::TRACE_HEADER_SIZE + 4 * 256) << recorder.exportSize();
+                };
+            };
+        };
+        
+        scenario ("Ring buffer") = [] {
+            given ("More states than the buffer can hold") = [] {
+                serial::TraceRecorder<128, 4> recorder;
+                for (std::int32_t tick = 0; tick < 1000; ++tick) {
+                    recorder.recordState(movingState(tick));
+                }
+                
+                const auto trace = exportTrace(recorder);
+                auto reader = serial::TraceReader::open({ trace.data(), trace.size() });
+                
+                then ("Only the last ones should be kept, still decoded exactly") = [&] {
+                    expect ((reader.has_value()) >> fatal);
+                    expect (trace.size() == serial::TRACE_HEADER_SIZE + 4 * 128);
+                    
+                    std::uint32_t expectedTick = 0;
+                    std::size_t count = 0;
+                    while (auto record = reader->next()) {
+                        if (count == 0) {
+                            expectedTick = record->tick;
+                        }
+                        expect (record->tick == expectedTick);
+                        expect (record->state == movingState(static_cast<std::int32_t>(expectedTick)));
+                        ++expectedTick;
+                        ++count;
+                    }
+                    expect (expectedTick == 1000_u);
+                    expect (count > 20_ul);
+                    expect (!reader->corrupted());
+                };
+            };
+            
+            given ("A frame bigger than a block") = [] {
+                serial::TraceRecorder<64, 4> recorder;
+                recorder.recordFrame(std::string_view{ "d;1000000000;1000000000;1;1000000000;1000000000;1000000000;1000000000;" });
+                
+                then ("It should be dropped") = [&] {
+                    expect (recorder.droppedRecords() == 1_ul);
+                    expect (recorder.exportSize() == serial::TRACE_HEADER_SIZE);
+                };
+            };
+            
+            given ("Frames of the largest size a block holds") = [] {
+                using Recorder = serial::TraceRecorder<64, 4>;
+                Recorder recorder;
+                const std::string_view frames = "d;1000000000;1000000000;1;1000000000;1000000000;1000000000;1000000000;";
+                
+                then ("Only the bigger ones should be dropped") = [&] {
+                    recorder.recordFrame(frames.substr(0, Recorder::MAX_FRAME_SIZE));
+                    expect (recorder.droppedRecords() == 0_ul);
+                    recorder.recordFrame(frames.substr(0, Recorder::MAX_FRAME_SIZE + 1));
+                    expect (recorder.droppedRecords() == 1_ul);
+                };
+            };
+        };
+        
+        scenario ("Corrupted traces") = [] {
+            given ("A trace without its header") = [] {
+                then ("It shouldn't be opened") = [] {
+                    expect (!serial::TraceReader::open("not a trace"sv));
+                };
+            };
+            
+            given ("A trace whose records are truncated") = [] {
+                serial::TraceRecorder<64, 4> recorder;
+                recorder.recordState({ 1 << 28, 0, 0, 0, 0, 0, 0 });
+                auto trace = exportTrace(recorder);
+                // Cut the varint of x by setting its continuation bit on the following bytes
+                for (std::size_t i = serial::TRACE_HEADER_SIZE + 6; i < trace.size(); ++i) {
+                    trace[i] = static_cast<char>(0x80);
+                }
+                auto reader = serial::TraceReader::open({ trace.data(), trace.size() });
+                
+                then ("The reader should stop and report it") = [&] {
+                    expect ((reader.has_value()) >> fatal);
+                    expect (!reader->next());
+                    expect (reader->corrupted());
+                };
+            };
+        };
+    };
+};
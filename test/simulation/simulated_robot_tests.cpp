@@ -0,0 +1,219 @@
+#include <boost/ut.hpp>
+
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/simulation/simulated_robot.hpp"
+#include "utcoupe/asserv/tasks_dispatcher_like.concept.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <numbers>
+#include <string_view>
+#include <tuple>
+#include <variant>
+
+using namespace std::string_view_literals;
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+static_assert(TasksDispatcherLike<simulation::SimulatedRobot>);
+
+namespace {
+    constexpr auto allOrders = serial::makeOrderTable(serial::createAllOrders<simulation::SimulatedRobot>());
+    
+    /** A short match: a loop around the table with each kind of goal. */
+    constexpr std::array matchOrders{
+        "m;300;300;0;"sv, "d;1200;300;1;"sv, "d;1200;1200;1;"sv, "c;300;1200;3.14159;1;"sv,
+        "a;-1.5708;"sv, "d;300;300;-1;"sv, "e;0;"sv,
+    };
+    
+    float distanceTo(const control::Pose& pose, float x, float y) {
+        return std::hypot(pose.x - x, pose.y - y);
+    }
+}
+
+suite simulatedRobot = [] {
+    tag ("simulation") /
+    feature ("simulation::SimulatedRobot") = [] {
+        scenario ("Orders from the protocol") = [] {
+            given ("A goto sent through the order parser") = [] {
+                simulation::SimulatedRobot robot;
+                serial::OrderParser parser{robot};
+                
+                auto id = parser.parseAndRunOrder(allOrders, "d;1000;0;1;"sv);
+                const bool reached = robot.runUntilIdle(10.f);
+                
+                then ("It should be acknowledged with its identifier") = [&] {
+                    expect (id.has_value() >> fatal);
+                    expect (std::get<std::int32_t>(*id) == 0_i);
+                };
+                
+                then ("The robot should stop on the target") = [&] {
+                    expect (reached);
+                    expect (distanceTo(robot.pose(), 1000.f, 0.f) < 3.0_f) << robot.pose().x << robot.pose().y;
+                    expect (std::abs(robot.pose().theta) < 0.02_f);
+                    expect (std::get<std::int32_t>(*parser.parseAndRunOrder(allOrders, "t;"sv)) == 0_i);
+                };
+                
+                then ("The odometry should follow the actual robot") = [&] {
+                    expect (distanceTo(robot.pose(), robot.truePose().x, robot.truePose().y) < 1.0_f);
+                };
+            };
+            
+            given ("A goto behind the robot") = [] {
+                simulation::SimulatedRobot robot;
+                serial::OrderParser parser{robot};
+                
+                parser.parseAndRunOrder(allOrders, "d;0;500;1;"sv);
+                const bool reached = robot.runUntilIdle(10.f);
+                
+                then ("The robot should turn towards it first") = [&] {
+                    expect (reached);
+                    expect (distanceTo(robot.pose(), 0.f, 500.f) < 3.0_f);
+                    expect (std::abs(robot.pose().theta - std::numbers::pi_v<float> / 2.f) < 0.05_f);
+                };
+            };
+            
+            given ("A goto with an angle") = [] {
+                simulation::SimulatedRobot robot;
+                serial::OrderParser parser{robot};
+                
+                parser.parseAndRunOrder(allOrders, "c;500;500;-1.5;1;"sv);
+                const bool reached = robot.runUntilIdle(10.f);
+                
+                then ("The robot should end with the requested orientation") = [&] {
+                    expect (reached);
+                    expect (distanceTo(robot.pose(), 500.f, 500.f) < 3.0_f);
+                    expect (std::abs(robot.pose().theta + 1.5f) < 0.02_f);
+                };
+            };
+            
+            given ("A rotation beyond a half turn") = [] {
+                simulation::SimulatedRobot robot;
+                serial::OrderParser parser{robot};
+                
+                parser.parseAndRunOrder(allOrders, "e;4;"sv);
+                const bool reached = robot.runUntilIdle(10.f);
+                
+                then ("The robot should turn by the whole angle, without moving") = [&] {
+                    expect (reached);
+                    expect (std::abs(robot.pose().theta - (4.f - 2.f * std::numbers::pi_v<float>)) < 0.02_f);
+                    expect (distanceTo(robot.pose(), 0.f, 0.f) < 1.0_f);
+                };
+            };
+            
+            given ("Position and speed queries") = [] {
+                simulation::SimulatedRobot robot;
+                serial::OrderParser parser{robot};
+                
+                parser.parseAndRunOrder(allOrders, "m;100;200;1.5708;"sv);
+                parser.parseAndRunOrder(allOrders, "b;200;0;1000;"sv);
+                robot.run(0.5f);
+                
+                then ("They should report the state of the simulation") = [&] {
+                    auto [x, y, angle, id] = std::get<std::tuple<std::int32_t, std::int32_t, float, std::int32_t>>(*parser.parseAndRunOrder(allOrders, "o;"sv));
+                    expect (x == 100_i);
+                    expect (y > 250_i);
+                    expect (std::abs(angle - 1.5708f) < 0.01_f);
+                    auto [left, right] = std::get<std::tuple<std::int32_t, std::int32_t>>(*parser.parseAndRunOrder(allOrders, "y;"sv));
+                    // A single encoder tick per period already amounts to 20 mm/s
+                    expect (std::abs(left - 200) <= 20_i);
+                    expect (std::abs(right - 200) <= 20_i);
+                    expect (std::get<std::int32_t>(*parser.parseAndRunOrder(allOrders, "w;"sv)) == simulation::SimulatedRobot::WHO_AM_I);
+                };
+                
+                then ("The speed order should stop after its duration") = [&] {
+                    robot.run(1.f);
+                    expect (robot.isIdle());
+                    auto [left, right] = std::get<std::tuple<std::int32_t, std::int32_t>>(*parser.parseAndRunOrder(allOrders, "y;"sv));
+                    expect (left == 0_i);
+                    expect (right == 0_i);
+                };
+            };
+            
+            given ("An emergency stop during a goto") = [] {
+                simulation::SimulatedRobot robot;
+                serial::OrderParser parser{robot};
+                
+                parser.parseAndRunOrder(allOrders, "d;2000;0;1;"sv);
+                robot.run(1.f);
+                parser.parseAndRunOrder(allOrders, "A;1;"sv);
+                robot.run(1.f);
+                const float stoppedX = robot.pose().x;
+                robot.run(1.f);
+                
+                then ("The robot should stop until it is released") = [&] {
+                    expect (robot.pwm()[0] == 0.0_f);
+                    expect (robot.pose().x == stoppedX);
+                    expect (!robot.isIdle());
+                    
+                    parser.parseAndRunOrder(allOrders, "A;0;"sv);
+                    expect (robot.runUntilIdle(10.f));
+                    expect (distanceTo(robot.pose(), 2000.f, 0.f) < 3.0_f);
+                };
+            };
+        };
+        
+        scenario ("Matches") = [] {
+            given ("A 100 s match") = [] {
+                simulation::SimulatedRobot robot;
+                serial::OrderParser parser{robot};
+                
+                const auto start = std::chrono::steady_clock::now();
+                int completedLoops = 0;
+                while (robot.time() < 100.) {
+                    for (auto order : matchOrders) {
+                        parser.parseAndRunOrder(allOrders, order);
+                    }
+                    if (robot.runUntilIdle(static_cast<float>(100. - robot.time()))) {
+                        ++completedLoops;
+                    }
+                }
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                
+                then ("It should run well under a second") = [&] {
+                    expect (elapsed.count() < 1.) << elapsed.count();
+                    expect (completedLoops > 2_i);
+                };
+            };
+            
+            given ("The same orders run twice") = [] {
+                auto runMatch = [] {
+                    simulation::SimulatedRobot robot;
+                    serial::OrderParser parser{robot};
+                    for (auto order : matchOrders) {
+                        parser.parseAndRunOrder(allOrders, order);
+                    }
+                    robot.run(20.f);
+                    return robot.pose();
+                };
+                const control::Pose first = runMatch();
+                const control::Pose second = runMatch();
+                
+                then ("The simulation should be deterministic") = [&] {
+                    expect (first.x == second.x);
+                    expect (first.y == second.y);
+                    expect (first.theta == second.theta);
+                };
+            };
+            
+            given ("A sweep over the wheel gains") = [] {
+                constexpr std::array proportionalGains{ 0.1f, 0.3f, 1.f };
+                
+                then ("Each configuration should complete the loop") = [&] (float p) {
+                    simulation::SimulationConfig config;
+                    config.wheelGains.p = p;
+                    simulation::SimulatedRobot robot{ config };
+                    serial::OrderParser parser{robot};
+                    for (auto order : matchOrders) {
+                        parser.parseAndRunOrder(allOrders, order);
+                    }
+                    expect (robot.runUntilIdle(60.f)) << p;
+                    expect (distanceTo(robot.pose(), 300.f, 300.f) < 3.0_f) << p;
+                } | proportionalGains;
+            };
+        };
+    };
+};
@@ -0,0 +1,126 @@
+#include <boost/ut.hpp>
+
+#include "utcoupe/asserv/serial/order_batch.hpp"
+#include "utcoupe/asserv/serial/order_parser.hpp"
+#include "utcoupe/asserv/serial/order_table.hpp"
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/serial/trace_recorder.hpp"
+#include "utcoupe/asserv/simulation/simulated_robot.hpp"
+#include "utcoupe/asserv/simulation/trace_replay.hpp"
+
+#include <array>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace std::string_view_literals;
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+namespace {
+    constexpr auto allOrders = serial::makeOrderTable(serial::createAllOrders<simulation::SimulatedRobot>());
+    
+    /** Runs orders at the given ticks on a simulated robot, recording the match like the robot does. */
+    template<std::size_t BlockCount>
+    std::vector<char> recordMatch(std::span<const std::pair<std::uint32_t, std::string_view>> orders, std::uint32_t ticks) {
+        simulation::SimulatedRobot robot;
+        serial::OrderParser parser{ robot };
+        serial::OrderBatch batch{ allOrders };
+        serial::TraceRecorder<256, BlockCount> recorder;
+        auto order = orders.begin();
+        
+        for (std::uint32_t tick = 0; tick < ticks; ++tick) {
+            for (; order != orders.end() && order->first == tick; ++order) {
+                recorder.recordFrame(order->second);
+                if (serial::isBatchFrame(order->second)) {
+                    if (batch.decode(order->second)) {
+                        batch.run(parser);
+                    }
+                } else {
+                    parser.parseAndRunOrder(allOrders, order->second);
+                }
+            }
+            robot.step();
+            recorder.recordState(simulation::traceState(robot));
+        }
+        
+        std::vector<char> trace(recorder.exportSize());
+        recorder.exportTo(trace);
+        return trace;
+    }
+    
+    /** Orders and the tick they are received at. Constant, as suites are run after the destruction of dynamically initialized globals. */
+    constexpr std::array<std::pair<std::uint32_t, std::string_view>, 6> matchOrders{ {
+        { 0, "m;300;300;0;"sv }, { 0, "d;1200;300;1;"sv }, { 100, "d;1200;1200;1;"sv }, { 1200, "c;300;1200;3.14;1;"sv }, { 2500, "e;0;"sv },
+        { 4800, "d;800;800;1;"sv },
+    } };
+    
+    /** The same path as matchOrders, uploaded as a single batch frame. */
+    constexpr std::array<std::pair<std::uint32_t, std::string_view>, 2> batchOrders{ {
+        { 0, "m;300;300;0;"sv }, { 0, "B;d;1200;300;1;|d;1200;1200;1;|c;300;1200;3.14;1;"sv },
+    } };
+}
+
+suite traceReplay = [] {
+    tag ("simulation") / tag ("trace") /
+    feature ("simulation::replayTrace") = [] {
+        scenario ("Replay") = [] {
+            given ("A trace recorded from the simulation") = [] {
+                const auto trace = recordMatch<256>(matchOrders, 3000);
+                const auto report = simulation::replayTrace({ trace.data(), trace.size() });
+                
+                then ("The replay should match it exactly") = [&] {
+                    expect (!report.diverged());
+                    expect (report.framesRun == 5_u);
+                    expect (report.framesRejected == 0_u);
+                    expect (report.statesCompared == 3000_u);
+                    // Only the quantization of the recorded states remains
+                    expect (report.maxPositionError < 0.1_f);
+                };
+            };
+            
+            given ("A trace whose beginning has been overwritten by the ring buffer") = [] {
+                // The robot is at rest when the trace starts, before its last goal
+                const auto trace = recordMatch<16>(matchOrders, 5000);
+                const auto report = simulation::replayTrace({ trace.data(), trace.size() });
+                
+                then ("The replay should start from the first recorded state") = [&] {
+                    expect (!report.diverged());
+                    expect (report.statesCompared < 1000_u);
+                    expect (report.framesRun == 1_u);
+                };
+            };
+            
+            given ("A trace holding a batch frame") = [] {
+                const auto trace = recordMatch<256>(batchOrders, 3000);
+                const auto report = simulation::replayTrace({ trace.data(), trace.size() });
+                
+                then ("The batch should be run as a whole") = [&] {
+                    expect (!report.diverged());
+                    expect (report.framesRun == 2_u);
+                    expect (report.framesRejected == 0_u);
+                    expect (report.maxPositionError < 0.1_f);
+                };
+            };
+            
+            given ("A trace recorded with another behaviour") = [] {
+                const auto trace = recordMatch<256>(matchOrders, 3000);
+                // Simulates a firmware whose first goal is another one than the received order
+                simulation::SimulationConfig slowerRobot;
+                slowerRobot.limits.maxSpeed = 250.f;
+                const auto report = simulation::replayTrace({ trace.data(), trace.size() }, slowerRobot);
+                
+                then ("The divergence should be reported with its tick") = [&] {
+                    expect (report.valid);
+                    expect (report.diverged());
+                    expect ((report.firstDivergence.has_value()) >> fatal);
+                    expect (*report.firstDivergence > 0_u);
+                    expect (*report.firstDivergence < 500_u);
+                    expect (report.maxPositionError > 5.0_f);
+                };
+            };
+        };
+    };
+};
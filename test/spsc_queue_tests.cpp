@@ -0,0 +1,80 @@
+#include <boost/ut.hpp>
+
+#include "utcoupe/asserv/spsc_queue.hpp"
+
+#include <thread>
+
+using namespace boost::ut;
+using namespace boost::ut::bdd;
+using namespace utcoupe::asserv;
+
+suite spscQueue = [] {
+    tag ("serial") / tag ("spsc-queue") /
+    feature ("SpscQueue") = [] {
+        scenario ("Bounded FIFO") = [] {
+            given ("A queue of 4 items") = [] {
+                SpscQueue<int, 4> queue;
+                
+                then ("Items should be popped in their push order") = [&] {
+                    expect (queue.push(1));
+                    expect (queue.push(2));
+                    expect (*queue.pop() == 1_i);
+                    expect (queue.push(3));
+                    expect (*queue.pop() == 2_i);
+                    expect (*queue.pop() == 3_i);
+                    expect (!queue.pop());
+                };
+                
+                then ("The first item should be readable without popping it") = [&] {
+                    expect (queue.front() == nullptr);
+                    expect (queue.push(5));
+                    const int* front = queue.front();
+                    expect ((front != nullptr) >> fatal);
+                    expect (*front == 5_i);
+                    expect (queue.size() == 1_ul);
+                    expect (*queue.pop() == 5_i);
+                };
+                
+                then ("Pushing into a full queue should fail") = [&] {
+                    for (int i = 0; i < 4; ++i) {
+                        expect (queue.push(i));
+                    }
+                    expect (!queue.push(4));
+                    expect (queue.size() == 4_ul);
+                };
+            };
+        };
+        
+        scenario ("Concurrent access") = [] {
+            given ("A producer and a consumer on separate threads") = [] {
+                SpscQueue<int, 8> queue;
+                constexpr int itemsCount = 100'000;
+                
+                then ("Every item should be received once, in order") = [&] {
+                    std::thread producer{ [&queue] {
+                        for (int i = 0; i < itemsCount; ) {
+                            if (queue.push(i)) {
+                                ++i;
+                            } else {
+                                std::this_thread::yield();
+                            }
+                        }
+                    } };
+                    
+                    bool ordered = true;
+                    for (int expected = 0; expected < itemsCount; ) {
+                        if (auto item = queue.pop()) {
+                            ordered = ordered && *item == expected;
+                            ++expected;
+                        } else {
+                            std::this_thread::yield();
+                        }
+                    }
+                    producer.join();
+                    expect (ordered);
+                    expect (queue.empty());
+                };
+            };
+        };
+    };
+};
@@ -1,10 +1,10 @@
 #include <boost/ut.hpp>
 
 int main () {
-
+    
     using namespace boost::ut;
-        
-    cfg<override> = {.tag = { "serial" }}; // CppCheck false positive, value is indeed used!
+    
+    cfg<override> = {.tag = { "serial", "control", "simulation" }}; // CppCheck false positive, value is indeed used!
     
     return 0;
 }
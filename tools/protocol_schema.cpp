@@ -0,0 +1,35 @@
+#include "utcoupe/asserv/serial/protocol.hpp"
+#include "utcoupe/asserv/serial/protocol_schema.hpp"
+#include "utcoupe/asserv/simulation/simulated_robot.hpp"
+
+#include <cstdio>
+#include <string_view>
+
+namespace {
+    using namespace utcoupe::asserv;
+    
+    constexpr auto allOrders = serial::makeOrderTable(serial::createAllOrders<simulation::SimulatedRobot>());
+    constexpr auto schema = serial::makeProtocolSchema(allOrders);
+} // namespace
+
+/**
+ * Writes the JSON schema of the protocol, for the host tools to generate their clients from.
+ * 
+ * The schema is written to the given file, or to the standard output. Exits with 0 on success and 1 on writing errors.
+ */
+int main(int argc, char** argv) {
+    std::FILE* file = argc > 1 ? std::fopen(argv[1], "w") : stdout;
+    if (file == nullptr) {
+        std::fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+    
+    bool written = true;
+    serial::writeSchemaJson(schema, [file, &written](std::string_view part) {
+        written = written && std::fwrite(part.data(), 1, part.size(), file) == part.size();
+    });
+    if (file != stdout) {
+        written = std::fclose(file) == 0 && written;
+    }
+    return written ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+#include "utcoupe/asserv/serial/parse_decimal.hpp"
+#include "utcoupe/asserv/simulation/trace_replay.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+namespace {
+    using namespace utcoupe::asserv;
+    
+    void printUsage(const char* program) {
+        std::fprintf(stderr, "usage: %s <trace file> [--position-tolerance=<mm>] [--angle-tolerance=<rad>]\n", program);
+    }
+    
+    bool parseOption(std::string_view arg, std::string_view name, float& value) {
+        if (!arg.starts_with(name)) {
+            return false;
+        }
+        arg.remove_prefix(name.size());
+        return serial::impl::from_chars_fp(arg.data(), arg.data() + arg.size(), value) == arg.data() + arg.size();
+    }
+} // namespace
+
+/**
+ * Replays a trace dumped from the robot through the simulation, and reports whether the simulation diverges from it.
+ * 
+ * Exits with 0 if the replay matches the trace, 2 if it diverges and 1 on usage or reading errors.
+ */
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    simulation::ReplayTolerance tolerance;
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (!parseOption(arg, "--position-tolerance=", tolerance.position) && !parseOption(arg, "--angle-tolerance=", tolerance.angle)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    
+    std::FILE* file = std::fopen(argv[1], "rb");
+    if (file == nullptr) {
+        std::fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+    std::string trace;
+    std::array<char, 4096> chunk;
+    for (std::size_t size; (size = std::fread(chunk.data(), 1, chunk.size(), file)) > 0;) {
+        trace.append(chunk.data(), size);
+    }
+    std::fclose(file);
+    
+    const auto report = simulation::replayTrace(trace, {}, tolerance);
+    if (!report.valid && report.statesCompared == 0) {
+        std::fprintf(stderr, "%s is not a valid trace\n", argv[1]);
+        return 1;
+    }
+    
+    std::printf("frames run:          %u\n", report.framesRun);
+    std::printf("frames rejected:     %u\n", report.framesRejected);
+    std::printf("states compared:     %u\n", report.statesCompared);
+    std::printf("max position error:  %.2f mm\n", static_cast<double>(report.maxPositionError));
+    std::printf("max angle error:     %.4f rad\n", static_cast<double>(report.maxAngleError));
+    if (!report.valid) {
+        std::printf("trace corrupted, replay stopped early\n");
+    }
+    if (report.firstDivergence) {
+        std::printf("diverged at tick:    %u\n", *report.firstDivergence);
+    }
+    return report.diverged() ? 2 : 0;
+}